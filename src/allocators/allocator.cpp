@@ -41,6 +41,8 @@
 #include "selalloc.hpp"
 #include "separable_input_first.hpp"
 #include "separable_output_first.hpp"
+#include "bit_separable_input_first.hpp"
+#include "bit_separable_output_first.hpp"
 //
 /////////////////////////////////////////////////////////////////////////
 
@@ -123,15 +125,32 @@ DenseAllocator::DenseAllocator( Module *parent, const string& name,
       _request[i][j].label = -1;
     }
   }
+
+  _row_words = ( _outputs + 63 ) / 64;
+  _request_bits.resize(_inputs * _row_words, 0ULL);
+  _in_count.resize(_inputs, 0);
+  _out_count.resize(_outputs, 0);
+  _row_dirty.resize(_inputs, false);
 }
 
 void DenseAllocator::Clear( )
 {
-  for ( int i = 0; i < _inputs; ++i ) {
-    for ( int j = 0; j < _outputs; ++j ) {
-      _request[i][j].label = -1;
+  // only rows that received requests since the last call can hold labels
+  for ( size_t r = 0; r < _dirty_rows.size( ); ++r ) {
+    int const i = _dirty_rows[r];
+    for ( int w = 0; w < _row_words; ++w ) {
+      unsigned long long & bits = _request_bits[i*_row_words + w];
+      while ( bits ) {
+	int const j = w * 64 + __builtin_ctzll( bits );
+	bits &= bits - 1;
+	_request[i][j].label = -1;
+	--_out_count[j];
+      }
     }
+    _in_count[i] = 0;
+    _row_dirty[i] = false;
   }
+  _dirty_rows.clear( );
   Allocator::Clear();
 }
 
@@ -162,6 +181,14 @@ void DenseAllocator::AddRequest( int in, int out, int label,
   _request[in][out].label   = label;
   _request[in][out].in_pri  = in_pri;
   _request[in][out].out_pri = out_pri;
+
+  _request_bits[in*_row_words + out/64] |= 1ULL << ( out % 64 );
+  ++_in_count[in];
+  ++_out_count[out];
+  if ( !_row_dirty[in] ) {
+    _row_dirty[in] = true;
+    _dirty_rows.push_back(in);
+  }
 }
 
 void DenseAllocator::RemoveRequest( int in, int out, int label )
@@ -169,49 +196,32 @@ void DenseAllocator::RemoveRequest( int in, int out, int label )
   assert( ( in >= 0 ) && ( in < _inputs ) );
   assert( ( out >= 0 ) && ( out < _outputs ) ); 
   
+  if ( _request[in][out].label >= 0 ) {
+    _request_bits[in*_row_words + out/64] &= ~( 1ULL << ( out % 64 ) );
+    --_in_count[in];
+    --_out_count[out];
+  }
   _request[in][out].label = -1;
 }
 
 bool DenseAllocator::InputHasRequests( int in ) const
 {
-  for(int out = 0; out < _outputs; ++out) {
-    if(_request[in][out].label >= 0) {
-      return true;
-    }
-  }
-  return false;
+  return ( _in_count[in] > 0 );
 }
 
 bool DenseAllocator::OutputHasRequests( int out ) const
 {
-  for(int in = 0; in < _inputs; ++in) {
-    if(_request[in][out].label >= 0) {
-      return true;
-    }
-  }
-  return false;
+  return ( _out_count[out] > 0 );
 }
 
 int DenseAllocator::NumInputRequests( int in ) const
 {
-  int result = 0;
-  for(int out = 0; out < _outputs; ++out) {
-    if(_request[in][out].label >= 0) {
-      ++result;
-    }
-  }
-  return result;
+  return _in_count[in];
 }
 
 int DenseAllocator::NumOutputRequests( int out ) const
 {
-  int result = 0;
-  for(int in = 0; in < _inputs; ++in) {
-    if(_request[in][out].label >= 0) {
-      ++result;
-    }
-  }
-  return result;
+  return _out_count[out];
 }
 
 void DenseAllocator::PrintRequests( ostream * os ) const
@@ -469,6 +479,14 @@ Allocator *Allocator::NewAllocator( Module *parent, const string& name,
     string arb_type = param_str.empty() ? (config ? config->GetStr("arb_type") : "round_robin") : param_str;
     a = new SeparableOutputFirstAllocator( parent, name, inputs, outputs,
 					   arb_type );
+  } else if (alloc_name == "bit_separable_input_first") {
+    string arb_type = param_str.empty() ? (config ? config->GetStr("arb_type") : "round_robin") : param_str;
+    a = new BitSeparableInputFirstAllocator( parent, name, inputs, outputs,
+					     arb_type );
+  } else if (alloc_name == "bit_separable_output_first") {
+    string arb_type = param_str.empty() ? (config ? config->GetStr("arb_type") : "round_robin") : param_str;
+    a = new BitSeparableOutputFirstAllocator( parent, name, inputs, outputs,
+					      arb_type );
   }
 
 //==================================================
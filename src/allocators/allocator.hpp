@@ -36,6 +36,8 @@
 #include "module.hpp"
 #include "config_utils.hpp"
 
+class Checkpoint;
+
 class Allocator : public Module {
 protected:
   const int _inputs;
@@ -69,6 +71,10 @@ public:
   
   virtual void Allocate( ) = 0;
 
+  // Save or restore the priority state for a checkpoint; requests and 
+  // grants are cleared before every allocation and need not be saved
+  virtual void SyncState( Checkpoint & cp ) {}
+
   int OutputAssigned( int in ) const;
   int InputAssigned( int out ) const;
 
@@ -96,6 +102,15 @@ class DenseAllocator : public Allocator {
 protected:
   vector<vector<sRequest> > _request;
 
+  // request bitmap (one row of _row_words words per input), per-row and
+  // per-column request counts, and the rows touched since the last Clear
+  int _row_words;
+  vector<unsigned long long> _request_bits;
+  vector<int> _in_count;
+  vector<int> _out_count;
+  vector<int> _dirty_rows;
+  vector<bool> _row_dirty;
+
 public:
   DenseAllocator( Module *parent, const string& name,
 		  int inputs, int outputs );
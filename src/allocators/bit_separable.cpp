@@ -0,0 +1,289 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2015, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// ----------------------------------------------------------------------
+//
+//  BitSeparableAllocator: Bit-Parallel Separable Allocator Base Class
+//
+// ----------------------------------------------------------------------
+
+#include "bit_separable.hpp"
+#include "checkpoint.hpp"
+
+#include "booksim.hpp"
+
+#include <algorithm>
+
+// first set bit at or after the pointer, wrapping around
+static int _PickRoundRobin( unsigned long long const * requests, int words,
+			    int pointer )
+{
+  int w = pointer / 64;
+  unsigned long long bits = requests[w] & ( ~0ULL << ( pointer % 64 ) );
+  for ( int n = 0; n <= words; ++n ) {
+    if ( bits ) {
+      return w * 64 + __builtin_ctzll( bits );
+    }
+    w = ( w + 1 ) % words;
+    bits = requests[w];
+  }
+  return -1;
+}
+
+// lowest request that is not beaten by any other request
+static int _PickMatrix( unsigned long long const * requests, int words,
+			unsigned long long const * matrix )
+{
+  for ( int w = 0; w < words; ++w ) {
+    unsigned long long bits = requests[w];
+    while ( bits ) {
+      int const i = w * 64 + __builtin_ctzll( bits );
+      bits &= bits - 1;
+      unsigned long long const * const beaten = &matrix[i * words];
+      bool grant = true;
+      for ( int v = 0; v < words; ++v ) {
+	if ( beaten[v] & requests[v] ) {
+	  grant = false;
+	  break;
+	}
+      }
+      if ( grant ) {
+	return i;
+      }
+    }
+  }
+  return -1;
+}
+
+// initial matrix arbiter state: higher indices beat lower ones
+static void _InitMatrix( vector<unsigned long long> & matrix, int arbs, 
+			 int size, int words )
+{
+  matrix.assign( arbs * size * words, 0ULL );
+  for ( int a = 0; a < arbs; ++a ) {
+    for ( int i = 0; i < size; ++i ) {
+      unsigned long long * const beaten = &matrix[( a * size + i ) * words];
+      for ( int j = i + 1; j < size; ++j ) {
+	beaten[j / 64] |= 1ULL << ( j % 64 );
+      }
+    }
+  }
+}
+
+// selected request loses against every other one from now on
+static void _UpdateMatrix( unsigned long long * matrix, int size, int words,
+			   int selected )
+{
+  unsigned long long const mask = 1ULL << ( selected % 64 );
+  for ( int i = 0; i < size; ++i ) {
+    matrix[i * words + selected / 64] &= ~mask;
+  }
+  unsigned long long * const beaten = &matrix[selected * words];
+  for ( int w = 0; w < words; ++w ) {
+    beaten[w] = ~0ULL;
+  }
+  if ( size % 64 ) {
+    beaten[words - 1] = ( 1ULL << ( size % 64 ) ) - 1;
+  }
+  beaten[selected / 64] &= ~mask;
+}
+
+BitSeparableAllocator::BitSeparableAllocator( Module* parent, 
+					      const string& name,
+					      int inputs, int outputs,
+					      const string& arb_type )
+  : DenseAllocator( parent, name, inputs, outputs ), _num_requests(0),
+    _uniform_in_pri(true), _uniform_out_pri(true)
+{
+  _col_words = ( inputs + 63 ) / 64;
+  _col_bits.resize( outputs * _col_words, 0ULL );
+  _col_dirty.resize( outputs, false );
+
+  if ( arb_type == "round_robin" ) {
+    _matrix = false;
+    _input_ptr.resize( inputs, 0 );
+    _output_ptr.resize( outputs, 0 );
+  } else if ( arb_type == "matrix" ) {
+    _matrix = true;
+    _InitMatrix( _input_matrix, inputs, outputs, _row_words );
+    _InitMatrix( _output_matrix, outputs, inputs, _col_words );
+  } else {
+    Error( "Bit-parallel separable allocator does not support arbiter type " + 
+	   arb_type );
+  }
+
+  _stage_bits.resize( max( inputs * _row_words, outputs * _col_words ), 0ULL );
+  _candidates.resize( max( _row_words, _col_words ), 0ULL );
+}
+
+void BitSeparableAllocator::Clear( )
+{
+  for ( size_t c = 0; c < _dirty_cols.size( ); ++c ) {
+    int const o = _dirty_cols[c];
+    for ( int w = 0; w < _col_words; ++w ) {
+      _col_bits[o * _col_words + w] = 0ULL;
+    }
+    _col_dirty[o] = false;
+  }
+  _dirty_cols.clear( );
+  _num_requests = 0;
+  _uniform_in_pri = true;
+  _uniform_out_pri = true;
+  DenseAllocator::Clear( );
+}
+
+void BitSeparableAllocator::AddRequest( int in, int out, int label, 
+					int in_pri, int out_pri )
+{
+  DenseAllocator::AddRequest( in, out, label, in_pri, out_pri );
+
+  _col_bits[out * _col_words + in / 64] |= 1ULL << ( in % 64 );
+  if ( !_col_dirty[out] ) {
+    _col_dirty[out] = true;
+    _dirty_cols.push_back( out );
+  }
+
+  if ( _num_requests++ == 0 ) {
+    _first_in_pri = in_pri;
+    _first_out_pri = out_pri;
+  } else {
+    _uniform_in_pri = _uniform_in_pri && ( in_pri == _first_in_pri );
+    _uniform_out_pri = _uniform_out_pri && ( out_pri == _first_out_pri );
+  }
+}
+
+void BitSeparableAllocator::RemoveRequest( int in, int out, int label )
+{
+  DenseAllocator::RemoveRequest( in, out, label );
+  _col_bits[out * _col_words + in / 64] &= ~( 1ULL << ( in % 64 ) );
+}
+
+int BitSeparableAllocator::_ArbitrateInput( int input, tMask const * requests )
+{
+  // restrict to the highest-priority requests
+  if ( !_uniform_in_pri ) {
+    int max_pri = 0;
+    bool first = true;
+    for ( int w = 0; w < _row_words; ++w ) {
+      tMask bits = requests[w];
+      while ( bits ) {
+	int const o = w * 64 + __builtin_ctzll( bits );
+	bits &= bits - 1;
+	int const pri = _request[input][o].in_pri;
+	if ( first || ( pri > max_pri ) ) {
+	  max_pri = pri;
+	  first = false;
+	}
+      }
+    }
+    for ( int w = 0; w < _row_words; ++w ) {
+      tMask bits = requests[w];
+      _candidates[w] = 0ULL;
+      while ( bits ) {
+	int const b = __builtin_ctzll( bits );
+	bits &= bits - 1;
+	if ( _request[input][w * 64 + b].in_pri == max_pri ) {
+	  _candidates[w] |= 1ULL << b;
+	}
+      }
+    }
+    requests = &_candidates[0];
+  }
+
+  if ( _matrix ) {
+    return _PickMatrix( requests, _row_words, 
+			&_input_matrix[input * _outputs * _row_words] );
+  }
+  return _PickRoundRobin( requests, _row_words, _input_ptr[input] );
+}
+
+int BitSeparableAllocator::_ArbitrateOutput( int output, tMask const * requests )
+{
+  if ( !_uniform_out_pri ) {
+    int max_pri = 0;
+    bool first = true;
+    for ( int w = 0; w < _col_words; ++w ) {
+      tMask bits = requests[w];
+      while ( bits ) {
+	int const i = w * 64 + __builtin_ctzll( bits );
+	bits &= bits - 1;
+	int const pri = _request[i][output].out_pri;
+	if ( first || ( pri > max_pri ) ) {
+	  max_pri = pri;
+	  first = false;
+	}
+      }
+    }
+    for ( int w = 0; w < _col_words; ++w ) {
+      tMask bits = requests[w];
+      _candidates[w] = 0ULL;
+      while ( bits ) {
+	int const b = __builtin_ctzll( bits );
+	bits &= bits - 1;
+	if ( _request[w * 64 + b][output].out_pri == max_pri ) {
+	  _candidates[w] |= 1ULL << b;
+	}
+      }
+    }
+    requests = &_candidates[0];
+  }
+
+  if ( _matrix ) {
+    return _PickMatrix( requests, _col_words, 
+			&_output_matrix[output * _inputs * _col_words] );
+  }
+  return _PickRoundRobin( requests, _col_words, _output_ptr[output] );
+}
+
+void BitSeparableAllocator::_UpdateInput( int input, int output )
+{
+  if ( _matrix ) {
+    _UpdateMatrix( &_input_matrix[input * _outputs * _row_words], 
+		   _outputs, _row_words, output );
+  } else {
+    _input_ptr[input] = ( output + 1 ) % _outputs;
+  }
+}
+
+void BitSeparableAllocator::_UpdateOutput( int output, int input )
+{
+  if ( _matrix ) {
+    _UpdateMatrix( &_output_matrix[output * _inputs * _col_words], 
+		   _inputs, _col_words, input );
+  } else {
+    _output_ptr[output] = ( input + 1 ) % _inputs;
+  }
+}
+
+void BitSeparableAllocator::SyncState( Checkpoint & cp )
+{
+  cp.Check( _matrix ? "matrix" : "round_robin", "arbiter type" );
+  cp.Sync( _input_ptr );
+  cp.Sync( _output_ptr );
+  cp.Sync( _input_matrix );
+  cp.Sync( _output_matrix );
+}
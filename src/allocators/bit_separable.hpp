@@ -0,0 +1,105 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2015, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// ----------------------------------------------------------------------
+//
+//  BitSeparableAllocator: Bit-Parallel Separable Allocator Base Class
+//
+//  Produces the same grants as SeparableAllocator with round-robin or
+//  matrix arbiters, but keeps requests and arbiter state as 64-bit word
+//  masks: round-robin picks are a masked find-first-set from the
+//  priority pointer, and matrix arbitration tests each candidate's
+//  "beaten by" row against the request mask.
+//
+// ----------------------------------------------------------------------
+
+#ifndef _BIT_SEPARABLE_HPP_
+#define _BIT_SEPARABLE_HPP_
+
+#include <vector>
+
+#include "allocator.hpp"
+
+class BitSeparableAllocator : public DenseAllocator {
+  
+protected:
+
+  typedef unsigned long long tMask;
+
+  bool _matrix;
+
+  // request bitmap by column (one row of _col_words words per output)
+  int _col_words;
+  vector<tMask> _col_bits;
+
+  // outputs that received requests since the last Clear
+  vector<int> _dirty_cols;
+  vector<bool> _col_dirty;
+
+  // set while all requests since the last Clear share their priorities
+  int _num_requests;
+  int _first_in_pri;
+  int _first_out_pri;
+  bool _uniform_in_pri;
+  bool _uniform_out_pri;
+
+  // round-robin priority pointers
+  vector<int> _input_ptr;
+  vector<int> _output_ptr;
+
+  // matrix arbiters: bit j of row i is set if request j beats request i
+  vector<tMask> _input_matrix;
+  vector<tMask> _output_matrix;
+
+  // requests forwarded from the first to the second arbitration stage
+  vector<tMask> _stage_bits;
+  vector<int> _stage_ports;
+
+  vector<tMask> _candidates;
+
+  int _ArbitrateInput( int input, tMask const * requests );
+  int _ArbitrateOutput( int output, tMask const * requests );
+
+  void _UpdateInput( int input, int output );
+  void _UpdateOutput( int output, int input );
+
+public:
+  
+  BitSeparableAllocator( Module* parent, const string& name, int inputs,
+			 int outputs, const string& arb_type ) ;
+
+  virtual void Clear() ;
+
+  virtual void SyncState( Checkpoint & cp );
+
+  void AddRequest( int in, int out, int label = 1, 
+		   int in_pri = 0, int out_pri = 0 );
+  void RemoveRequest( int in, int out, int label = 1 );
+
+} ;
+
+#endif
@@ -0,0 +1,100 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2015, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// ----------------------------------------------------------------------
+//
+//  BitSeparableOutputFirstAllocator: Bit-Parallel Separable Output-First 
+//  Allocator
+//
+// ----------------------------------------------------------------------
+
+#include "bit_separable_output_first.hpp"
+#include "checkpoint.hpp"
+
+#include "booksim.hpp"
+
+BitSeparableOutputFirstAllocator::
+BitSeparableOutputFirstAllocator( Module* parent, const string& name, int inputs,
+				  int outputs, const string& arb_type )
+  : BitSeparableAllocator( parent, name, inputs, outputs, arb_type )
+{}
+
+void BitSeparableOutputFirstAllocator::Allocate() {
+
+  // Execute the output arbiters and propagate the grants to the
+  // input arbiters.
+
+  for(size_t c = 0; c < _dirty_cols.size(); ++c) {
+
+    const int output = _dirty_cols[c];
+    if(_out_count[output] == 0) {
+      continue;
+    }
+
+    const int input = 
+      _ArbitrateOutput(output, &_col_bits[output * _col_words]);
+    assert(input > -1);
+
+    tMask * const stage = &_stage_bits[input * _row_words];
+    bool first = true;
+    for(int w = 0; w < _row_words; ++w) {
+      first = first && !stage[w];
+    }
+    if(first) {
+      _stage_ports.push_back(input);
+    }
+    stage[output / 64] |= 1ULL << (output % 64);
+  }
+
+  // Execute the input arbiters.
+
+  for(size_t p = 0; p < _stage_ports.size(); ++p) {
+
+    const int input = _stage_ports[p];
+    tMask * const stage = &_stage_bits[input * _row_words];
+
+    const int output = _ArbitrateInput(input, stage);
+    assert(output > -1);
+    assert((_inmatch[input] == -1) && (_outmatch[output] == -1));
+
+    _inmatch[input] = output;
+    _outmatch[output] = input;
+    _UpdateInput(input, output);
+    _UpdateOutput(output, input);
+
+    for(int w = 0; w < _row_words; ++w) {
+      stage[w] = 0ULL;
+    }
+  }
+  _stage_ports.clear();
+}
+
+void BitSeparableOutputFirstAllocator::SyncState( Checkpoint & cp )
+{
+  cp.Check( "bit_separable_output_first", "allocator type" );
+  BitSeparableAllocator::SyncState( cp );
+}
@@ -29,6 +29,7 @@
 #include <iostream>
 
 #include "islip.hpp"
+#include "checkpoint.hpp"
 #include "random_utils.hpp"
 
 //#define DEBUG_ISLIP
@@ -181,3 +182,10 @@ void iSLIP_Sparse::Allocate( )
   cout << endl;
 #endif
 }
+
+void iSLIP_Sparse::SyncState( Checkpoint & cp )
+{
+  cp.Check( "islip", "allocator type" );
+  cp.Sync( _gptrs );
+  cp.Sync( _aptrs );
+}
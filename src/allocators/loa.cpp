@@ -29,6 +29,7 @@
 #include <iostream>
 
 #include "loa.hpp"
+#include "checkpoint.hpp"
 #include "random_utils.hpp"
 
 LOA::LOA( Module *parent, const string& name,
@@ -109,4 +110,9 @@ void LOA::Allocate( )
 
 }
 
-
+void LOA::SyncState( Checkpoint & cp )
+{
+  cp.Check( "loa", "allocator type" );
+  cp.Sync( _rptr );
+  cp.Sync( _gptr );
+}
@@ -44,6 +44,8 @@ public:
        int inputs, int outputs );
 
   void Allocate( );
+
+  void SyncState( Checkpoint & cp );
 };
 
 #endif
@@ -33,6 +33,7 @@
 #include <iostream>
 
 #include "maxsize.hpp"
+#include "checkpoint.hpp"
 
 // shortest augmenting path:
 //
@@ -208,3 +209,9 @@ bool MaxSizeMatch::_ShortestAugmenting( )
 
   return true;
 }
+
+void MaxSizeMatch::SyncState( Checkpoint & cp )
+{
+  cp.Check( "max_size", "allocator type" );
+  cp.Sync( _prio );
+}
@@ -46,6 +46,8 @@ public:
   ~MaxSizeMatch( );
   
   void Allocate( );
+
+  void SyncState( Checkpoint & cp );
 };
 
 #endif 
@@ -29,6 +29,7 @@
 #include <iostream>
 
 #include "pim.hpp"
+#include "checkpoint.hpp"
 #include "random_utils.hpp"
 
 //#define DEBUG_PIM
@@ -44,6 +45,12 @@ PIM::~PIM( )
 {
 }
 
+// the choices are random, so there is no priority state
+void PIM::SyncState( Checkpoint & cp )
+{
+  cp.Check( "pim", "allocator type" );
+}
+
 void PIM::Allocate( )
 {
   int input;
@@ -42,6 +42,8 @@ public:
   ~PIM( );
 
   void Allocate( );
+
+  void SyncState( Checkpoint & cp );
 };
 
 #endif
@@ -29,6 +29,7 @@
 #include <iostream>
 
 #include "selalloc.hpp"
+#include "checkpoint.hpp"
 #include "random_utils.hpp"
 
 //#define DEBUG_SELALLOC
@@ -252,3 +253,10 @@ void SelAlloc::PrintRequests( ostream * os ) const
   *os << "]." << endl;
 }
 
+void SelAlloc::SyncState( Checkpoint & cp )
+{
+  cp.Check( "select", "allocator type" );
+  cp.Sync( _aptrs );
+  cp.Sync( _gptrs );
+  cp.Sync( _outmask );
+}
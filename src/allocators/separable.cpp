@@ -32,6 +32,7 @@
 // ----------------------------------------------------------------------
 
 #include "separable.hpp"
+#include "checkpoint.hpp"
 
 #include <sstream>
 
@@ -84,3 +85,13 @@ void SeparableAllocator::Clear() {
   }
   SparseAllocator::Clear();
 }
+
+void SeparableAllocator::SyncState( Checkpoint & cp )
+{
+  for ( int i = 0; i < _inputs; ++i ) {
+    _input_arb[i]->SyncState( cp );
+  }
+  for ( int j = 0; j < _outputs; ++j ) {
+    _output_arb[j]->SyncState( cp );
+  }
+}
@@ -56,6 +56,8 @@ public:
 
   virtual void Clear() ;
 
+  virtual void SyncState( Checkpoint & cp );
+
 } ;
 
 #endif
@@ -32,6 +32,7 @@
 // ----------------------------------------------------------------------
 
 #include "separable_input_first.hpp"
+#include "checkpoint.hpp"
 
 #include "booksim.hpp"
 #include "arbiter.hpp"
@@ -101,3 +102,9 @@ void SeparableInputFirstAllocator::Allocate() {
     ++port_iter;
   }
 }
+
+void SeparableInputFirstAllocator::SyncState( Checkpoint & cp )
+{
+  cp.Check( "separable_input_first", "allocator type" );
+  SeparableAllocator::SyncState( cp );
+}
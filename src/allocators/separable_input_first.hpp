@@ -47,6 +47,8 @@ public:
 
   virtual void Allocate() ;
 
+  virtual void SyncState( Checkpoint & cp );
+
 } ;
 
 #endif
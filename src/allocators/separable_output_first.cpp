@@ -32,6 +32,7 @@
 // ----------------------------------------------------------------------
 
 #include "separable_output_first.hpp"
+#include "checkpoint.hpp"
 
 #include "booksim.hpp"
 #include "arbiter.hpp"
@@ -101,3 +102,9 @@ void SeparableOutputFirstAllocator::Allocate() {
     ++port_iter;
   }
 }
+
+void SeparableOutputFirstAllocator::SyncState( Checkpoint & cp )
+{
+  cp.Check( "separable_output_first", "allocator type" );
+  SeparableAllocator::SyncState( cp );
+}
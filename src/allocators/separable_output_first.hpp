@@ -45,6 +45,8 @@ public:
   
   virtual void Allocate() ;
 
+  virtual void SyncState( Checkpoint & cp );
+
 } ;
 
 #endif
@@ -33,6 +33,7 @@
 #include "booksim.hpp"
 
 #include "wavefront.hpp"
+#include "checkpoint.hpp"
 
 Wavefront::Wavefront( Module *parent, const string& name,
 		      int inputs, int outputs, bool skip_diags ) :
@@ -108,4 +109,8 @@ void Wavefront::Allocate( )
   _pri = ( ( _skip_diags ? first_diag : _pri ) + 1 ) % _square;
 }
 
-
+void Wavefront::SyncState( Checkpoint & cp )
+{
+  cp.Check( _skip_diags ? "rr_wavefront" : "wavefront", "allocator type" );
+  cp.Sync( _pri );
+}
@@ -38,6 +38,8 @@
 
 #include "module.hpp"
 
+class Checkpoint;
+
 class Arbiter : public Module {
 
 protected:
@@ -75,6 +77,10 @@ public:
 
   virtual void Clear();
 
+  // Save or restore the priority state for a checkpoint; requests are 
+  // cleared before every arbitration and need not be saved
+  virtual void SyncState( Checkpoint & cp ) {}
+
   inline int LastWinner() const {
     return _selected;
   }
@@ -32,6 +32,7 @@
 // ----------------------------------------------------------------------
 
 #include "matrix_arb.hpp"
+#include "checkpoint.hpp"
 #include <iostream>
 using namespace std ;
 
@@ -119,3 +120,9 @@ void MatrixArbiter::Clear()
   _last_req = -1;
   Arbiter::Clear();
 }
+
+void MatrixArbiter::SyncState( Checkpoint & cp )
+{
+  cp.Check( "matrix", "arbiter type" );
+  cp.Sync( _matrix );
+}
@@ -66,6 +66,8 @@ public:
 
   virtual void Clear();
 
+  virtual void SyncState( Checkpoint & cp );
+
 } ;
 
 #endif
@@ -32,6 +32,7 @@
 // ----------------------------------------------------------------------
 
 #include "roundrobin_arb.hpp"
+#include "checkpoint.hpp"
 #include <iostream>
 #include <limits>
 
@@ -78,3 +79,9 @@ void RoundRobinArbiter::Clear()
   _best_input = -1;
   Arbiter::Clear();
 }
+
+void RoundRobinArbiter::SyncState( Checkpoint & cp )
+{
+  cp.Check( "round_robin", "arbiter type" );
+  cp.Sync( _pointer );
+}
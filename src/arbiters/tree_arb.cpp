@@ -32,6 +32,7 @@
 // ----------------------------------------------------------------------
 
 #include "tree_arb.hpp"
+#include "checkpoint.hpp"
 #include <iostream>
 #include <sstream>
 
@@ -117,3 +118,13 @@ void TreeArbiter::Clear()
   _global_arbiter->Clear();
   Arbiter::Clear();
 }
+
+void TreeArbiter::SyncState( Checkpoint & cp )
+{
+  cp.Check( "tree", "arbiter type" );
+  cp.Check( _group_arbiters.size( ), "number of tree arbiter groups" );
+  for ( int i = 0; i < (int)_group_arbiters.size( ); ++i ) {
+    _group_arbiters[i]->SyncState( cp );
+  }
+  _global_arbiter->SyncState( cp );
+}
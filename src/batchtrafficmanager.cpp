@@ -42,6 +42,18 @@ BatchTrafficManager::BatchTrafficManager( const Configuration &config,
 
   _max_outstanding = config.GetInt ("max_outstanding_requests");  
 
+  // batch sources are limited by outstanding requests rather than by the 
+  // injection process alone
+  _injection_calendar = false;
+
+  if((config.GetStr("checkpoint_in") != "") || 
+     (config.GetStr("checkpoint_out") != "")) {
+    Error("Checkpoints are not supported in batch mode.");
+  }
+  if(config.GetInt("fork_sims") > 0) {
+    Error("Forked simulations are not supported in batch mode.");
+  }
+
   _batch_size = config.GetInt( "batch_size" );
   _batch_count = config.GetInt( "batch_count" );
 
@@ -120,7 +132,7 @@ bool BatchTrafficManager::_SingleSim( )
     _sim_state = running;
     int start_time = _time;
     bool batch_complete;
-    cout << "Sending batch " << batch_index + 1 << " (" << _batch_size << " packets)..." << endl;
+    *gContext->out << "Sending batch " << batch_index + 1 << " (" << _batch_size << " packets)..." << endl;
     do {
       _Step();
       batch_complete = true;
@@ -134,16 +146,16 @@ bool BatchTrafficManager::_SingleSim( )
 	*_sent_packets_out << _packet_seq_no << endl;
       }
     } while(!batch_complete);
-    cout << "Batch injected. Time used is " << _time - start_time << " cycles." << endl;
+    *gContext->out << "Batch injected. Time used is " << _time - start_time << " cycles." << endl;
 
     int sent_time = _time;
-    cout << "Waiting for batch to complete..." << endl;
+    *gContext->out << "Waiting for batch to complete..." << endl;
 
     int empty_steps = 0;
     
     bool packets_left = false;
     for(int c = 0; c < _classes; ++c) {
-      packets_left |= !_total_in_flight_flits[c].empty();
+      packets_left |= !_total_in_flight_flits[c].Empty();
     }
     
     while( packets_left ) { 
@@ -152,25 +164,25 @@ bool BatchTrafficManager::_SingleSim( )
       ++empty_steps;
       
       if ( empty_steps % 1000 == 0 ) {
-	_DisplayRemaining( ); 
-	cout << ".";
+	_DisplayRemaining( *gContext->out ); 
+	*gContext->out << ".";
       }
       
       packets_left = false;
       for(int c = 0; c < _classes; ++c) {
-	packets_left |= !_total_in_flight_flits[c].empty();
+	packets_left |= !_total_in_flight_flits[c].Empty();
       }
     }
-    cout << endl;
-    cout << "Batch received. Time used is " << _time - sent_time << " cycles." << endl
+    *gContext->out << endl;
+    *gContext->out << "Batch received. Time used is " << _time - sent_time << " cycles." << endl
 	 << "Last packet was " << _last_pid << ", last flit was " << _last_id << "." << endl;
 
     _batch_time->AddSample(_time - start_time);
 
-    cout << _sim_state << endl;
+    *gContext->out << _sim_state << endl;
 
     UpdateStats();
-    DisplayStats();
+    DisplayStats(*gContext->out);
         
     ++batch_index;
   }
@@ -203,7 +215,7 @@ void BatchTrafficManager::WriteStats(ostream & os) const
 }    
 
 void BatchTrafficManager::DisplayStats(ostream & os) const {
-  TrafficManager::DisplayStats();
+  TrafficManager::DisplayStats(os);
   os << "Minimum batch duration = " << _batch_time->Min() << endl;
   os << "Average batch duration = " << _batch_time->Average() << endl;
   os << "Maximum batch duration = " << _batch_time->Max() << endl;
@@ -225,9 +225,18 @@ BookSimConfig::BookSimConfig( )
   // types:
   //   latency    - average + latency distribution for a particular injection rate
   //   throughput - sustained throughput for a particular injection rate
+  //   sweep      - latency-throughput curve and saturation rate
 
   AddStrField( "sim_type", "latency" );
 
+  // load sweep parameters (sim_type = sweep)
+  _int_map["sweep_threads"] = 0; // simulations run concurrently; 0 = one per CPU
+  _float_map["sweep_initial_step"] = 0.05;
+  _float_map["sweep_minimum_step"] = 0.001;
+  _float_map["sweep_zero_load_rate"] = 0.0025;
+  _float_map["sweep_max_rate"] = 1.0;
+  AddStrField( "sweep_csv", "-" ); // output file for the curve; - = stdout
+
   _int_map["warmup_periods"] = 3; // number of samples periods to "warm-up" the simulation
 
   _int_map["sample_period"] = 1000; // how long between measurements
@@ -255,8 +264,31 @@ BookSimConfig::BookSimConfig( )
   _float_map["acc_stopping_thres"] = 0.05;
   AddStrField("acc_stopping_thres", ""); // workaround to allow for vector specification
 
+  // stop sampling once the batch-means confidence intervals of latency and 
+  // accepted rate are within this fraction of their means (0 = disabled)
+  _float_map["stopping_ci"] = 0.0;
+  AddStrField("stopping_ci", ""); // workaround to allow for vector specification
+  _float_map["stopping_confidence"] = 0.95;
+  _int_map["stopping_min_batches"] = 5;
+
+  // percentiles of packet, network and flit latency to report
+  AddStrField("latency_percentiles", "{50,99,99.9}");
+
   _int_map["sim_count"]     = 1;   // number of simulations to perform
 
+  _int_map["fork_sims"]     = 0;   // simulations measured concurrently after one warm-up
+
+  _int_map["sim_threads"]   = 1;   // worker threads used to step each network
+
+  _int_map["skip_idle_cycles"] = 1; // fast-forward cycles with nothing in flight
+
+  _int_map["random_streams"] = 0; // per-source and per-router random streams
+
+  // checkpoint to save after warm-up, or to start from instead of warming up
+  AddStrField("checkpoint_out", "");
+  AddStrField("checkpoint_in", "");
+  _int_map["checkpoint_random_state"] = 1; // restore random number generators
+
 
   _int_map["include_queuing"] =1; // non-zero includes source queuing latency
 
@@ -314,6 +346,8 @@ BookSimConfig::BookSimConfig( )
 
   //==================Network file===========================
   AddStrField("network_file","");
+  _int_map["anynet_threads"] = 0; // threads building the routing table; 0 = one per CPU
+  AddStrField("anynet_cache",""); // file caching the anynet routing table
 }
 
 
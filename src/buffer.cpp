@@ -26,30 +26,68 @@
 */
 
 #include <sstream>
+#include <limits>
 
 #include "globals.hpp"
 #include "booksim.hpp"
 #include "buffer.hpp"
+#include "checkpoint.hpp"
 
 Buffer::Buffer( const Configuration& config, int outputs, 
 		Module *parent, const string& name ) :
 Module( parent, name ), _occupancy(0)
 {
-  int num_vcs = config.GetInt( "num_vcs" );
+  _vcs = config.GetInt( "num_vcs" );
 
   _size = config.GetInt("buf_size");
   if(_size < 0) {
-    _size = num_vcs * config.GetInt( "vc_buf_size" );
+    _size = _vcs * config.GetInt( "vc_buf_size" );
   };
 
-  _vc.resize(num_vcs);
+  // with private buffers, the upstream router never sends a VC more flits 
+  // than its share; with the sharing policies, a VC's ring grows on demand
+  if(config.GetStr("buffer_policy") == "private") {
+    int const buf_size = config.GetInt("buf_size");
+    _vc_capacity = (buf_size <= 0) ? config.GetInt("vc_buf_size") : (buf_size / _vcs);
+  } else {
+    _vc_capacity = config.GetInt("vc_buf_size");
+  }
+  _vc_capacity = max(_vc_capacity, 1);
+
+  _flits.resize(_vcs * _vc_capacity, NULL);
+  _head.resize(_vcs, 0);
+  _count.resize(_vcs, 0);
+  _state.resize(_vcs, VC::idle);
+  _out_port.resize(_vcs, -1);
+  _out_vc.resize(_vcs, -1);
+  _pri.resize(_vcs, 0);
+  _watched.resize(_vcs, false);
+  _expected_pid.resize(_vcs, -1);
+
+  _lookahead_routing = !config.GetInt("routing_delay");
+  _route_set.resize(_vcs, NULL);
+  if(!_lookahead_routing) {
+    _route_storage.resize(_vcs);
+    for(int vc = 0; vc < _vcs; ++vc) {
+      _route_set[vc] = &_route_storage[vc];
+    }
+  }
 
-  for(int i = 0; i < num_vcs; ++i) {
-    ostringstream vc_name;
-    vc_name << "vc_" << i;
-    _vc[i] = new VC(config, outputs, this, vc_name.str( ) );
+  string priority = config.GetStr( "priority" );
+  if ( priority == "local_age" ) {
+    _pri_type = local_age_based;
+  } else if ( priority == "queue_length" ) {
+    _pri_type = queue_length_based;
+  } else if ( priority == "hop_count" ) {
+    _pri_type = hop_count_based;
+  } else if ( priority == "none" ) {
+    _pri_type = none;
+  } else {
+    _pri_type = other;
   }
 
+  _priority_donation = config.GetInt("vc_priority_donation");
+
 #ifdef TRACK_BUFFERS
   int classes = config.GetInt("classes");
   _class_occupancy.resize(classes, 0);
@@ -58,26 +96,200 @@ Module( parent, name ), _occupancy(0)
 
 Buffer::~Buffer()
 {
-  for(vector<VC*>::iterator i = _vc.begin(); i != _vc.end(); ++i) {
-    delete *i;
+}
+
+string Buffer::_VCName( int vc ) const
+{
+  ostringstream name;
+  name << FullName() << "/vc_" << vc;
+  return name.str();
+}
+
+void Buffer::_Grow( int capacity )
+{
+  assert(capacity >= _vc_capacity);
+  vector<Flit *> flits(_vcs * capacity, NULL);
+  for(int vc = 0; vc < _vcs; ++vc) {
+    for(int i = 0; i < _count[vc]; ++i) {
+      flits[vc*capacity + i] = _flits[_Slot(vc, i)];
+    }
+    _head[vc] = 0;
   }
+  _flits.swap(flits);
+  _vc_capacity = capacity;
 }
 
 void Buffer::AddFlit( int vc, Flit *f )
 {
+  assert(f);
+
   if(_occupancy >= _size) {
     Error("Flit buffer overflow.");
   }
+
+  if(_expected_pid[vc] >= 0) {
+    if(f->pid != _expected_pid[vc]) {
+      ostringstream err;
+      err << "Received flit " << f->id << " with unexpected packet ID: " << f->pid 
+	  << " (expected: " << _expected_pid[vc] << ") at VC " << vc;
+      Error(err.str());
+    } else if(f->tail) {
+      _expected_pid[vc] = -1;
+    }
+  } else if(!f->tail) {
+    _expected_pid[vc] = f->pid;
+  }
+    
+  // update flit priority before adding to VC buffer
+  if(_pri_type == local_age_based) {
+    f->pri = numeric_limits<int>::max() - GetSimTime();
+    assert(f->pri >= 0);
+  } else if(_pri_type == hop_count_based) {
+    f->pri = f->hops;
+    assert(f->pri >= 0);
+  }
+
+  if(_count[vc] == _vc_capacity) {
+    _Grow(2 * _vc_capacity);
+  }
+  _flits[_Slot(vc, _count[vc])] = f;
+  ++_count[vc];
   ++_occupancy;
-  _vc[vc]->AddFlit(f);
 #ifdef TRACK_BUFFERS
   ++_class_occupancy[f->cl];
 #endif
+
+  _UpdatePriority(vc);
+}
+
+Flit *Buffer::RemoveFlit( int vc )
+{
+  if(_count[vc] == 0) {
+    ostringstream err;
+    err << "Trying to remove flit from empty buffer at VC " << vc << ".";
+    Error(err.str());
+  }
+  Flit * const f = FrontFlit(vc);
+  --_occupancy;
+#ifdef TRACK_BUFFERS
+  assert(_class_occupancy[f->cl] > 0);
+  --_class_occupancy[f->cl];
+#endif
+  if(++_head[vc] == _vc_capacity) {
+    _head[vc] = 0;
+  }
+  --_count[vc];
+  _UpdatePriority(vc);
+  return f;
+}
+
+void Buffer::SetState( int vc, VC::eVCState s )
+{
+  Flit * f = FrontFlit(vc);
+  
+  if(f && f->watch)
+    *gContext->watch_out << GetSimTime() << " | " << _VCName(vc) << " | "
+		<< "Changing state from " << VC::VCSTATE[_state[vc]]
+		<< " to " << VC::VCSTATE[s] << "." << endl;
+  
+  _state[vc] = s;
+}
+
+void Buffer::_UpdatePriority( int vc )
+{
+  if(_count[vc] == 0) return;
+  if(_pri_type == queue_length_based) {
+    _pri[vc] = _count[vc];
+  } else if(_pri_type != none) {
+    Flit * f = FrontFlit(vc);
+    if((_pri_type != local_age_based) && _priority_donation) {
+      Flit * df = f;
+      for(int i = 1; i < _count[vc]; ++i) {
+	Flit * bf = _flits[_Slot(vc, i)];
+	if(bf->pri > df->pri) df = bf;
+      }
+      if((df != f) && (df->watch || f->watch)) {
+	*gContext->watch_out << GetSimTime() << " | " << _VCName(vc) << " | "
+		    << "Flit " << df->id
+		    << " donates priority to flit " << f->id
+		    << "." << endl;
+      }
+      f = df;
+    }
+    if(f->watch)
+      *gContext->watch_out << GetSimTime() << " | " << _VCName(vc) << " | "
+		  << "Flit " << f->id
+		  << " sets priority to " << f->pri
+		  << "." << endl;
+    _pri[vc] = f->pri;
+  }
+}
+
+void Buffer::Route( int vc, tRoutingFunction rf, const Router* router, const Flit* f, int in_channel )
+{
+  rf( router, f, in_channel, _route_set[vc], false );
+  _out_port[vc] = -1;
+  _out_vc[vc] = -1;
+}
+
+void Buffer::SyncState( Checkpoint & cp )
+{
+  cp.Check(_vcs, "number of VCs");
+  cp.Check(_size, "input buffer size");
+  cp.Sync(_occupancy);
+  for(int vc = 0; vc < _vcs; ++vc) {
+    int count = _count[vc];
+    cp.Sync(count);
+    if(cp.Restoring()) {
+      while(count > _vc_capacity) {
+	_Grow(2 * _vc_capacity);
+      }
+      _head[vc] = 0;
+      _count[vc] = count;
+    }
+    for(int i = 0; i < count; ++i) {
+      cp.Sync(_flits[_Slot(vc, i)]);
+    }
+    cp.SyncEnum(_state[vc]);
+    if(_lookahead_routing) {
+      // the route set, if still needed, is that of the head flit at the 
+      // front of the VC
+      bool front = cp.Saving() && (count > 0) && 
+	FrontFlit(vc)->OwnsRouteSet(_route_set[vc]);
+      cp.Sync(front);
+      if(cp.Restoring()) {
+	_route_set[vc] = front ? FrontFlit(vc)->LookaheadRouteSet() : NULL;
+      }
+    } else {
+      cp.Sync(_route_storage[vc]);
+    }
+  }
+  cp.Sync(_out_port);
+  cp.Sync(_out_vc);
+  cp.Sync(_pri);
+  cp.Sync(_watched);
+  cp.Sync(_expected_pid);
+#ifdef TRACK_BUFFERS
+  cp.Sync(_class_occupancy);
+#endif
 }
 
 void Buffer::Display( ostream & os ) const
 {
-  for(vector<VC*>::const_iterator i = _vc.begin(); i != _vc.end(); ++i) {
-    (*i)->Display(os);
+  for(int vc = 0; vc < _vcs; ++vc) {
+    if ( _state[vc] != VC::idle ) {
+      os << _VCName(vc) << ": "
+	 << " state: " << VC::VCSTATE[_state[vc]];
+      if(_state[vc] == VC::active) {
+	os << " out_port: " << _out_port[vc]
+	   << " out_vc: " << _out_vc[vc];
+      }
+      os << " fill: " << _count[vc];
+      if(_count[vc] > 0) {
+	os << " front: " << FrontFlit(vc)->id;
+      }
+      os << " pri: " << _pri[vc];
+      os << endl;
+    }
   }
 }
@@ -29,6 +29,7 @@
 #define _BUFFER_HPP_
 
 #include <vector>
+#include <string>
 
 #include "vc.hpp"
 #include "flit.hpp"
@@ -36,17 +37,63 @@
 #include "routefunc.hpp"
 #include "config_utils.hpp"
 
+class Checkpoint;
+
+// Input buffer of a router, holding the state of all of its virtual 
+// channels in flat per-VC arrays. The flits of VC vc occupy a ring of 
+// _vc_capacity slots starting at _flits[vc*_vc_capacity].
+
 class Buffer : public Module {
   
   int _occupancy;
   int _size;
 
-  vector<VC*> _vc;
+  int _vcs;
+  int _vc_capacity;
+
+  vector<Flit *> _flits;
+  vector<int> _head;
+  vector<int> _count;
+
+  vector<VC::eVCState> _state;
+
+  // the route set of each VC: with lookahead routing, that of the head flit,
+  // otherwise the VC's own entry in _route_storage
+  vector<OutputSet *> _route_set;
+  vector<OutputSet> _route_storage;
+
+  vector<int> _out_port;
+  vector<int> _out_vc;
+  vector<int> _pri;
+  vector<bool> _watched;
+  vector<int> _expected_pid;
+
+  enum ePrioType { local_age_based, queue_length_based, hop_count_based, none, other };
+
+  ePrioType _pri_type;
+
+  int _priority_donation;
+
+  bool _lookahead_routing;
 
 #ifdef TRACK_BUFFERS
   vector<int> _class_occupancy;
 #endif
 
+  // index in _flits of the i-th flit of VC vc, counting from the front
+  inline int _Slot( int vc, int i ) const
+  {
+    int slot = _head[vc] + i;
+    if(slot >= _vc_capacity) {
+      slot -= _vc_capacity;
+    }
+    return vc*_vc_capacity + slot;
+  }
+
+  void _Grow( int capacity );
+  void _UpdatePriority( int vc );
+  string _VCName( int vc ) const;
+
 public:
   
   Buffer( const Configuration& config, int outputs,
@@ -54,26 +101,18 @@ public:
   ~Buffer();
 
   void AddFlit( int vc, Flit *f );
+  Flit *RemoveFlit( int vc );
+
+  void SyncState( Checkpoint & cp );
 
-  inline Flit *RemoveFlit( int vc )
-  {
-    --_occupancy;
-#ifdef TRACK_BUFFERS
-    int cl = _vc[vc]->FrontFlit()->cl;
-    assert(_class_occupancy[cl] > 0);
-    --_class_occupancy[cl];
-#endif
-    return _vc[vc]->RemoveFlit( );
-  }
-  
   inline Flit *FrontFlit( int vc ) const
   {
-    return _vc[vc]->FrontFlit( );
+    return _count[vc] ? _flits[vc*_vc_capacity + _head[vc]] : NULL;
   }
   
   inline bool Empty( int vc ) const
   {
-    return _vc[vc]->Empty( );
+    return _count[vc] == 0;
   }
 
   inline bool Full( ) const
@@ -83,59 +122,56 @@ public:
 
   inline VC::eVCState GetState( int vc ) const
   {
-    return _vc[vc]->GetState( );
+    return _state[vc];
   }
 
-  inline void SetState( int vc, VC::eVCState s )
-  {
-    _vc[vc]->SetState(s);
-  }
+  void SetState( int vc, VC::eVCState s );
 
   inline const OutputSet *GetRouteSet( int vc ) const
   {
-    return _vc[vc]->GetRouteSet( );
+    return _route_set[vc];
   }
 
   inline void SetRouteSet( int vc, OutputSet * output_set )
   {
-    _vc[vc]->SetRouteSet(output_set);
+    _route_set[vc] = output_set;
+    _out_port[vc] = -1;
+    _out_vc[vc] = -1;
   }
 
   inline void SetOutput( int vc, int out_port, int out_vc )
   {
-    _vc[vc]->SetOutput(out_port, out_vc);
+    _out_port[vc] = out_port;
+    _out_vc[vc] = out_vc;
   }
 
   inline int GetOutputPort( int vc ) const
   {
-    return _vc[vc]->GetOutputPort( );
+    return _out_port[vc];
   }
 
   inline int GetOutputVC( int vc ) const
   {
-    return _vc[vc]->GetOutputVC( );
+    return _out_vc[vc];
   }
 
   inline int GetPriority( int vc ) const
   {
-    return _vc[vc]->GetPriority( );
+    return _pri[vc];
   }
 
-  inline void Route( int vc, tRoutingFunction rf, const Router* router, const Flit* f, int in_channel )
-  {
-    _vc[vc]->Route(rf, router, f, in_channel);
-  }
+  void Route( int vc, tRoutingFunction rf, const Router* router, const Flit* f, int in_channel );
 
   // ==== Debug functions ====
 
   inline void SetWatch( int vc, bool watch = true )
   {
-    _vc[vc]->SetWatch(watch);
+    _watched[vc] = watch;
   }
 
   inline bool IsWatched( int vc ) const
   {
-    return _vc[vc]->IsWatched( );
+    return _watched[vc];
   }
 
   inline int GetOccupancy( ) const
@@ -145,7 +181,7 @@ public:
 
   inline int GetOccupancy( int vc ) const
   {
-    return _vc[vc]->GetOccupancy( );
+    return _count[vc];
   }
 
 #ifdef TRACK_BUFFERS
@@ -158,4 +194,4 @@ public:
   void Display( ostream & os = cout ) const;
 };
 
-#endif 
+#endif
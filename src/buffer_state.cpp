@@ -41,6 +41,7 @@
 #include "buffer_state.hpp"
 #include "random_utils.hpp"
 #include "globals.hpp"
+#include "checkpoint.hpp"
 
 //#define DEBUG_FEEDBACK
 //#define DEBUG_SIMPLEFEEDBACK
@@ -261,6 +262,13 @@ int BufferState::SharedBufferPolicy::LimitFor(int vc) const
   return (_private_buf_size[i] + _shared_buf_size);
 }
 
+void BufferState::SharedBufferPolicy::SyncState(Checkpoint & cp)
+{
+  cp.Sync(_private_buf_occupancy);
+  cp.Sync(_shared_buf_occupancy);
+  cp.Sync(_reserved_slots);
+}
+
 BufferState::LimitedSharedBufferPolicy::LimitedSharedBufferPolicy(Configuration const & config, BufferState * parent, const string & name)
   : SharedBufferPolicy(config, parent, name), _active_vcs(0)
 {
@@ -307,6 +315,13 @@ int BufferState::LimitedSharedBufferPolicy::LimitFor(int vc) const
   return min(SharedBufferPolicy::LimitFor(vc), _max_held_slots);
 }
 
+void BufferState::LimitedSharedBufferPolicy::SyncState(Checkpoint & cp)
+{
+  SharedBufferPolicy::SyncState(cp);
+  cp.Sync(_active_vcs);
+  cp.Sync(_max_held_slots);
+}
+
 BufferState::DynamicLimitedSharedBufferPolicy::DynamicLimitedSharedBufferPolicy(Configuration const & config, BufferState * parent, const string & name)
   : LimitedSharedBufferPolicy(config, parent, name)
 {
@@ -489,6 +504,15 @@ int BufferState::FeedbackSharedBufferPolicy::LimitFor(int vc) const
   return min(SharedBufferPolicy::LimitFor(vc), _ComputeMaxSlots(vc));
 }
 
+void BufferState::FeedbackSharedBufferPolicy::SyncState(Checkpoint & cp)
+{
+  SharedBufferPolicy::SyncState(cp);
+  cp.Sync(_occupancy_limit);
+  cp.Sync(_round_trip_time);
+  cp.Sync(_flit_sent_time);
+  cp.Sync(_min_latency);
+}
+
 BufferState::SimpleFeedbackSharedBufferPolicy::SimpleFeedbackSharedBufferPolicy(Configuration const & config, BufferState * parent, const string & name)
   : FeedbackSharedBufferPolicy(config, parent, name)
 {
@@ -536,10 +560,22 @@ void BufferState::SimpleFeedbackSharedBufferPolicy::FreeSlotFor(int vc)
   SharedBufferPolicy::FreeSlotFor(vc);
 }
 
+void BufferState::SimpleFeedbackSharedBufferPolicy::SyncState(Checkpoint & cp)
+{
+  FeedbackSharedBufferPolicy::SyncState(cp);
+  cp.Sync(_pending_credits);
+}
+
 BufferState::BufferState( const Configuration& config, Module *parent, const string& name ) : 
   Module( parent, name ), _occupancy(0)
 {
   _vcs = config.GetInt( "num_vcs" );
+  if(_vcs > Credit::MAX_VCS) {
+    ostringstream err;
+    err << "Number of VCs (" << _vcs << ") exceeds the maximum of " 
+	<< Credit::MAX_VCS << " supported by credits";
+    Error( err.str() );
+  }
   _size = config.GetInt("buf_size");
   if(_size < 0) {
     _size = _vcs * config.GetInt("vc_buf_size");
@@ -573,10 +609,7 @@ void BufferState::ProcessCredit( Credit const * const c )
 {
   assert( c );
 
-  set<int>::iterator iter = c->vc.begin();
-  while(iter != c->vc.end()) {
-
-    int const vc = *iter;
+  for(int vc = c->FirstVC(); vc >= 0; vc = c->NextVC(vc)) {
 
     assert( ( vc >= 0 ) && ( vc < _vcs ) );
 
@@ -611,8 +644,6 @@ void BufferState::ProcessCredit( Credit const * const c )
 #endif
 
     _buffer_policy->FreeSlotFor(vc);
-
-    ++iter;
   }
 }
 
@@ -663,6 +694,23 @@ void BufferState::TakeBuffer( int vc, int tag )
   _buffer_policy->TakeBuffer(vc);
 }
 
+void BufferState::SyncState( Checkpoint & cp )
+{
+  cp.Check(_vcs, "number of VCs");
+  cp.Check(_size, "buffer size");
+  cp.Sync(_occupancy);
+  cp.Sync(_vc_occupancy);
+  cp.Sync(_in_use_by);
+  cp.Sync(_tail_sent);
+  cp.Sync(_last_id);
+  cp.Sync(_last_pid);
+  _buffer_policy->SyncState(cp);
+#ifdef TRACK_BUFFERS
+  cp.Sync(_outstanding_classes);
+  cp.Sync(_class_occupancy);
+#endif
+}
+
 void BufferState::Display( ostream & os ) const
 {
   os << FullName() << " :" << endl;
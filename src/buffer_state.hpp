@@ -36,6 +36,8 @@
 #include "credit.hpp"
 #include "config_utils.hpp"
 
+class Checkpoint;
+
 class BufferState : public Module {
   
   class BufferPolicy : public Module {
@@ -51,6 +53,7 @@ class BufferState : public Module {
     virtual bool IsFullFor(int vc = 0) const = 0;
     virtual int AvailableFor(int vc = 0) const = 0;
     virtual int LimitFor(int vc = 0) const = 0;
+    virtual void SyncState(Checkpoint & cp) {}
 
     static BufferPolicy * New(Configuration const & config, 
 			      BufferState * parent, const string & name);
@@ -86,6 +89,7 @@ class BufferState : public Module {
     virtual bool IsFullFor(int vc = 0) const;
     virtual int AvailableFor(int vc = 0) const;
     virtual int LimitFor(int vc = 0) const;
+    virtual void SyncState(Checkpoint & cp);
   };
 
   class LimitedSharedBufferPolicy : public SharedBufferPolicy {
@@ -102,6 +106,7 @@ class BufferState : public Module {
     virtual bool IsFullFor(int vc = 0) const;
     virtual int AvailableFor(int vc = 0) const;
     virtual int LimitFor(int vc = 0) const;
+    virtual void SyncState(Checkpoint & cp);
   };
     
   class DynamicLimitedSharedBufferPolicy : public LimitedSharedBufferPolicy {
@@ -144,6 +149,7 @@ class BufferState : public Module {
     virtual bool IsFullFor(int vc = 0) const;
     virtual int AvailableFor(int vc = 0) const;
     virtual int LimitFor(int vc = 0) const;
+    virtual void SyncState(Checkpoint & cp);
   };
   
   class SimpleFeedbackSharedBufferPolicy : public FeedbackSharedBufferPolicy {
@@ -154,6 +160,7 @@ class BufferState : public Module {
 				     BufferState * parent, const string & name);
     virtual void SendingFlit(Flit const * const f);
     virtual void FreeSlotFor(int vc = 0);
+    virtual void SyncState(Checkpoint & cp);
   };
   
   bool _wait_for_tail_credit;
@@ -191,6 +198,8 @@ public:
 
   void TakeBuffer( int vc = 0, int tag = 0 );
 
+  void SyncState( Checkpoint & cp );
+
   inline bool IsFull() const {
     assert(_occupancy <= _size);
     return (_occupancy == _size);
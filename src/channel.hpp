@@ -37,12 +37,13 @@
 #ifndef _CHANNEL_HPP
 #define _CHANNEL_HPP
 
-#include <queue>
+#include <vector>
 #include <cassert>
 
 #include "globals.hpp"
 #include "module.hpp"
 #include "timed_module.hpp"
+#include "checkpoint.hpp"
 
 using namespace std;
 
@@ -55,28 +56,49 @@ public:
   // Physical Parameters
   void SetLatency(int cycles);
   int GetLatency() const { return _delay ; }
+
+  // Cycle counter the channel reads the current time from
+  void SetClock(int const * clock) { _clock = clock; }
   
   // Send data 
   virtual void Send(T * data);
   
   // Receive data
   virtual T * Receive(); 
+
+  // Module woken whenever data is delivered at the output
+  void SetSinkModule(TimedModule * sink) { _sink_module = sink; }
   
   virtual void ReadInputs();
   virtual void Evaluate() {}
   virtual void WriteOutputs();
 
+  virtual bool Idle() const {
+    return !_input && !_output && !_in_flight;
+  }
+
+  // Save or restore the items in transit for a checkpoint
+  virtual void SyncState(Checkpoint & cp);
+
 protected:
   int _delay;
   T * _input;
   T * _output;
-  queue<pair<int, T *> > _wait_queue;
+  // items in transit, indexed by delivery cycle; the ring holds at least 
+  // _delay slots, so an item is always delivered before its slot is reused
+  vector<T *> _slots;
+  int _slot_mask;
+  int _in_flight;
+  int const * _clock;
+  TimedModule * _sink_module;
 
 };
 
 template<typename T>
 Channel<T>::Channel(Module * parent, string const & name)
-  : TimedModule(parent, name), _delay(1), _input(0), _output(0) {
+  : TimedModule(parent, name), _delay(1), _input(0), _output(0),
+    _slots(1, (T *)0), _slot_mask(0), _in_flight(0), _clock(0), 
+    _sink_module(0) {
 }
 
 template<typename T>
@@ -84,12 +106,22 @@ void Channel<T>::SetLatency(int cycles) {
   if(cycles <= 0) {
     Error("Channel must have positive delay.");
   }
+  assert(!_in_flight);
   _delay = cycles ;
+  int slots = 1;
+  while(slots < _delay) {
+    slots *= 2;
+  }
+  _slots.assign(slots, (T *)0);
+  _slot_mask = slots - 1;
 }
 
 template<typename T>
 void Channel<T>::Send(T * data) {
   _input = data;
+  if(data) {
+    Wake();
+  }
 }
 
 template<typename T>
@@ -100,7 +132,11 @@ T * Channel<T>::Receive() {
 template<typename T>
 void Channel<T>::ReadInputs() {
   if(_input) {
-    _wait_queue.push(make_pair(GetSimTime() + _delay - 1, _input));
+    assert(_clock);
+    T * & slot = _slots[(*_clock + _delay - 1) & _slot_mask];
+    assert(!slot);
+    slot = _input;
+    ++_in_flight;
     _input = 0;
   }
 }
@@ -108,18 +144,29 @@ void Channel<T>::ReadInputs() {
 template<typename T>
 void Channel<T>::WriteOutputs() {
   _output = 0;
-  if(_wait_queue.empty()) {
+  if(!_in_flight) {
     return;
   }
-  pair<int, T *> const & item = _wait_queue.front();
-  int const & time = item.first;
-  if(GetSimTime() < time) {
+  assert(_clock);
+  T * & slot = _slots[*_clock & _slot_mask];
+  if(!slot) {
     return;
   }
-  assert(GetSimTime() == time);
-  _output = item.second;
-  assert(_output);
-  _wait_queue.pop();
+  _output = slot;
+  slot = 0;
+  --_in_flight;
+  if(_sink_module) {
+    _sink_module->Wake();
+  }
+}
+
+template<typename T>
+void Channel<T>::SyncState(Checkpoint & cp) {
+  cp.Check(_delay, "latency of channel " + FullName());
+  cp.Sync(_input);
+  cp.Sync(_output);
+  cp.Sync(_slots);
+  cp.Sync(_in_flight);
 }
 
 #endif
@@ -0,0 +1,266 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2015, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <iostream>
+#include <cstdlib>
+
+#include "checkpoint.hpp"
+#include "flit.hpp"
+#include "credit.hpp"
+#include "packet_reply_info.hpp"
+#include "random_utils.hpp"
+
+// identifies the file format; bump the version whenever the set or order 
+// of saved state changes
+static char const * const CHECKPOINT_MAGIC = "BookSimCheckpoint";
+static int const CHECKPOINT_VERSION = 8;
+
+Checkpoint::Checkpoint( string const & filename, eMode mode )
+  : _mode( mode ), _keep_random_state( false ), _filename( filename ), 
+    _length( 0 )
+{
+  _file.open( filename.c_str( ), 
+	      ( ( mode == save ) ? ios::out : ios::in ) | ios::binary );
+  if ( !_file ) {
+    cerr << "Could not open checkpoint file " << filename << endl;
+    exit( -1 );
+  }
+  if ( mode == restore ) {
+    _file.seekg( 0, ios::end );
+    _length = _file.tellg( );
+    _file.seekg( 0, ios::beg );
+  }
+
+  string magic = CHECKPOINT_MAGIC;
+  Sync( magic );
+  if ( magic != CHECKPOINT_MAGIC ) {
+    cerr << filename << " is not a checkpoint file." << endl;
+    exit( -1 );
+  }
+  Check( CHECKPOINT_VERSION, "checkpoint format version" );
+}
+
+Checkpoint::~Checkpoint( )
+{
+  _file.close( );
+  if ( Saving( ) && _file.fail( ) ) {
+    cerr << "Error writing checkpoint file " << _filename << endl;
+    exit( -1 );
+  }
+}
+
+void Checkpoint::_Bytes( void * data, size_t size )
+{
+  if ( Saving( ) ) {
+    _file.write( (char const *)data, size );
+  } else {
+    _file.read( (char *)data, size );
+  }
+  if ( !_file ) {
+    cerr << "Error " << ( Saving( ) ? "writing" : "reading" ) 
+	 << " checkpoint file " << _filename << endl;
+    exit( -1 );
+  }
+}
+
+void Checkpoint::Check( int value, string const & what )
+{
+  int saved = value;
+  Sync( saved );
+  if ( saved != value ) {
+    cerr << "Checkpoint " << _filename << " does not match the configuration: "
+	 << what << " is " << saved << " in the checkpoint but " << value 
+	 << " in the simulator." << endl;
+    exit( -1 );
+  }
+}
+
+void Checkpoint::Check( string const & value, string const & what )
+{
+  string saved = value;
+  Sync( saved );
+  if ( saved != value ) {
+    cerr << "Checkpoint " << _filename << " does not match the configuration: "
+	 << what << " is " << saved << " in the checkpoint but " << value 
+	 << " in the simulator." << endl;
+    exit( -1 );
+  }
+}
+
+void Checkpoint::_SyncSize( int & size )
+{
+  Sync( size );
+  if ( Restoring( ) && 
+       ( ( size < 0 ) || ( size > _length - _file.tellg( ) ) ) ) {
+    cerr << "Corrupt checkpoint file " << _filename << ": container of " 
+	 << size << " elements." << endl;
+    exit( -1 );
+  }
+}
+
+void Checkpoint::Sync( bool & b )
+{
+  char c = b ? 1 : 0;
+  _Bytes( &c, sizeof( c ) );
+  b = ( c != 0 );
+}
+
+void Checkpoint::Sync( short & s )
+{
+  _Bytes( &s, sizeof( s ) );
+}
+
+void Checkpoint::Sync( int & i )
+{
+  _Bytes( &i, sizeof( i ) );
+}
+
+void Checkpoint::Sync( unsigned int & u )
+{
+  _Bytes( &u, sizeof( u ) );
+}
+
+void Checkpoint::Sync( long & l )
+{
+  _Bytes( &l, sizeof( l ) );
+}
+
+void Checkpoint::Sync( long long & l )
+{
+  _Bytes( &l, sizeof( l ) );
+}
+
+void Checkpoint::Sync( unsigned long long & u )
+{
+  _Bytes( &u, sizeof( u ) );
+}
+
+void Checkpoint::Sync( double & d )
+{
+  _Bytes( &d, sizeof( d ) );
+}
+
+void Checkpoint::Sync( string & s )
+{
+  int size = s.size( );
+  _SyncSize( size );
+  s.resize( size );
+  if ( size > 0 ) {
+    _Bytes( &s[0], size );
+  }
+}
+
+void Checkpoint::Sync( vector<bool> & v )
+{
+  int size = v.size( );
+  _SyncSize( size );
+  v.resize( size );
+  for ( int i = 0; i < size; ++i ) {
+    bool b = v[i];
+    Sync( b );
+    v[i] = b;
+  }
+}
+
+// the generator has no pointers, so its bytes are its state
+void Checkpoint::Sync( RandomStream & s )
+{
+  RandomStream saved = s;
+  _Bytes( &saved, sizeof( saved ) );
+  if ( Restoring( ) && !_keep_random_state ) {
+    s = saved;
+  }
+}
+
+void Checkpoint::SyncRandomState( )
+{
+  vector<long> ran_state;
+  vector<double> ranf_state;
+  if ( Saving( ) ) {
+    ran_get_state( ran_state );
+    ranf_get_state( ranf_state );
+  }
+  Sync( ran_state );
+  Sync( ranf_state );
+  if ( Restoring( ) && !_keep_random_state ) {
+    ran_set_state( ran_state );
+    ranf_set_state( ranf_state );
+  }
+}
+
+template<class T> 
+void Checkpoint::_SyncShared( T * & obj, map<void const *, int> & index, 
+			      vector<T *> & objects )
+{
+  int i = -1;
+  if ( Saving( ) ) {
+    bool first = false;
+    if ( obj ) {
+      map<void const *, int>::const_iterator iter = index.find( obj );
+      if ( iter != index.end( ) ) {
+	i = iter->second;
+      } else {
+	i = index.size( );
+	index[obj] = i;
+	first = true;
+      }
+    }
+    Sync( i );
+    if ( first ) {
+      obj->SyncState( *this );
+    }
+  } else {
+    Sync( i );
+    if ( i < 0 ) {
+      obj = NULL;
+    } else if ( i < (int)objects.size( ) ) {
+      obj = objects[i];
+    } else if ( i == (int)objects.size( ) ) {
+      obj = T::New( );
+      objects.push_back( obj );
+      obj->SyncState( *this );
+    } else {
+      cerr << "Corrupt checkpoint file " << _filename << endl;
+      exit( -1 );
+    }
+  }
+}
+
+void Checkpoint::Sync( Flit * & f )
+{
+  _SyncShared( f, _flit_index, _flits );
+}
+
+void Checkpoint::Sync( Credit * & c )
+{
+  _SyncShared( c, _credit_index, _credits );
+}
+
+void Checkpoint::Sync( PacketReplyInfo * & r )
+{
+  _SyncShared( r, _reply_index, _replies );
+}
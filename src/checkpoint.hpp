@@ -0,0 +1,220 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2015, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _CHECKPOINT_HPP_
+#define _CHECKPOINT_HPP_
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <list>
+#include <queue>
+#include <set>
+#include <map>
+#include <fstream>
+#include <functional>
+
+#include "booksim.hpp"
+
+class Flit;
+class Credit;
+class PacketReplyInfo;
+class RandomStream;
+
+// ----------------------------------------------------------------------
+//
+//  Checkpoint: binary snapshot of the state of a simulation. Every class 
+//  that holds simulation state implements SyncState(Checkpoint &), which 
+//  passes its members to Sync() in a fixed order; the same code thus 
+//  writes the state when saving and reads it back into a freshly built 
+//  simulator when restoring. Flits, credits and reply records are written 
+//  out at their first reference and referred to by index afterwards, so 
+//  objects that are shared between several containers are restored as a 
+//  single object. Structural parameters (numbers of ports, VCs etc.) are 
+//  recorded with Check(), which fails if the restoring simulator does not 
+//  match the saved one.
+//
+// ----------------------------------------------------------------------
+
+class Checkpoint {
+
+public:
+
+  enum eMode { save, restore };
+
+  Checkpoint( string const & filename, eMode mode );
+  ~Checkpoint( );
+
+  inline bool Saving( ) const { return _mode == save; }
+  inline bool Restoring( ) const { return _mode == restore; }
+
+  // When restoring, optionally leave the random number generators as they 
+  // are instead of resetting them to the saved state.
+  inline void KeepRandomState( bool keep ) { _keep_random_state = keep; }
+
+  // state of the global random number generators
+  void SyncRandomState( );
+
+  void Check( int value, string const & what );
+  void Check( string const & value, string const & what );
+
+  void Sync( bool & b );
+  void Sync( short & s );
+  void Sync( int & i );
+  void Sync( unsigned int & u );
+  void Sync( long & l );
+  void Sync( long long & l );
+  void Sync( unsigned long long & u );
+  void Sync( double & d );
+  void Sync( string & s );
+
+  void Sync( Flit * & f );
+  void Sync( Credit * & c );
+  void Sync( PacketReplyInfo * & r );
+  void Sync( RandomStream & s );
+
+  template<class E> void SyncEnum( E & e ) {
+    int i = e;
+    Sync( i );
+    e = (E)i;
+  }
+
+  // any other object saves its own state
+  template<class T> void Sync( T & obj ) {
+    obj.SyncState( *this );
+  }
+
+  template<class A, class B> void Sync( pair<A, B> & p ) {
+    Sync( p.first );
+    Sync( p.second );
+  }
+
+  template<class T> void Sync( vector<T> & v ) {
+    int size = v.size( );
+    _SyncSize( size );
+    v.resize( size );
+    for ( int i = 0; i < size; ++i ) {
+      Sync( v[i] );
+    }
+  }
+
+  void Sync( vector<bool> & v );
+
+  template<class T> void Sync( deque<T> & d ) {
+    int size = d.size( );
+    _SyncSize( size );
+    d.resize( size );
+    for ( int i = 0; i < size; ++i ) {
+      Sync( d[i] );
+    }
+  }
+
+  template<class T> void Sync( list<T> & l ) {
+    int size = l.size( );
+    _SyncSize( size );
+    l.resize( size );
+    for ( typename list<T>::iterator iter = l.begin( ); 
+	  iter != l.end( ); ++iter ) {
+      Sync( *iter );
+    }
+  }
+
+  template<class T> void Sync( queue<T> & q ) {
+    deque<T> d;
+    if ( Saving( ) ) {
+      for ( queue<T> copy = q; !copy.empty( ); copy.pop( ) ) {
+	d.push_back( copy.front( ) );
+      }
+    }
+    Sync( d );
+    if ( Restoring( ) ) {
+      q = queue<T>( d );
+    }
+  }
+
+  template<class T, class C> 
+  void Sync( priority_queue<T, vector<T>, C> & q ) {
+    vector<T> v;
+    if ( Saving( ) ) {
+      for ( priority_queue<T, vector<T>, C> copy = q; 
+	    !copy.empty( ); copy.pop( ) ) {
+	v.push_back( copy.top( ) );
+      }
+    }
+    Sync( v );
+    if ( Restoring( ) ) {
+      q = priority_queue<T, vector<T>, C>( C( ), v );
+    }
+  }
+
+  template<class T> void Sync( set<T> & s ) {
+    vector<T> v( s.begin( ), s.end( ) );
+    Sync( v );
+    if ( Restoring( ) ) {
+      s = set<T>( v.begin( ), v.end( ) );
+    }
+  }
+
+  template<class K, class V> void Sync( map<K, V> & m ) {
+    vector<pair<K, V> > v( m.begin( ), m.end( ) );
+    Sync( v );
+    if ( Restoring( ) ) {
+      m = map<K, V>( v.begin( ), v.end( ) );
+    }
+  }
+
+private:
+
+  eMode _mode;
+  bool _keep_random_state;
+  string _filename;
+  fstream _file;
+  // length of the file being restored
+  streamoff _length;
+
+  // indices of the objects written so far (when saving) and the objects 
+  // read so far (when restoring)
+  map<void const *, int> _flit_index;
+  vector<Flit *> _flits;
+  map<void const *, int> _credit_index;
+  vector<Credit *> _credits;
+  map<void const *, int> _reply_index;
+  vector<PacketReplyInfo *> _replies;
+
+  void _Bytes( void * data, size_t size );
+
+  // number of elements of a container; when restoring, every element takes 
+  // at least one byte, so a count beyond the rest of the file is corrupt
+  void _SyncSize( int & size );
+
+  template<class T> void _SyncShared( T * & obj, 
+				      map<void const *, int> & index, 
+				      vector<T *> & objects );
+
+};
+
+#endif
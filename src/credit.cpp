@@ -32,9 +32,8 @@
 
 #include "booksim.hpp"
 #include "credit.hpp"
-
-stack<Credit *> Credit::_all;
-stack<Credit *> Credit::_free;
+#include "simulation_context.hpp"
+#include "checkpoint.hpp"
 
 Credit::Credit()
 {
@@ -43,37 +42,103 @@ Credit::Credit()
 
 void Credit::Reset()
 {
-  vc.clear();
+  for(int w = 0; w < MAX_VCS / 64; ++w) {
+    _vc_mask[w] = 0;
+  }
   head = false;
   tail = false;
   id   = -1;
 }
 
+void Credit::SyncState(Checkpoint & cp)
+{
+  for(int w = 0; w < MAX_VCS / 64; ++w) {
+    cp.Sync(_vc_mask[w]);
+  }
+  cp.Sync(head);
+  cp.Sync(tail);
+  cp.Sync(id);
+}
+
+int Credit::NumVCs() const
+{
+  int count = 0;
+  for(int w = 0; w < MAX_VCS / 64; ++w) {
+    count += __builtin_popcountll(_vc_mask[w]);
+  }
+  return count;
+}
+
+int Credit::NextVC(int vc) const
+{
+  for(int w = (vc + 1) / 64; w < MAX_VCS / 64; ++w) {
+    unsigned long long bits = _vc_mask[w];
+    if(w == (vc + 1) / 64) {
+      bits &= ~0ULL << ((vc + 1) % 64);
+    }
+    if(bits) {
+      return w * 64 + __builtin_ctzll(bits);
+    }
+  }
+  return -1;
+}
+
+Credit::Pool::Pool()
+  : free(0), num_in_use(0), locked(false)
+{
+  pthread_mutex_init(&lock, NULL);
+}
+
+Credit::Pool::~Pool()
+{
+  Release();
+  pthread_mutex_destroy(&lock);
+}
+
+void Credit::Pool::Release()
+{
+  for(size_t i = 0; i < slabs.size(); ++i) {
+    delete [] slabs[i];
+  }
+  slabs.clear();
+  free = 0;
+  num_in_use = 0;
+}
+
 Credit * Credit::New() {
-  Credit * c;
-  if(_free.empty()) {
-    c = new Credit();
-    _all.push(c);
-  } else {
-    c = _free.top();
-    c->Reset();
-    _free.pop();
+  Pool & pool = gContext->credit_pool;
+  if(pool.locked) pthread_mutex_lock(&pool.lock);
+  if(!pool.free) {
+    Credit * slab = new Credit[_slab_size];
+    pool.slabs.push_back(slab);
+    for(int i = _slab_size - 1; i >= 0; --i) {
+      slab[i]._next_free = pool.free;
+      pool.free = &slab[i];
+    }
   }
+  Credit * c = pool.free;
+  pool.free = c->_next_free;
+  ++pool.num_in_use;
+  if(pool.locked) pthread_mutex_unlock(&pool.lock);
+  c->Reset();
   return c;
 }
 
 void Credit::Free() {
-  _free.push(this);
+  Pool & pool = gContext->credit_pool;
+  if(pool.locked) pthread_mutex_lock(&pool.lock);
+  assert(pool.num_in_use > 0);
+  _next_free = pool.free;
+  pool.free = this;
+  --pool.num_in_use;
+  if(pool.locked) pthread_mutex_unlock(&pool.lock);
 }
 
 void Credit::FreeAll() {
-  while(!_all.empty()) {
-    delete _all.top();
-    _all.pop();
-  }
+  gContext->credit_pool.Release();
 }
 
 
 int Credit::OutStanding(){
-  return _all.size()-_free.size();
+  return gContext->credit_pool.num_in_use;
 }
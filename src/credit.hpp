@@ -28,29 +28,80 @@
 #ifndef _CREDIT_HPP_
 #define _CREDIT_HPP_
 
-#include <set>
-#include <stack>
+#include <vector>
+#include <cassert>
+#include <pthread.h>
+
+#include "booksim.hpp"
+
+class Checkpoint;
 
 class Credit {
 
 public:
 
-  set<int> vc;
+  // VCs are carried as a bitmask, so a credit never allocates
+  const static int MAX_VCS = 128;
+
+  inline void AddVC(int vc) {
+    assert((vc >= 0) && (vc < MAX_VCS));
+    _vc_mask[vc / 64] |= (1ULL << (vc % 64));
+  }
+  inline bool HasVC(int vc) const {
+    assert((vc >= 0) && (vc < MAX_VCS));
+    return (_vc_mask[vc / 64] >> (vc % 64)) & 1;
+  }
+  inline bool NoVCs() const {
+    for(int w = 0; w < MAX_VCS / 64; ++w) {
+      if(_vc_mask[w]) {
+        return false;
+      }
+    }
+    return true;
+  }
+  int NumVCs() const;
+  // iterate over the credited VCs in ascending order; -1 marks the end
+  int FirstVC() const { return NextVC(-1); }
+  int NextVC(int vc) const;
 
   // these are only used by the event router
   bool head, tail;
   int  id;
 
   void Reset();
+
+  void SyncState(Checkpoint & cp);
   
   static Credit * New();
   void Free();
   static void FreeAll();
   static int OutStanding();
+
+  // free list of a simulation's credits (owned by its SimulationContext)
+  struct Pool {
+    vector<Credit *> slabs;
+    Credit * free;
+    int num_in_use;
+    // routers may allocate and free credits from parallel worker threads;
+    // the lock is only taken when the parallel cycle engine is enabled
+    pthread_mutex_t lock;
+    bool locked;
+    Pool();
+    ~Pool();
+    void Release();
+  };
+
 private:
 
-  static stack<Credit *> _all;
-  static stack<Credit *> _free;
+  // while a credit sits on the free list, the mask holds the link to 
+  // the next free credit
+  union {
+    unsigned long long _vc_mask[MAX_VCS / 64];
+    Credit * _next_free;
+  };
+
+  // credits are carved out of contiguous slabs of this many entries
+  const static int _slab_size = 1024;
 
   Credit();
   ~Credit() {}
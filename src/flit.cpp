@@ -36,9 +36,8 @@
 
 #include "booksim.hpp"
 #include "flit.hpp"
-
-stack<Flit *> Flit::_all;
-stack<Flit *> Flit::_free;
+#include "simulation_context.hpp"
+#include "checkpoint.hpp"
 
 ostream& operator<<( ostream& os, const Flit& f )
 {
@@ -58,6 +57,34 @@ Flit::Flit()
   Reset();
 }  
 
+void Flit::SyncState(Checkpoint & cp)
+{
+  cp.SyncEnum(type);
+  cp.Sync(vc);
+  cp.Sync(ctime);
+  cp.Sync(itime);
+  cp.Sync(atime);
+  cp.Sync(id);
+  cp.Sync(pid);
+  cp.Sync(src);
+  cp.Sync(dest);
+  cp.Sync(pri);
+  cp.Sync(intm);
+  cp.Sync(cl);
+  cp.Sync(hops);
+  cp.Sync(subnetwork);
+  cp.Sync(ph);
+  cp.Sync(head);
+  cp.Sync(tail);
+  cp.Sync(record);
+  cp.Sync(watch);
+  bool has_route_set = (_la_route_set != 0);
+  cp.Sync(has_route_set);
+  if(has_route_set) {
+    cp.Sync(*LookaheadRouteSet());
+  }
+}
+
 void Flit::Reset() 
 {  
   type      = ANY_TYPE ;
@@ -79,29 +106,104 @@ void Flit::Reset()
   pri = 0;
   intm =-1;
   ph = -1;
-  data = 0;
+  _la_route_set = 0;
 }  
 
-Flit * Flit::New() {
-  Flit * f;
-  if(_free.empty()) {
-    f = new Flit;
-    _all.push(f);
+Flit::Pool::Pool()
+  : free(0), locked(false), num_allocated(0), num_in_use(0), high_water(0)
+{
+  pthread_mutex_init(&route_set_lock, NULL);
+}
+
+Flit::Pool::~Pool()
+{
+  Release();
+  pthread_mutex_destroy(&route_set_lock);
+}
+
+void Flit::Pool::Release()
+{
+  for(size_t i = 0; i < slabs.size(); ++i) {
+    delete [] slabs[i];
+  }
+  slabs.clear();
+  free = 0;
+  for(size_t i = 0; i < all_route_sets.size(); ++i) {
+    delete all_route_sets[i];
+  }
+  all_route_sets.clear();
+  free_route_sets.clear();
+  num_allocated = 0;
+  num_in_use = 0;
+  high_water = 0;
+}
+
+OutputSet * Flit::_NewRouteSet() {
+  Pool & pool = gContext->flit_pool;
+  OutputSet * os;
+  if(pool.locked) pthread_mutex_lock(&pool.route_set_lock);
+  if(pool.free_route_sets.empty()) {
+    os = new OutputSet;
+    pool.all_route_sets.push_back(os);
   } else {
-    f = _free.top();
-    f->Reset();
-    _free.pop();
+    os = pool.free_route_sets.back();
+    os->Clear();
+    pool.free_route_sets.pop_back();
+  }
+  if(pool.locked) pthread_mutex_unlock(&pool.route_set_lock);
+  return os;
+}
+
+Flit * Flit::New() {
+  Pool & pool = gContext->flit_pool;
+  if(!pool.free) {
+    Flit * slab = new Flit[_slab_size];
+    pool.slabs.push_back(slab);
+    for(int i = _slab_size - 1; i >= 0; --i) {
+      slab[i]._next_free = pool.free;
+      pool.free = &slab[i];
+    }
+    pool.num_allocated += _slab_size;
+  }
+  Flit * f = pool.free;
+  pool.free = f->_next_free;
+  f->Reset();
+  ++pool.num_in_use;
+  if(pool.num_in_use > pool.high_water) {
+    pool.high_water = pool.num_in_use;
   }
   return f;
 }
 
 void Flit::Free() {
-  _free.push(this);
+  Pool & pool = gContext->flit_pool;
+  assert(pool.num_in_use > 0);
+  if(_la_route_set) {
+    if(pool.locked) pthread_mutex_lock(&pool.route_set_lock);
+    pool.free_route_sets.push_back(_la_route_set);
+    if(pool.locked) pthread_mutex_unlock(&pool.route_set_lock);
+  }
+  _next_free = pool.free;
+  pool.free = this;
+  --pool.num_in_use;
 }
 
 void Flit::FreeAll() {
-  while(!_all.empty()) {
-    delete _all.top();
-    _all.pop();
-  }
+  gContext->flit_pool.Release();
+}
+
+int Flit::NumAllocated() {
+  return gContext->flit_pool.num_allocated;
+}
+
+int Flit::NumInUse() {
+  return gContext->flit_pool.num_in_use;
+}
+
+int Flit::NumFree() {
+  return gContext->flit_pool.num_allocated - gContext->flit_pool.num_in_use;
+}
+
+int Flit::HighWater() {
+  return gContext->flit_pool.high_water;
 }
@@ -29,11 +29,15 @@
 #define _FLIT_HPP_
 
 #include <iostream>
-#include <stack>
+#include <vector>
+#include <cassert>
+#include <pthread.h>
 
 #include "booksim.hpp"
 #include "outputset.hpp"
 
+class Checkpoint;
+
 class Flit {
 
 public:
@@ -44,15 +48,12 @@ public:
 		  WRITE_REQUEST = 2,
 		  WRITE_REPLY   = 3,
                   ANY_TYPE      = 4 };
+  // Fields are ordered by size so that the whole flit, including the 
+  // lookahead route set pointer, packs into a single 64-byte cache line.
   FlitType type;
 
   int vc;
 
-  int cl;
-
-  bool head;
-  bool tail;
-  
   int  ctime;
   int  itime;
   int  atime;
@@ -60,42 +61,98 @@ public:
   int  id;
   int  pid;
 
-  bool record;
-
   int  src;
   int  dest;
 
   int  pri;
 
-  int  hops;
-  bool watch;
-  int  subnetwork;
-  
   // intermediate destination (if any)
   mutable int intm;
 
+  short cl;
+
+  short hops;
+  short subnetwork;
+
   // phase in multi-phase algorithms
-  mutable int ph;
+  mutable short ph;
 
-  // Fields for arbitrary data
-  void* data ;
+  bool head;
+  bool tail;
+
+  bool record;
+  bool watch;
 
-  // Lookahead route info
-  OutputSet la_route_set;
+  // Lookahead route info; allocated on first use and returned to a shared 
+  // pool when the flit is freed, as most configurations never need it
+  inline OutputSet * LookaheadRouteSet() {
+    if(!_la_route_set) {
+      _la_route_set = _NewRouteSet();
+    }
+    return _la_route_set;
+  }
+  inline OutputSet const * LookaheadRouteSet() const {
+    assert(_la_route_set);
+    return _la_route_set;
+  }
+  inline void ClearLookaheadRouteSet() {
+    if(_la_route_set) {
+      _la_route_set->Clear();
+    }
+  }
+  inline bool OwnsRouteSet(OutputSet const * route_set) const {
+    return _la_route_set && (_la_route_set == route_set);
+  }
 
   void Reset();
 
+  void SyncState(Checkpoint & cp);
+
   static Flit * New();
   void Free();
   static void FreeAll();
 
+  // pool statistics
+  static int NumAllocated();
+  static int NumInUse();
+  static int NumFree();
+  static int HighWater();
+
+  // free lists of a simulation's flits and route sets (owned by its 
+  // SimulationContext)
+  struct Pool {
+    vector<Flit *> slabs;
+    Flit * free;
+    vector<OutputSet *> free_route_sets;
+    vector<OutputSet *> all_route_sets;
+    // routers allocate route sets from parallel worker threads; the lock 
+    // is only taken when the parallel cycle engine is enabled
+    pthread_mutex_t route_set_lock;
+    bool locked;
+    int num_allocated;
+    int num_in_use;
+    int high_water;
+    Pool();
+    ~Pool();
+    void Release();
+  };
+
 private:
 
   Flit();
   ~Flit() {}
 
-  static stack<Flit *> _all;
-  static stack<Flit *> _free;
+  // while a flit sits on the free list, the route set pointer slot holds 
+  // the link to the next free flit
+  union {
+    OutputSet * _la_route_set;
+    Flit * _next_free;
+  };
+
+  static OutputSet * _NewRouteSet();
+
+  // flits are carved out of contiguous slabs of this many entries
+  const static int _slab_size = 1024;
 
 };
 
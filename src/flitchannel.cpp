@@ -73,7 +73,7 @@ void FlitChannel::Send(Flit * f) {
 void FlitChannel::ReadInputs() {
   Flit const * const & f = _input;
   if(f && f->watch) {
-    *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+    *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 	       << "Beginning channel traversal for flit " << f->id
 	       << " with delay " << _delay
 	       << "." << endl;
@@ -84,8 +84,14 @@ void FlitChannel::ReadInputs() {
 void FlitChannel::WriteOutputs() {
   Channel<Flit>::WriteOutputs();
   if(_output && _output->watch) {
-    *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+    *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 	       << "Completed channel traversal for flit " << _output->id
 	       << "." << endl;
   }
 }
+
+void FlitChannel::SyncState(Checkpoint & cp) {
+  Channel<Flit>::SyncState(cp);
+  cp.Sync(_active);
+  cp.Sync(_idle);
+}
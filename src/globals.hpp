@@ -31,6 +31,8 @@
 #include <vector>
 #include <iostream>
 
+#include "simulation_context.hpp"
+
 /*all declared in main.cpp*/
 
 int GetSimTime();
@@ -38,16 +40,4 @@ int GetSimTime();
 class Stats;
 Stats * GetStats(const std::string & name);
 
-extern bool gPrintActivity;
-
-extern int gK;
-extern int gN;
-extern int gC;
-
-extern int gNodes;
-
-extern bool gTrace;
-
-extern std::ostream * gWatchOut;
-
 #endif
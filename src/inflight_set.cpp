@@ -0,0 +1,137 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2015, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <cassert>
+
+#include "inflight_set.hpp"
+#include "checkpoint.hpp"
+
+InFlightSet::InFlightSet()
+  : _present(64, false), _mask(63), _base(0), _end(0), _size(0), _ctime_sum(0)
+{
+}
+
+void InFlightSet::Insert(int id, int ctime)
+{
+  assert(id >= _end);
+  if(_size == (int)_stragglers.size()) {
+    _base = id;
+  } else if(id - _base > _mask) {
+    if(id - _base >= _max_span) {
+      _Evict(id);
+    }
+    if(id - _base > _mask) {
+      _Grow(id - _base + 1);
+    }
+  }
+  _present[id & _mask] = true;
+  _end = id + 1;
+  ++_size;
+  _ctime_sum += ctime;
+}
+
+void InFlightSet::Erase(int id, int ctime)
+{
+  assert(id < _end);
+  --_size;
+  _ctime_sum -= ctime;
+  if(id < _base) {
+    int const erased = _stragglers.erase(id);
+    assert(erased == 1);
+    return;
+  }
+  assert(_present[id & _mask]);
+  _present[id & _mask] = false;
+  if(_size == (int)_stragglers.size()) {
+    _base = _end;
+  } else if(id == _base) {
+    do {
+      ++_base;
+    } while(!_present[_base & _mask]);
+  }
+}
+
+void InFlightSet::LowestIDs(int max, vector<int> & ids) const
+{
+  int found = 0;
+  for(set<int>::const_iterator iter = _stragglers.begin();
+      (iter != _stragglers.end()) && (found < max); ++iter) {
+    ids.push_back(*iter);
+    ++found;
+  }
+  for(int id = _base; (id < _end) && (found < max); ++id) {
+    if(_present[id & _mask]) {
+      ids.push_back(id);
+      ++found;
+    }
+  }
+}
+
+void InFlightSet::SyncState(Checkpoint & cp)
+{
+  cp.Sync(_present);
+  cp.Sync(_stragglers);
+  cp.Sync(_mask);
+  cp.Sync(_base);
+  cp.Sync(_end);
+  cp.Sync(_size);
+  cp.Sync(_ctime_sum);
+}
+
+void InFlightSet::_Grow(int span)
+{
+  int size = _present.size();
+  while(size < span) {
+    size *= 2;
+  }
+  vector<bool> present(size, false);
+  int const mask = size - 1;
+  for(int id = _base; id < _end; ++id) {
+    present[id & mask] = _present[id & _mask];
+  }
+  _present.swap(present);
+  _mask = mask;
+}
+
+// move outstanding IDs out of the bitmap until id fits within _max_span 
+// of the oldest one left in it
+void InFlightSet::_Evict(int id)
+{
+  while((_base < _end) && (id - _base >= _max_span)) {
+    if(_present[_base & _mask]) {
+      _present[_base & _mask] = false;
+      _stragglers.insert(_base);
+    }
+    ++_base;
+  }
+  while((_base < _end) && !_present[_base & _mask]) {
+    ++_base;
+  }
+  if(_base == _end) {
+    _base = id;
+  }
+}
@@ -0,0 +1,82 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2015, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _INFLIGHT_SET_HPP_
+#define _INFLIGHT_SET_HPP_
+
+#include <vector>
+#include <set>
+
+#include "booksim.hpp"
+
+class Checkpoint;
+
+// Tracks the IDs of flits that have been generated but not yet retired. 
+// IDs must be inserted in increasing order; they are kept in a circular 
+// bitmap spanning the oldest outstanding ID to the newest, so insertion 
+// and removal are O(1) and the creation times of all outstanding flits 
+// are available as a running sum. The bitmap covers at most _max_span 
+// IDs; outstanding IDs that fall behind that window, e.g. flits stalled 
+// for a long time, are moved to a sparse set instead.
+class InFlightSet {
+
+public:
+
+  InFlightSet();
+
+  void Insert(int id, int ctime);
+  void Erase(int id, int ctime);
+
+  inline bool Empty() const { return _size == 0; }
+  inline int Size() const { return _size; }
+
+  // sum over all outstanding flits of their creation times
+  inline long long CtimeSum() const { return _ctime_sum; }
+
+  // append up to max of the lowest outstanding IDs to ids
+  void LowestIDs(int max, vector<int> & ids) const;
+
+  void SyncState(Checkpoint & cp);
+
+private:
+
+  static int const _max_span = 1 << 20;
+
+  void _Grow(int span);
+  void _Evict(int id);
+
+  vector<bool> _present;
+  set<int> _stragglers;
+  int _mask;
+  int _base;
+  int _end;
+  int _size;
+  long long _ctime_sum;
+
+};
+
+#endif
@@ -29,8 +29,10 @@
 #include <vector>
 #include <cassert>
 #include <limits>
+#include <cmath>
 #include "random_utils.hpp"
 #include "injection.hpp"
+#include "checkpoint.hpp"
 
 using namespace std;
 
@@ -53,6 +55,35 @@ void InjectionProcess::reset()
 
 }
 
+void InjectionProcess::skip(int source, int trials)
+{
+  for(int i = 0; i < trials; ++i) {
+    bool const result = test(source);
+    assert(!result);
+  }
+}
+
+// Number of failed Bernoulli trials with success probability p before the 
+// first success; saturates at the largest int for tiny or zero p.
+static int geometric_trials(double p)
+{
+  if(p >= 1.0) {
+    return 0;
+  }
+  if(p <= 0.0) {
+    return numeric_limits<int>::max();
+  }
+  double u = 1.0 - RandomFloat();
+  if(u <= 0.0) {
+    u = numeric_limits<double>::min();
+  }
+  double const trials = floor(log(u) / log(1.0 - p));
+  if(trials >= (double)numeric_limits<int>::max()) {
+    return numeric_limits<int>::max();
+  }
+  return (int)trials;
+}
+
 InjectionProcess * InjectionProcess::New(string const & inject, int nodes, 
 					 double load, 
 					 Configuration const * const config)
@@ -76,7 +107,9 @@ InjectionProcess * InjectionProcess::New(string const & inject, int nodes,
   InjectionProcess * result = NULL;
   if(process_name == "bernoulli") {
     result = new BernoulliInjectionProcess(nodes, load);
-  } else if(process_name == "on_off") {
+  } else if(process_name == "geometric") {
+    result = new GeometricInjectionProcess(nodes, load);
+  } else if((process_name == "on_off") || (process_name == "on_off_geometric")) {
     bool missing_params = false;
     double alpha = numeric_limits<double>::quiet_NaN();
     if(params.size() < 1) {
@@ -124,7 +157,12 @@ InjectionProcess * InjectionProcess::New(string const & inject, int nodes,
 	initial[n] = RandomInt(1);
       }
     }
-    result = new OnOffInjectionProcess(nodes, load, alpha, beta, r1, initial);
+    if(process_name == "on_off") {
+      result = new OnOffInjectionProcess(nodes, load, alpha, beta, r1, initial);
+    } else {
+      result = new OnOffGeometricInjectionProcess(nodes, load, alpha, beta, r1, 
+						  initial);
+    }
   } else {
     cout << "Invalid injection process: " << inject << endl;
     exit(-1);
@@ -148,6 +186,51 @@ bool BernoulliInjectionProcess::test(int source)
 
 //=============================================================
 
+GeometricInjectionProcess::GeometricInjectionProcess(int nodes, double rate)
+  : InjectionProcess(nodes, rate)
+{
+  reset();
+}
+
+void GeometricInjectionProcess::reset()
+{
+  _gap.resize(_nodes);
+  for(int n = 0; n < _nodes; ++n) {
+    _gap[n] = geometric_trials(_rate);
+  }
+}
+
+bool GeometricInjectionProcess::test(int source)
+{
+  assert((source >= 0) && (source < _nodes));
+  if(_gap[source] > 0) {
+    --_gap[source];
+    return false;
+  }
+  _gap[source] = geometric_trials(_rate);
+  return true;
+}
+
+int GeometricInjectionProcess::idle(int source) const
+{
+  assert((source >= 0) && (source < _nodes));
+  return _gap[source];
+}
+
+void GeometricInjectionProcess::skip(int source, int trials)
+{
+  assert((source >= 0) && (source < _nodes));
+  assert((trials >= 0) && (trials <= _gap[source]));
+  _gap[source] -= trials;
+}
+
+void GeometricInjectionProcess::SyncState(Checkpoint & cp)
+{
+  cp.Sync(_gap);
+}
+
+//=============================================================
+
 OnOffInjectionProcess::OnOffInjectionProcess(int nodes, double rate, 
 					     double alpha, double beta, 
 					     double r1, vector<int> initial)
@@ -188,3 +271,83 @@ bool OnOffInjectionProcess::test(int source)
   // generate packet
   return _state[source] && (RandomFloat() < _r1);
 }
+
+void OnOffInjectionProcess::SyncState(Checkpoint & cp)
+{
+  cp.Sync(_state);
+}
+
+//=============================================================
+
+OnOffGeometricInjectionProcess::OnOffGeometricInjectionProcess(int nodes, 
+							       double rate, 
+							       double alpha, 
+							       double beta, 
+							       double r1, 
+							       vector<int> initial)
+  : OnOffInjectionProcess(nodes, rate, alpha, beta, r1, initial)
+{
+  reset();
+}
+
+void OnOffGeometricInjectionProcess::reset()
+{
+  OnOffInjectionProcess::reset();
+  _gap.resize(_nodes);
+  for(int n = 0; n < _nodes; ++n) {
+    _gap[n] = _SampleGap(n);
+  }
+}
+
+// While off, the next event is the switch to on; while on, it is either 
+// the switch to off or the generation of a packet.
+int OnOffGeometricInjectionProcess::_SampleGap(int source) const
+{
+  return geometric_trials(_state[source] ? 
+			  (_beta + (1.0 - _beta) * _r1) : 
+			  _alpha);
+}
+
+bool OnOffGeometricInjectionProcess::test(int source)
+{
+  assert((source >= 0) && (source < _nodes));
+
+  if(_gap[source] > 0) {
+    --_gap[source];
+    return false;
+  }
+
+  bool generate;
+  if(!_state[source]) {
+    // the cycle in which a source turns on may already generate a packet
+    _state[source] = 1;
+    generate = (RandomFloat() < _r1);
+  } else {
+    double const p_event = _beta + (1.0 - _beta) * _r1;
+    generate = (RandomFloat() * p_event >= _beta);
+    if(!generate) {
+      _state[source] = 0;
+    }
+  }
+  _gap[source] = _SampleGap(source);
+  return generate;
+}
+
+int OnOffGeometricInjectionProcess::idle(int source) const
+{
+  assert((source >= 0) && (source < _nodes));
+  return _gap[source];
+}
+
+void OnOffGeometricInjectionProcess::skip(int source, int trials)
+{
+  assert((source >= 0) && (source < _nodes));
+  assert((trials >= 0) && (trials <= _gap[source]));
+  _gap[source] -= trials;
+}
+
+void OnOffGeometricInjectionProcess::SyncState(Checkpoint & cp)
+{
+  OnOffInjectionProcess::SyncState(cp);
+  cp.Sync(_gap);
+}
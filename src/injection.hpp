@@ -32,6 +32,8 @@
 
 using namespace std;
 
+class Checkpoint;
+
 class InjectionProcess {
 protected:
   int _nodes;
@@ -41,6 +43,12 @@ public:
   virtual ~InjectionProcess() {}
   virtual bool test(int source) = 0;
   virtual void reset();
+  // Skip-ahead processes know how many of the upcoming calls to test() 
+  // for a source will fail, and can consume those trials in one step.
+  virtual bool skip_ahead() const { return false; }
+  virtual int idle(int source) const { return 0; }
+  virtual void skip(int source, int trials);
+  virtual void SyncState(Checkpoint & cp) {}
   static InjectionProcess * New(string const & inject, int nodes, double load, 
 				Configuration const * const config = NULL);
 };
@@ -51,8 +59,23 @@ public:
   virtual bool test(int source);
 };
 
-class OnOffInjectionProcess : public InjectionProcess {
+// Bernoulli arrivals generated by sampling the geometrically distributed 
+// number of empty cycles between packets
+class GeometricInjectionProcess : public InjectionProcess {
 private:
+  vector<int> _gap;
+public:
+  GeometricInjectionProcess(int nodes, double rate);
+  virtual void reset();
+  virtual bool test(int source);
+  virtual bool skip_ahead() const { return true; }
+  virtual int idle(int source) const;
+  virtual void skip(int source, int trials);
+  virtual void SyncState(Checkpoint & cp);
+};
+
+class OnOffInjectionProcess : public InjectionProcess {
+protected:
   double _alpha;
   double _beta;
   double _r1;
@@ -63,6 +86,25 @@ public:
 			double r1, vector<int> initial);
   virtual void reset();
   virtual bool test(int source);
+  virtual void SyncState(Checkpoint & cp);
+};
+
+// On/off process that samples how long each source stays in its current 
+// state, and the gaps between packets while on, instead of flipping coins 
+// every cycle
+class OnOffGeometricInjectionProcess : public OnOffInjectionProcess {
+private:
+  vector<int> _gap;
+  int _SampleGap(int source) const;
+public:
+  OnOffGeometricInjectionProcess(int nodes, double rate, double alpha, 
+				 double beta, double r1, vector<int> initial);
+  virtual void reset();
+  virtual bool test(int source);
+  virtual bool skip_ahead() const { return true; }
+  virtual int idle(int source) const;
+  virtual void skip(int source, int trials);
+  virtual void SyncState(Checkpoint & cp);
 };
 
 #endif 
@@ -35,11 +35,13 @@
  *
  */
 #include <sys/time.h>
+#include <unistd.h>
 
 #include <string>
 #include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <algorithm>
 
 
 
@@ -53,6 +55,7 @@
 #include "network.hpp"
 #include "injection.hpp"
 #include "power_module.hpp"
+#include "thread_pool.hpp"
 
 
 
@@ -60,42 +63,45 @@
 //Global declarations
 //////////////////////
 
- /* the current traffic manager instance */
-TrafficManager * trafficManager = NULL;
-
 int GetSimTime() {
-  return trafficManager->getTime();
+  return gContext->traffic_manager->getTime();
 }
 
 class Stats;
 Stats * GetStats(const std::string & name) {
-  Stats* test =  trafficManager->getStats(name);
+  Stats* test =  gContext->traffic_manager->getStats(name);
   if(test == 0){
-    cout<<"warning statistics "<<name<<" not found"<<endl;
+    *gContext->out<<"warning statistics "<<name<<" not found"<<endl;
   }
   return test;
 }
 
-/* printing activity factor*/
-bool gPrintActivity;
-
-int gK;//radix
-int gN;//dimension
-int gC;//concentration
-
-int gNodes;
-
-//generate nocviewer trace
-bool gTrace;
-
-ostream * gWatchOut;
+/////////////////////////////////////////////////////////////////////////////
 
+bool Simulate( BookSimConfig const & config, ostream & out = cout )
+{
+  // everything below is bound to this simulation's context, so that 
+  // independent simulations may run on other threads
+  SimulationContext context;
+  SimulationContextScope scope( &context );
+  context.out = &out;
 
+  /*initialize routing, traffic, injection functions
+   */
+  InitializeRoutingMap( config );
 
-/////////////////////////////////////////////////////////////////////////////
+  context.print_activity = (config.GetInt("print_activity") > 0);
+  context.trace = (config.GetInt("viewer_trace") > 0);
+  
+  string watch_out_file = config.GetStr( "watch_out" );
+  if(watch_out_file == "") {
+    context.watch_out = NULL;
+  } else if(watch_out_file == "-") {
+    context.watch_out = &cout;
+  } else {
+    context.watch_out = new ofstream(watch_out_file.c_str());
+  }
 
-bool Simulate( BookSimConfig const & config )
-{
   vector<Network *> net;
 
   int subnets = config.GetInt("subnets");
@@ -113,8 +119,8 @@ bool Simulate( BookSimConfig const & config )
    *not sure how to use them 
    */
 
-  assert(trafficManager == NULL);
-  trafficManager = TrafficManager::New( config, net ) ;
+  assert(context.traffic_manager == NULL);
+  context.traffic_manager = TrafficManager::New( config, net ) ;
 
   /*Start the simulation run
    */
@@ -124,14 +130,14 @@ bool Simulate( BookSimConfig const & config )
   total_time = 0.0;
   gettimeofday(&start_time, NULL);
 
-  bool result = trafficManager->Run() ;
+  bool result = context.traffic_manager->Run() ;
 
 
   gettimeofday(&end_time, NULL);
   total_time = ((double)(end_time.tv_sec) + (double)(end_time.tv_usec)/1000000.0)
             - ((double)(start_time.tv_sec) + (double)(start_time.tv_usec)/1000000.0);
 
-  cout<<"Total run time "<<total_time<<endl;
+  out<<"Total run time "<<total_time<<endl;
 
   for (int i=0; i<subnets; ++i) {
 
@@ -144,12 +150,223 @@ bool Simulate( BookSimConfig const & config )
     delete net[i];
   }
 
-  delete trafficManager;
-  trafficManager = NULL;
+  delete context.traffic_manager;
+  context.traffic_manager = NULL;
 
   return result;
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// Latency-throughput sweep (sim_type = sweep)
+//
+// Locates the saturation rate by first stepping the injection rate in 
+// increments of sweep_initial_step and then narrowing the interval 
+// between the highest stable and the lowest unstable rate down to 
+// sweep_minimum_step. Each round simulates as many candidate rates as 
+// there are sweep threads, each in its own simulation context; the 
+// results of all stable points form the latency-throughput curve.
+/////////////////////////////////////////////////////////////////////////////
+
+struct SweepPoint {
+  SweepPoint( ) : rate( 0.0 ), stable( false ), latency( 0.0 ) { }
+  double rate;
+  bool stable;
+  double latency; // average packet latency of class 0
+  vector<string> results; // overall statistics of each class, as CSV
+};
+
+struct SweepRound {
+  BookSimConfig const * config;
+  vector<SweepPoint> * points;
+  int threads;
+};
+
+static void SimulateSweepPoint( BookSimConfig const & base, SweepPoint & p )
+{
+  BookSimConfig config( base );
+  ostringstream rate;
+  rate.precision( 12 );
+  rate << p.rate;
+  config.Assign( "injection_rate", rate.str( ) );
+  config.Assign( "sim_type", string( "latency" ) );
+  config.Assign( "print_csv_results", 1 );
+  // the sweep already runs its points in parallel, on threads
+  config.Assign( "fork_sims", 0 );
+
+  ostringstream log;
+  p.stable = Simulate( config, log );
+  p.latency = 0.0;
+  p.results.clear( );
+
+  istringstream lines( log.str( ) );
+  string line;
+  while ( getline( lines, line ) ) {
+    if ( line.compare( 0, 8, "results:" ) == 0 ) {
+      p.results.push_back( line.substr( 8 ) );
+    }
+  }
+  if ( p.results.empty( ) ) {
+    p.stable = false;
+  } else {
+    // fields: class, traffic, use_read_write, load, min/avg/max latency, ...
+    istringstream fields( p.results[0] );
+    string field;
+    for ( int i = 0; i <= 5; ++i ) {
+      getline( fields, field, ',' );
+    }
+    p.latency = atof( field.c_str( ) );
+  }
+}
+
+static void SweepTask( void * arg, int thread )
+{
+  SweepRound * const round = static_cast<SweepRound *>( arg );
+  for ( size_t i = thread; i < round->points->size( ); i += round->threads ) {
+    SimulateSweepPoint( *round->config, (*round->points)[i] );
+  }
+}
+
+static bool SweepRateLess( SweepPoint const & a, SweepPoint const & b )
+{
+  return a.rate < b.rate;
+}
+
+bool Sweep( BookSimConfig const & config )
+{
+  int threads = config.GetInt( "sweep_threads" );
+  if ( threads <= 0 ) {
+    threads = max( (int)sysconf( _SC_NPROCESSORS_ONLN ), 1 );
+  }
+  double const initial_step = config.GetFloat( "sweep_initial_step" );
+  double const minimum_step = config.GetFloat( "sweep_minimum_step" );
+  double const max_rate = config.GetFloat( "sweep_max_rate" );
+  if ( ( initial_step <= 0.0 ) || ( minimum_step <= 0.0 ) ) {
+    cerr << "Sweep step sizes must be positive." << endl;
+    exit( -1 );
+  }
+
+  // each task is a whole simulation, so idle threads block
+  ThreadPool pool( threads, true );
+  vector<SweepPoint> all;
+
+  cout << "SWEEP: Using " << threads << " thread(s)." << endl;
+
+  // lo is the highest rate known to be stable, hi the lowest rate known 
+  // (or assumed, for max_rate) to be unstable
+  double lo = 0.0;
+  double hi = -1.0;
+  double next = initial_step;
+  bool first = true;
+
+  while ( true ) {
+    vector<SweepPoint> points;
+    if ( first ) {
+      SweepPoint p;
+      p.rate = config.GetFloat( "sweep_zero_load_rate" );
+      points.push_back( p );
+    }
+    if ( hi < 0.0 ) {
+      // coarse steps until the first unstable rate
+      while ( ( (int)points.size( ) < threads ) && 
+	      ( next <= max_rate + 1e-9 ) ) {
+	SweepPoint p;
+	p.rate = next;
+	points.push_back( p );
+	next += initial_step;
+      }
+    } else {
+      // split the remaining interval evenly among the threads
+      int const n = min( threads, (int)( ( hi - lo ) / minimum_step ) );
+      for ( int i = 1; i <= n; ++i ) {
+	SweepPoint p;
+	p.rate = lo + ( hi - lo ) * i / ( n + 1 );
+	points.push_back( p );
+      }
+    }
+    if ( points.empty( ) ) {
+      break;
+    }
+
+    SweepRound round;
+    round.config = &config;
+    round.points = &points;
+    round.threads = threads;
+    pool.Run( &SweepTask, &round );
+
+    sort( points.begin( ), points.end( ), SweepRateLess );
+    bool failed = false;
+    for ( size_t i = 0; i < points.size( ); ++i ) {
+      SweepPoint const & p = points[i];
+      cout << "SWEEP: Injection rate " << p.rate << ": ";
+      if ( p.stable ) {
+	cout << "latency " << p.latency << endl;
+      } else {
+	cout << "unstable" << endl;
+      }
+      if ( first && ( i == 0 ) ) {
+	if ( !p.stable ) {
+	  cout << "SWEEP: Simulation at zero load failed." << endl;
+	  return false;
+	}
+	cout << "SWEEP: Zero-load latency is " << p.latency << "." << endl;
+	lo = max( lo, p.rate );
+      } else if ( !failed && p.stable ) {
+	lo = max( lo, p.rate );
+      } else if ( !failed ) {
+	failed = true;
+	hi = p.rate;
+      }
+      all.push_back( p );
+    }
+    first = false;
+
+    if ( ( hi < 0.0 ) && ( next > max_rate + 1e-9 ) ) {
+      cout << "SWEEP: Stable up to the maximum rate of " << max_rate 
+	   << "." << endl;
+      break;
+    }
+    if ( ( hi >= 0.0 ) && ( hi - lo < 2.0 * minimum_step ) ) {
+      break;
+    }
+  }
+
+  cout << "SWEEP: Parameter sweep complete." << endl;
+  cout << "SWEEP: Saturation throughput: " << lo << endl;
+
+  string const csv_file = config.GetStr( "sweep_csv" );
+  ofstream csv_stream;
+  if ( !csv_file.empty( ) && ( csv_file != "-" ) ) {
+    csv_stream.open( csv_file.c_str( ) );
+    if ( !csv_stream ) {
+      cerr << "Could not open sweep output file " << csv_file << endl;
+      exit( -1 );
+    }
+  }
+  ostream & csv = csv_stream.is_open( ) ? csv_stream : cout;
+  sort( all.begin( ), all.end( ), SweepRateLess );
+  csv << "rate,class,traffic,use_read_write,load,"
+      << "min_plat,avg_plat,max_plat,min_nlat,avg_nlat,max_nlat,"
+      << "min_flat,avg_flat,max_flat,min_frag,avg_frag,max_frag,"
+      << "min_sent_packets,avg_sent_packets,max_sent_packets,"
+      << "min_accepted_packets,avg_accepted_packets,max_accepted_packets,"
+      << "min_sent,avg_sent,max_sent,min_accepted,avg_accepted,max_accepted,"
+      << "avg_sent_packet_size,avg_accepted_packet_size,hops";
+  vector<double> const percentiles = config.GetFloatArray( "latency_percentiles" );
+  char const * const latencies[] = { "plat", "nlat", "flat" };
+  for ( int l = 0; l < 3; ++l ) {
+    for ( size_t i = 0; i < percentiles.size( ); ++i ) {
+      csv << ",p" << percentiles[i] << '_' << latencies[l];
+    }
+  }
+  csv << endl;
+  for ( size_t i = 0; i < all.size( ); ++i ) {
+    for ( size_t j = 0; j < all[i].results.size( ); ++j ) {
+      csv << all[i].rate << ',' << all[i].results[j] << endl;
+    }
+  }
+  return true;
+}
+
 
 int main( int argc, char **argv )
 {
@@ -162,26 +379,13 @@ int main( int argc, char **argv )
     return 0;
  } 
 
-  
-  /*initialize routing, traffic, injection functions
+  /*configure and run the simulator
    */
-  InitializeRoutingMap( config );
-
-  gPrintActivity = (config.GetInt("print_activity") > 0);
-  gTrace = (config.GetInt("viewer_trace") > 0);
-  
-  string watch_out_file = config.GetStr( "watch_out" );
-  if(watch_out_file == "") {
-    gWatchOut = NULL;
-  } else if(watch_out_file == "-") {
-    gWatchOut = &cout;
+  bool result;
+  if ( config.GetStr( "sim_type" ) == "sweep" ) {
+    result = Sweep( config );
   } else {
-    gWatchOut = new ofstream(watch_out_file.c_str());
+    result = Simulate( config );
   }
-  
-
-  /*configure and run the simulator
-   */
-  bool result = Simulate( config );
   return result ? -1 : 0;
 }
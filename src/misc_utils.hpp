@@ -31,4 +31,7 @@
 int log_two( int x );
 int powi( int x, int y );
 
+// p-quantile of Student's t distribution with the given degrees of freedom
+double student_t_quantile( double p, int dof );
+
 #endif 
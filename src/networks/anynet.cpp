@@ -45,35 +45,138 @@
  *other notes:
  *
  *Router and node numbers must be sequential starting with 0
+ *A latency following a node sets its injection and ejection latency, a latency
+ * following a router sets the latency of the channel towards that router
  *Credit channel latency follows the channel latency, even though it travels in revse
  * direction this might not be desired
+ *Routing follows the paths of minimal total channel latency; min_anynet always takes
+ * the lowest-numbered port among equal-cost next hops, ecmp_anynet the least loaded one
  *
  */
 
 #include "anynet.hpp"
+#include "thread_pool.hpp"
+#include "random_utils.hpp"
 #include <fstream>
 #include <sstream>
 #include <limits>
 #include <algorithm>
-//this is a hack, I can't easily get the routing talbe out of the network
-map<int, int>* global_routing_table;
+#include <queue>
+#include <functional>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+
+// identifies the cache file format; bump the version whenever the layout 
+// or the way links and routes are derived from the network file changes
+char const ANYNET_CACHE_MAGIC[8] = {'B','S','A','N','Y','N','E','T'};
+int const ANYNET_CACHE_VERSION = 2;
+
+// the cache file is this header followed by the arrays _node_router, 
+// _node_latency, _node_port, _router_node_begin, _router_node, 
+// _link_begin, _link_dest, _link_latency, _route_begin and _route_port
+struct sCacheHeader {
+  char magic[8];
+  int version;
+  int nodes;
+  unsigned long long key;
+  int size;
+  int channels;
+  int routes;
+  int pad;
+};
+
+// whether the count + 1 offsets start at 0, never decrease and end at last
+bool ValidOffsets( int const * offsets, long long count, long long last )
+{
+  if ( offsets[0] != 0 || offsets[count] != last ) {
+    return false;
+  }
+  for ( long long i = 0; i < count; i++ ) {
+    if ( offsets[i] > offsets[i+1] ) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// whether all count values lie in [low, high)
+bool ValidValues( int const * values, long long count, int low, int high )
+{
+  for ( long long i = 0; i < count; i++ ) {
+    if ( values[i] < low || values[i] >= high ) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// FNV-1a hash of the network file
+unsigned long long HashContents( string const & contents )
+{
+  unsigned long long h = 14695981039346656037ULL;
+  for(size_t i = 0; i < contents.size(); i++){
+    h ^= (unsigned char)contents[i];
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+// router-to-router link as read from the file; links implied by a link in 
+// the opposite direction are not given and only have the default latency
+struct sLink {
+  int src;
+  int dest;
+  int latency;
+  bool given;
+  int order;
+};
+
+bool LinkLess( sLink const & a, sLink const & b )
+{
+  if ( a.src != b.src ) {
+    return a.src < b.src;
+  }
+  if ( a.dest != b.dest ) {
+    return a.dest < b.dest;
+  }
+  return a.order < b.order;
+}
+
+// state shared by the threads computing the routing table
+struct sRouteJob {
+  AnyNet * net;
+  vector<int> rlink_begin;  // links entering each router, by source
+  vector<int> rlink_src;
+  vector<int> rlink_latency;
+  bool uniform;             // all links have the same latency
+  volatile int next;        // next destination router to route
+  vector<vector<int> > ports; // next-hop ports, per destination router
+};
+
+}
 
 AnyNet::AnyNet( const Configuration &config, const string & name )
-  :  Network( config, name ){
+  :  Network( config, name ), _route_begin_ptr( NULL ), _route_port_ptr( NULL ),
+     _cache_key( 0 ), _cache_map( NULL ), _cache_size( 0 ){
 
-  router_list.resize(2);
   _ComputeSize( config );
   _Alloc( );
   _BuildNet( config );
 }
 
 AnyNet::~AnyNet(){
-  for(int i = 0; i < 2; ++i) {
-    for(map<int, map<int, pair<int,int> > >::iterator iter = router_list[i].begin();
-	iter != router_list[i].end();
-	++iter) {
-      iter->second.clear();
-    }
+  if(gContext->anynet == this){
+    gContext->anynet = NULL;
+  }
+  if(_cache_map){
+    munmap(_cache_map, _cache_size);
   }
 }
 
@@ -83,238 +186,319 @@ void AnyNet::_ComputeSize( const Configuration &config ){
     cout<<"No network file name provided"<<endl;
     exit(-1);
   }
+  _cache_name = config.GetStr("anynet_cache");
   //parse the network description file
   readFile();
 
-  _channels =0;
-  cout<<"========================Network File Parsed=================\n";
-  cout<<"******************node listing**********************\n";
-  map<int,  int >::iterator iter;
-  for(iter = node_list.begin(); iter!=node_list.end(); iter++){
-    cout<<"Node "<<iter->first;
-    cout<<"\tRouter "<<iter->second<<endl;
-  }
-
-  map<int,   map<int, pair<int,int> > >::iterator iter3;
-  cout<<"\n****************router to node listing*************\n";
-  for(iter3 = router_list[0].begin(); iter3!=router_list[0].end(); iter3++){
-    cout<<"Router "<<iter3->first<<endl;
-    map<int, pair<int,int> >::iterator iter2;
-    for(iter2 = iter3->second.begin(); 
-	iter2!=iter3->second.end(); 
-	iter2++){
-      cout<<"\t Node "<<iter2->first<<" lat "<<iter2->second.second<<endl;
+  _size = _link_begin.size() - 1;
+  _nodes = _node_router.size();
+  _channels = _link_dest.size();
+
+  *gContext->out<<"========================Network File Parsed=================\n";
+  *gContext->out<<"******************node listing**********************\n";
+  for(int n = 0; n < _nodes; n++){
+    *gContext->out<<"Node "<<n;
+    *gContext->out<<"\tRouter "<<_node_router[n]<<endl;
+  }
+
+  *gContext->out<<"\n****************router to node listing*************\n";
+  for(int r = 0; r < _size; r++){
+    *gContext->out<<"Router "<<r<<endl;
+    for(int i = _router_node_begin[r]; i < _router_node_begin[r+1]; i++){
+      int const n = _router_node[i];
+      *gContext->out<<"\t Node "<<n<<" lat "<<_node_latency[n]<<endl;
     }
   }
 
-  cout<<"\n*****************router to router listing************\n";
-  for(iter3 = router_list[1].begin(); iter3!=router_list[1].end(); iter3++){
-    cout<<"Router "<<iter3->first<<endl;
-    map<int, pair<int,int> >::iterator iter2;
-    if(iter3->second.size() == 0){
-      cout<<"Caution Router "<<iter3->first
+  *gContext->out<<"\n*****************router to router listing************\n";
+  for(int r = 0; r < _size; r++){
+    *gContext->out<<"Router "<<r<<endl;
+    if(_link_begin[r] == _link_begin[r+1]){
+      *gContext->out<<"Caution Router "<<r
 	  <<" is not connected to any other Router\n"<<endl;
     }
-    for(iter2 = iter3->second.begin(); 
-	iter2!=iter3->second.end(); 
-	iter2++){
-      cout<<"\t Router "<<iter2->first<<" lat "<<iter2->second.second<<endl;
-      _channels++;
+    for(int l = _link_begin[r]; l < _link_begin[r+1]; l++){
+      *gContext->out<<"\t Router "<<_link_dest[l]<<" lat "<<_link_latency[l]<<endl;
     }
   }
-
-  _size = router_list[1].size();
-  _nodes = node_list.size();
-
 }
 
 
 
 void AnyNet::_BuildNet( const Configuration &config ){
-  
 
-  //I need to keep track the output ports for each router during build
-  int * outport = (int*)malloc(sizeof(int)*_size);
-  for(int i = 0; i<_size; i++){outport[i] = 0;}
-
-  cout<<"==========================Node to Router =====================\n";
+  *gContext->out<<"==========================Node to Router =====================\n";
   //adding the injection/ejection chanenls first
-  map<int,   map<int, pair<int,int> > >::iterator niter;
-  for(niter = router_list[0].begin(); niter!=router_list[0].end(); niter++){
-    map<int,   map<int, pair<int,int> > >::iterator riter = router_list[1].find(niter->first);
+  for(int r = 0; r < _size; r++){
+    int const nodes = _router_node_begin[r+1] - _router_node_begin[r];
     //calculate radix
-    int radix = niter->second.size()+riter->second.size();
-    int node = niter->first;
-    cout<<"router "<<node<<" radix "<<radix<<endl;
+    int radix = nodes + _link_begin[r+1] - _link_begin[r];
+    *gContext->out<<"router "<<r<<" radix "<<radix<<endl;
     //decalre the routers 
     ostringstream router_name;
     router_name << "router";
-    router_name << "_" <<  node ;
-    _routers[node] = Router::NewRouter( config, this, router_name.str( ), 
-    					node, radix, radix );
-    _timed_modules.push_back(_routers[node]);
+    router_name << "_" <<  r ;
+    _routers[r] = Router::NewRouter( config, this, router_name.str( ), 
+				     r, radix, radix );
+    _timed_modules.push_back(_routers[r]);
     //add injeciton ejection channels
-    map<int, pair<int,int> >::iterator nniter;
-    for(nniter = niter->second.begin();nniter!=niter->second.end(); nniter++){
-      int link = nniter->first;
-      //add the outport port assined to the map
-      (niter->second)[link].first = outport[node];
-      outport[node]++;
-      cout<<"\t connected to node "<<link<<" at outport "<<nniter->second.first
-	  <<" lat "<<nniter->second.second<<endl;
-      _inject[link]->SetLatency(nniter->second.second);
-      _inject_cred[link]->SetLatency(nniter->second.second);
-      _eject[link]->SetLatency(nniter->second.second);
-      _eject_cred[link]->SetLatency(nniter->second.second);
-
-      _routers[node]->AddInputChannel( _inject[link], _inject_cred[link] );
-      _routers[node]->AddOutputChannel( _eject[link], _eject_cred[link] );
+    for(int i = _router_node_begin[r]; i < _router_node_begin[r+1]; i++){
+      int link = _router_node[i];
+      int lat = _node_latency[link];
+      *gContext->out<<"\t connected to node "<<link<<" at outport "<<_node_port[link]
+	  <<" lat "<<lat<<endl;
+      _inject[link]->SetLatency(lat);
+      _inject_cred[link]->SetLatency(lat);
+      _eject[link]->SetLatency(lat);
+      _eject_cred[link]->SetLatency(lat);
+
+      _routers[r]->AddInputChannel( _inject[link], _inject_cred[link] );
+      _routers[r]->AddOutputChannel( _eject[link], _eject_cred[link] );
     }
-
   }
 
-  cout<<"==========================Router to Router =====================\n";
+  *gContext->out<<"==========================Router to Router =====================\n";
   //add inter router channels
-  //since there is no way to systematically number the channels we just start from 0
-  //the map, is a mapping of output->input
-  int channel_count = 0; 
-  for(niter = router_list[0].begin(); niter!=router_list[0].end(); niter++){
-    map<int,   map<int, pair<int,int> > >::iterator riter = router_list[1].find(niter->first);
-    int node = niter->first;
-    map<int, pair<int,int> >::iterator rriter;
-    cout<<"router "<<node<<endl;
-    for(rriter = riter->second.begin();rriter!=riter->second.end(); rriter++){
-      int other_node = rriter->first;
-      int link = channel_count;
-      //add the outport port assined to the map
-      (riter->second)[other_node].first = outport[node];
-      outport[node]++;
-      cout<<"\t connected to router "<<other_node<<" using link "<<link
-	  <<" at outport "<<rriter->second.first
-	  <<" lat "<<rriter->second.second<<endl;
-
-      _chan[link]->SetLatency(rriter->second.second);
-      _chan_cred[link]->SetLatency(rriter->second.second);
-
-      _routers[node]->AddOutputChannel( _chan[link], _chan_cred[link] );
+  //channels are numbered in the order of the links, which is also the 
+  //order of the output ports of each router
+  for(int r = 0; r < _size; r++){
+    int const nodes = _router_node_begin[r+1] - _router_node_begin[r];
+    *gContext->out<<"router "<<r<<endl;
+    for(int link = _link_begin[r]; link < _link_begin[r+1]; link++){
+      int other_node = _link_dest[link];
+      *gContext->out<<"\t connected to router "<<other_node<<" using link "<<link
+	  <<" at outport "<<nodes + link - _link_begin[r]
+	  <<" lat "<<_link_latency[link]<<endl;
+
+      _chan[link]->SetLatency(_link_latency[link]);
+      _chan_cred[link]->SetLatency(_link_latency[link]);
+
+      _routers[r]->AddOutputChannel( _chan[link], _chan_cred[link] );
       _routers[other_node]->AddInputChannel( _chan[link], _chan_cred[link]);
-      channel_count++;
     }
   }
 
-  buildRoutingTable();
+  if(!_cache_map){
+    buildRoutingTable( config );
+    if(_cache_name != ""){
+      _SaveCache();
+    }
+  }
+  gContext->anynet = this;
 
 }
 
 
 void AnyNet::RegisterRoutingFunctions() {
-  gRoutingFunctionMap["min_anynet"] = &min_anynet;
+  gContext->routing_function_map["min_anynet"] = &min_anynet;
+  gContext->routing_function_map["ecmp_anynet"] = &ecmp_anynet;
+}
+
+static void anynet_vcs( const Flit *f, int & vcBegin, int & vcEnd )
+{
+  vcBegin = 0, vcEnd = gContext->num_vcs-1;
+  if ( f->type == Flit::READ_REQUEST ) {
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd   = gContext->read_req_end_vc;
+  } else if ( f->type == Flit::WRITE_REQUEST ) {
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd   = gContext->write_req_end_vc;
+  } else if ( f->type ==  Flit::READ_REPLY ) {
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd   = gContext->read_reply_end_vc;
+  } else if ( f->type ==  Flit::WRITE_REPLY ) {
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd   = gContext->write_reply_end_vc;
+  }
 }
 
 void min_anynet( const Router *r, const Flit *f, int in_channel, 
 		 OutputSet *outputs, bool inject ){
   int out_port=-1;
   if(!inject){
-    assert(global_routing_table[r->GetID()].count(f->dest)!=0);
-    out_port=global_routing_table[r->GetID()][f->dest];
+    int const * begin;
+    int const * end;
+    gContext->anynet->NextPorts(r->GetID(), f->dest, begin, end);
+    assert(begin != end);
+    out_port = *begin;
   }
- 
 
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd   = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd   = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd   = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd   = gWriteReplyEndVC;
-  }
+  int vcBegin, vcEnd;
+  anynet_vcs( f, vcBegin, vcEnd );
 
   outputs->Clear( );
 
   outputs->AddRange( out_port , vcBegin, vcEnd );
 }
 
-void AnyNet::buildRoutingTable(){
-  cout<<"========================== Routing table  =====================\n";  
-  routing_table.resize(_size);
-  for(int i = 0; i<_size; i++){
-    route(i);
+// adaptive among the equal-cost next hops: takes the one with the fewest 
+// used credits, breaking ties at random
+void ecmp_anynet( const Router *r, const Flit *f, int in_channel, 
+		  OutputSet *outputs, bool inject ){
+  int out_port=-1;
+  if(!inject){
+    int const * begin;
+    int const * end;
+    gContext->anynet->NextPorts(r->GetID(), f->dest, begin, end);
+    assert(begin != end);
+    out_port = *begin;
+    if(end - begin > 1){
+      int min_credit = numeric_limits<int>::max();
+      int ties = 0;
+      for(int const * p = begin; p != end; ++p){
+	int const credit = r->GetUsedCredit(*p);
+	if(credit < min_credit){
+	  min_credit = credit;
+	  out_port = *p;
+	  ties = 1;
+	} else if(credit == min_credit){
+	  ++ties;
+	  if(RandomInt(ties - 1) == 0){
+	    out_port = *p;
+	  }
+	}
+      }
+    }
   }
-  global_routing_table = &routing_table[0];
+
+  int vcBegin, vcEnd;
+  anynet_vcs( f, vcBegin, vcEnd );
+
+  outputs->Clear( );
+
+  outputs->AddRange( out_port , vcBegin, vcEnd );
 }
 
+void AnyNet::buildRoutingTable( const Configuration &config ){
+  *gContext->out<<"========================== Routing table  =====================\n";  
 
-//11/7/2012
-//basically djistra's, tested on a large dragonfly anynet configuration
-void AnyNet::route(int r_start){
-  int* dist = new int[_size];
-  int* prev = new int[_size];
-  set<int> rlist;
-  for(int i = 0; i<_size; i++){
-    dist[i] =  numeric_limits<int>::max();
-    prev[i] = -1;
-    rlist.insert(i);
-  }
-  dist[r_start] = 0;
-  while(!rlist.empty()){
-    //find min 
-    int min_dist = numeric_limits<int>::max();
-    int min_cand = -1;
-    for(set<int>::iterator i = rlist.begin();
-	i!=rlist.end();
-	i++){
-      if(dist[*i]<min_dist){
-	min_dist = dist[*i];
-	min_cand = *i;
-      }
+  sRouteJob job;
+  job.net = this;
+  job.uniform = true;
+  for(int l = 1; l < _channels; l++){
+    job.uniform &= (_link_latency[l] == _link_latency[0]);
+  }
+
+  // links by the router they enter, for searching backwards from each 
+  // destination
+  job.rlink_begin.assign(_size + 1, 0);
+  for(int l = 0; l < _channels; l++){
+    job.rlink_begin[_link_dest[l] + 1]++;
+  }
+  for(int r = 0; r < _size; r++){
+    job.rlink_begin[r + 1] += job.rlink_begin[r];
+  }
+  job.rlink_src.resize(_channels);
+  job.rlink_latency.resize(_channels);
+  vector<int> fill(job.rlink_begin.begin(), job.rlink_begin.end() - 1);
+  for(int r = 0; r < _size; r++){
+    for(int l = _link_begin[r]; l < _link_begin[r+1]; l++){
+      int const i = fill[_link_dest[l]]++;
+      job.rlink_src[i] = r;
+      job.rlink_latency[i] = _link_latency[l];
     }
-    rlist.erase(min_cand);
-
-    //neighbor
-    for(map<int,pair<int,int> >::iterator i = router_list[1][min_cand].begin(); 
-	i!=router_list[1][min_cand].end(); 
-	i++){
-      int new_dist = dist[min_cand] + i->second.second;//distance is hops not cycles
-      if(new_dist < dist[i->first]){
-	dist[i->first] = new_dist;
-	prev[i->first] = min_cand;
-      }
+  }
+
+  job.next = 0;
+  job.ports.resize(_size);
+  _route_begin.assign((size_t)_size * _size + 1, 0);
+
+  int threads = config.GetInt("anynet_threads");
+  if(threads <= 0){
+    threads = max((int)sysconf(_SC_NPROCESSORS_ONLN), 1);
+  }
+  threads = min(threads, max(_size, 1));
+  {
+    ThreadPool pool(threads);
+    pool.Run(&AnyNet::_RouteTask, &job);
+  }
+
+  // _route_begin holds the number of ports of each entry so far
+  long long total = 0;
+  for(size_t i = 1; i < _route_begin.size(); i++){
+    total += _route_begin[i];
+    if(total > numeric_limits<int>::max()){
+      cout<<"Anynet:routing table too large"<<endl;
+      exit(-1);
     }
+    _route_begin[i] = total;
   }
-  
-  //post process from the prev list
-  for(int i = 0; i<_size; i++){
-    if(prev[i] ==-1){ //self
-      assert(i == r_start);
-      for(map<int, pair<int, int> >::iterator iter = router_list[0][i].begin();
-	  iter!=router_list[0][i].end();
-	  iter++){
-	routing_table[r_start][iter->first]=iter->second.first;
-	//cout<<"node "<<iter->first<<" port "<< iter->second.first<<endl;
+  _route_port.reserve(total);
+  for(int d = 0; d < _size; d++){
+    _route_port.insert(_route_port.end(), job.ports[d].begin(), job.ports[d].end());
+    vector<int>().swap(job.ports[d]);
+  }
+  _route_begin_ptr = &_route_begin[0];
+  _route_port_ptr = _route_port.empty() ? NULL : &_route_port[0];
+}
+
+// Each thread repeatedly takes the next destination router, finds the 
+// latency of the shortest path from every router to it by searching 
+// backwards (breadth-first if all links have the same latency), and 
+// records at every router all ports whose link lies on a shortest path.
+void AnyNet::_RouteTask( void * arg, int thread ){
+  sRouteJob & job = *static_cast<sRouteJob *>(arg);
+  AnyNet & net = *job.net;
+  int const size = net._size;
+  int const inf = numeric_limits<int>::max();
+
+  vector<int> dist(size);
+  vector<int> frontier;
+  frontier.reserve(size);
+  priority_queue<pair<int, int>, vector<pair<int, int> >, 
+		 greater<pair<int, int> > > heap;
+
+  for(int d = __sync_fetch_and_add(&job.next, 1); d < size; 
+      d = __sync_fetch_and_add(&job.next, 1)){
+
+    dist.assign(size, inf);
+    dist[d] = 0;
+    if(job.uniform){
+      frontier.clear();
+      frontier.push_back(d);
+      for(size_t head = 0; head < frontier.size(); head++){
+	int const v = frontier[head];
+	for(int l = job.rlink_begin[v]; l < job.rlink_begin[v+1]; l++){
+	  int const u = job.rlink_src[l];
+	  if(dist[u] == inf){
+	    dist[u] = dist[v] + job.rlink_latency[l];
+	    frontier.push_back(u);
+	  }
+	}
       }
     } else {
-      int distance=0;
-      int neighbor=i;
-      while(prev[neighbor]!=r_start){
-	assert(router_list[1][neighbor].count(prev[neighbor])>0);
-	distance+=router_list[1][prev[neighbor]][neighbor].second;//REVERSE lat
-	neighbor= prev[neighbor];
+      heap.push(make_pair(0, d));
+      while(!heap.empty()){
+	int const v = heap.top().second;
+	int const v_dist = heap.top().first;
+	heap.pop();
+	if(v_dist > dist[v]){
+	  continue;
+	}
+	for(int l = job.rlink_begin[v]; l < job.rlink_begin[v+1]; l++){
+	  int const u = job.rlink_src[l];
+	  int const u_dist = v_dist + job.rlink_latency[l];
+	  if(u_dist < dist[u]){
+	    dist[u] = u_dist;
+	    heap.push(make_pair(u_dist, u));
+	  }
+	}
       }
-      distance+=router_list[1][prev[neighbor]][neighbor].second;//lat
-
-      assert( router_list[1][r_start].count(neighbor)!=0);
-      int port = router_list[1][r_start][neighbor].first;
-      for(map<int, pair<int,int> >::iterator iter = router_list[0][i].begin();
-	  iter!=router_list[0][i].end();
-	  iter++){
-	routing_table[r_start][iter->first]=port;
-	//cout<<"node "<<iter->first<<" port "<< port<<" dist "<<distance<<endl;
+    }
+
+    vector<int> & ports = job.ports[d];
+    int * const count = &net._route_begin[(size_t)d * size + 1];
+    for(int r = 0; r < size; r++){
+      if((r == d) || (dist[r] == inf)){
+	continue;
+      }
+      int const nodes = net._router_node_begin[r+1] - net._router_node_begin[r];
+      for(int l = net._link_begin[r]; l < net._link_begin[r+1]; l++){
+	int const n = net._link_dest[l];
+	if((dist[n] != inf) && (dist[n] + net._link_latency[l] == dist[r])){
+	  ports.push_back(nodes + l - net._link_begin[r]);
+	  count[r]++;
+	}
       }
     }
   }
@@ -323,7 +507,26 @@ void AnyNet::route(int r_start){
 
 void AnyNet::readFile(){
 
-  ifstream network_list;
+  ifstream network_file(file_name.c_str(), ios::in | ios::binary);
+  if(!network_file.is_open()){
+    cout<<"Anynet:can't open network file "<<file_name<<endl;
+    exit(-1);
+  }
+  ostringstream buffer;
+  buffer<<network_file.rdbuf();
+  string const contents = buffer.str();
+
+  _cache_key = HashContents(contents);
+  if(_cache_name != "" && _LoadCache()){
+    *gContext->out<<"Anynet:loaded topology and routing table from "<<_cache_name<<endl;
+  } else {
+    parseFile(contents);
+  }
+}
+
+void AnyNet::parseFile( string const & contents ){
+
+  istringstream network_list(contents);
   string line;
   enum ParseState{HEAD_TYPE=0,
 		  HEAD_ID,
@@ -334,41 +537,40 @@ void AnyNet::readFile(){
 		 ROUTER,
 		 UNKNOWN};
 
-  network_list.open(file_name.c_str());
-  if(!network_list.is_open()){
-    cout<<"Anynet:can't open network file "<<file_name<<endl;
-    exit(-1);
-  }
-  
-  //loop through the entire file
-  while(!network_list.eof()){
-    getline(network_list,line);
-    if(line==""){
-      continue;
-    }
+  vector<sLink> links;
+  //router IDs that appeared in the file
+  vector<bool> routers;
+
+  //loop through the entire file, one line and one token at a time
+  while(getline(network_list,line)){
 
     ParseState state=HEAD_TYPE;
-    //position to parse out white sspace
-    int pos = 0;
-    int next_pos=-1;
-    string temp;
     //the first node and its type
     int head_id = -1;
     ParseType head_type = UNKNOWN;
     //stuff that head are linked to
     ParseType body_type = UNKNOWN;
     int body_id = -1;
-    int link_weight = 1;
+    //node whose latency a link weight sets, if the last link was to a node
+    int weight_node = -1;
+    //given link whose latency a link weight sets, if it was to a router
+    int weight_link = -1;
 
-    do{
+    char const * pos = line.c_str();
+    while(true){
 
       //skip empty spaces
-      next_pos = line.find(" ",pos);
-      temp = line.substr(pos,next_pos-pos);
-      pos = next_pos+1;
-      if(temp=="" || temp==" "){
-	continue;
+      while(*pos == ' ' || *pos == '\t' || *pos == '\r'){
+	pos++;
+      }
+      if(*pos == '\0'){
+	break;
+      }
+      char const * const start = pos;
+      while(*pos != '\0' && *pos != ' ' && *pos != '\t' && *pos != '\r'){
+	pos++;
       }
+      string const temp(start, pos - start);
 
       switch(state){
       case HEAD_TYPE:
@@ -378,22 +580,22 @@ void AnyNet::readFile(){
 	  head_type = NODE;
 	} else {
 	  cout<<"Anynet:Unknow head of line type "<<temp<<"\n";
-	  assert(false);
+	  exit(-1);
 	}
 	state=HEAD_ID;
 	break;
       case HEAD_ID:
-	//need better error check
 	head_id = atoi(temp.c_str());
-
-	//intialize router structures
-	if(router_list[NODE].count(head_id) == 0){
-	  router_list[NODE][head_id] = map<int, pair<int,int> >();
+	if(head_id < 0){
+	  cout<<"Anynet:Invalid ID "<<temp<<"\n";
+	  exit(-1);
+	}
+	if(head_type==ROUTER){
+	  if((int)routers.size() <= head_id){
+	    routers.resize(head_id + 1, false);
+	  }
+	  routers[head_id] = true;
 	}
-	if(router_list[ROUTER].count(head_id) == 0){
-	  router_list[ROUTER][head_id] = map<int, pair<int,int> >();
-	}  
-
 	state=BODY_TYPE;
 	break;
       case LINK_WEIGHT:
@@ -401,8 +603,12 @@ void AnyNet::readFile(){
 	   temp == "node"){
 	  //ignore
 	} else {
-	  link_weight= atoi(temp.c_str());
-	  router_list[head_type][head_id][body_id].second=link_weight;
+	  int const link_weight = atoi(temp.c_str());
+	  if(weight_node >= 0){
+	    _node_latency[weight_node] = link_weight;
+	  } else {
+	    links[weight_link].latency = link_weight;
+	  }
 	  break;
 	}
 	//intentionally letting it flow through
@@ -413,89 +619,276 @@ void AnyNet::readFile(){
 	  body_type = NODE;
 	} else {
 	  cout<<"Anynet:Unknow body type "<<temp<<"\n";
-	  assert(false);
+	  exit(-1);
 	}
 	state=BODY_ID;
 	break;
       case BODY_ID:
-	body_id = atoi(temp.c_str());	
-	//intialize router structures if necessary
+	body_id = atoi(temp.c_str());
+	if(body_id < 0){
+	  cout<<"Anynet:Invalid ID "<<temp<<"\n";
+	  exit(-1);
+	}
 	if(body_type==ROUTER){
-	  if(router_list[NODE].count(body_id) ==0){
-	    router_list[NODE][body_id] = map<int, pair<int,int> >();
-	  }
-	  if(router_list[ROUTER].count(body_id) == 0){
-	    router_list[ROUTER][body_id] = map<int, pair<int,int> >();
+	  if((int)routers.size() <= body_id){
+	    routers.resize(body_id + 1, false);
 	  }
+	  routers[body_id] = true;
 	}
 
 	if(head_type==NODE && body_type==NODE){ 
 
 	  cout<<"Anynet:Cannot connect node to node "<<temp<<"\n";
-	  assert(false);
+	  exit(-1);
+
+	} else if(head_type==ROUTER && body_type==ROUTER){
+
+	  sLink link;
+	  link.src = head_id;
+	  link.dest = body_id;
+	  link.latency = 1;
+	  link.given = true;
+	  link.order = links.size();
+	  weight_link = links.size();
+	  links.push_back(link);
+	  //the channel back defaults to a single cycle
+	  link.src = body_id;
+	  link.dest = head_id;
+	  link.given = false;
+	  link.order = links.size();
+	  links.push_back(link);
+	  weight_node = -1;
 
-	} else if(head_type==NODE && body_type==ROUTER){
+	} else {
 
-	  if(node_list.count(head_id)!=0 &&
-	     node_list[head_id]!=body_id){
-	    cout<<"Anynet:Node "<<body_id<<" trying to connect to multiple router "
-		<<body_id<<" and "<<node_list[head_id]<<endl;
-	    assert(false);
+	  int const node = (head_type==NODE) ? head_id : body_id;
+	  int const router = (head_type==NODE) ? body_id : head_id;
+	  if((int)_node_router.size() <= node){
+	    _node_router.resize(node + 1, -1);
+	    _node_latency.resize(node + 1, 1);
 	  }
-	  node_list[head_id]=body_id;
-	  router_list[NODE][body_id][head_id]=pair<int, int>(-1,1);
-
-	} else if(head_type==ROUTER && body_type==NODE){
-	  //insert and check node
-	  if(node_list.count(body_id) != 0 &&
-	     node_list[body_id]!=head_id){
-	    cout<<"Anynet:Node "<<body_id<<" trying to connect to multiple router "
-		<<body_id<<" and "<<node_list[head_id]<<endl;
-	    assert(false);
+	  if(_node_router[node] >= 0 && _node_router[node] != router){
+	    cout<<"Anynet:Node "<<node<<" trying to connect to multiple router "
+		<<router<<" and "<<_node_router[node]<<endl;
+	    exit(-1);
 	  }
-	  node_list[body_id] = head_id;
-	  router_list[NODE][head_id][body_id]=pair<int, int>(-1,1);
+	  _node_router[node] = router;
+	  _node_latency[node] = 1;
+	  weight_node = node;
 
-	} else if(head_type==ROUTER && body_type==ROUTER){
-	  router_list[ROUTER][head_id][body_id]=pair<int, int>(-1,1);
-	  if(router_list[ROUTER][body_id].count(head_id)==0){
-	    router_list[ROUTER][body_id][head_id]=pair<int, int>(-1,1);
-	  }
 	}
 	state=LINK_WEIGHT;
 	break ;
       default:
 	cout<<"Anynet:Unknow parse state\n";
-	assert(false);
+	exit(-1);
 	break;
       }
-
-    } while(pos!=0);
+    }
     if(state!=LINK_WEIGHT &&
-       state!=BODY_TYPE){
+       state!=BODY_TYPE &&
+       state!=HEAD_TYPE){
       cout<<"Anynet:Incomplete parse of the line: "<<line<<endl;
     }
-
   }
 
-  //map verification, make sure the information contained in both maps
-  //are the same
-  assert(router_list[0].size() == router_list[1].size());
-
   //traffic generator assumes node list is sequential and starts at 0
-  vector<int> node_check;
-  for(map<int,int>::iterator i = node_list.begin();
-      i!=node_list.end();
-      i++){
-    node_check.push_back(i->first);
-  }
-  sort(node_check.begin(), node_check.end());
-  for(size_t i = 0; i<node_check.size(); i++){
-    if((size_t)node_check[i] != i){
+  for(size_t n = 0; n < _node_router.size(); n++){
+    if(_node_router[n] < 0){
       cout<<"Anynet:booksim trafficmanager assumes sequential node numbering starting at 0\n";
-      assert(false);
+      exit(-1);
+    }
+  }
+  //and routers are stored by their ID
+  for(size_t r = 0; r < routers.size(); r++){
+    if(!routers[r]){
+      cout<<"Anynet:routers must be numbered sequentially starting at 0\n";
+      exit(-1);
+    }
+  }
+  for(size_t n = 0; n < _node_router.size(); n++){
+    if(_node_router[n] >= (int)routers.size()){
+      routers.resize(_node_router[n] + 1, false);
+      cout<<"Anynet:routers must be numbered sequentially starting at 0\n";
+      exit(-1);
+    }
+  }
+  int const size = routers.size();
+
+  //nodes of each router, in order of node ID, which is also the order of 
+  //their ports
+  _router_node_begin.assign(size + 1, 0);
+  for(size_t n = 0; n < _node_router.size(); n++){
+    _router_node_begin[_node_router[n] + 1]++;
+  }
+  for(int r = 0; r < size; r++){
+    _router_node_begin[r + 1] += _router_node_begin[r];
+  }
+  _router_node.resize(_node_router.size());
+  _node_port.resize(_node_router.size());
+  vector<int> fill(size, 0);
+  for(size_t n = 0; n < _node_router.size(); n++){
+    int const r = _node_router[n];
+    int const port = _node_port[n] = fill[r]++;
+    _router_node[_router_node_begin[r] + port] = n;
+  }
+
+  //links of each router, in order of the router they lead to; when a link 
+  //appears more than once, the last latency given for it counts
+  sort(links.begin(), links.end(), LinkLess);
+  _link_begin.assign(size + 1, 0);
+  _link_dest.clear();
+  _link_latency.clear();
+  for(size_t i = 0; i < links.size(); ){
+    size_t j = i;
+    int latency = 1;
+    for(; j < links.size() && links[j].src == links[i].src && 
+	  links[j].dest == links[i].dest; j++){
+      if(links[j].given){
+	latency = links[j].latency;
+      }
     }
+    _link_begin[links[i].src + 1]++;
+    _link_dest.push_back(links[i].dest);
+    _link_latency.push_back(latency);
+    i = j;
+  }
+  for(int r = 0; r < size; r++){
+    _link_begin[r + 1] += _link_begin[r];
   }
-  
 }
 
+// Maps the cache file and takes the topology from it if it was written for 
+// the same network file; the routing table is used in place.
+bool AnyNet::_LoadCache(){
+  int const fd = open(_cache_name.c_str(), O_RDONLY);
+  if(fd < 0){
+    return false;
+  }
+  struct stat st;
+  if(fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(sCacheHeader)){
+    close(fd);
+    return false;
+  }
+  size_t const file_size = st.st_size;
+  void * const map = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(map == MAP_FAILED){
+    return false;
+  }
+
+  sCacheHeader const & header = *static_cast<sCacheHeader const *>(map);
+  long long const size = header.size;
+  long long const words = 3LL * header.nodes + (size + 1) + header.nodes 
+    + (size + 1) + 2LL * header.channels + (size * size + 1) + header.routes;
+  if(memcmp(header.magic, ANYNET_CACHE_MAGIC, sizeof(header.magic)) ||
+     (header.version != ANYNET_CACHE_VERSION) ||
+     (header.key != _cache_key) ||
+     (header.nodes < 0) || (size < 0) || 
+     (header.channels < 0) || (header.routes < 0) ||
+     (file_size != sizeof(sCacheHeader) + words * sizeof(int))){
+    *gContext->out<<"Anynet:cache "<<_cache_name<<" does not match "<<file_name
+	<<", rebuilding it"<<endl;
+    munmap(map, file_size);
+    return false;
+  }
+
+  int const nodes = header.nodes;
+  int const * const node_router = reinterpret_cast<int const *>(&header + 1);
+  int const * const node_latency = node_router + nodes;
+  int const * const node_port = node_latency + nodes;
+  int const * const router_node_begin = node_port + nodes;
+  int const * const router_node = router_node_begin + size + 1;
+  int const * const link_begin = router_node + nodes;
+  int const * const link_dest = link_begin + size + 1;
+  int const * const link_latency = link_dest + header.channels;
+  int const * const route_begin = link_latency + header.channels;
+  int const * const route_port = route_begin + size * size + 1;
+
+  // the routing table is used in place, so a damaged file must not lead 
+  // to reads outside of it or to ports the routers do not have
+  bool valid = 
+    ValidValues(node_router, nodes, 0, size) &&
+    ValidOffsets(router_node_begin, size, nodes) &&
+    ValidValues(router_node, nodes, 0, nodes) &&
+    ValidOffsets(link_begin, size, header.channels) &&
+    ValidValues(link_dest, header.channels, 0, size) &&
+    ValidOffsets(route_begin, size * size, header.routes);
+  for(int n = 0; valid && n < nodes; n++){
+    int const r = node_router[n];
+    valid = (node_port[n] >= 0) && 
+      (node_port[n] < router_node_begin[r+1] - router_node_begin[r]);
+  }
+  for(long long i = 0; valid && i < size * size; i++){
+    int const r = i % size;
+    int const radix = router_node_begin[r+1] - router_node_begin[r] 
+      + link_begin[r+1] - link_begin[r];
+    valid = ValidValues(route_port + route_begin[i], 
+			route_begin[i+1] - route_begin[i], 0, radix);
+  }
+  if(!valid){
+    *gContext->out<<"Anynet:cache "<<_cache_name<<" is corrupt, rebuilding it"<<endl;
+    munmap(map, file_size);
+    return false;
+  }
+
+  int const * data = node_router;
+  _node_router.assign(data, data + nodes);
+  data += nodes;
+  _node_latency.assign(data, data + nodes);
+  data += nodes;
+  _node_port.assign(data, data + nodes);
+  data += nodes;
+  _router_node_begin.assign(data, data + size + 1);
+  data += size + 1;
+  _router_node.assign(data, data + nodes);
+  data += nodes;
+  _link_begin.assign(data, data + size + 1);
+  data += size + 1;
+  _link_dest.assign(data, data + header.channels);
+  data += header.channels;
+  _link_latency.assign(data, data + header.channels);
+  data += header.channels;
+  _route_begin_ptr = data;
+  data += size * size + 1;
+  _route_port_ptr = data;
+
+  _cache_map = map;
+  _cache_size = file_size;
+  return true;
+}
+
+// Writes the cache under a temporary name and renames it, so concurrent 
+// simulations never see a partial file.
+void AnyNet::_SaveCache() const {
+  sCacheHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, ANYNET_CACHE_MAGIC, sizeof(header.magic));
+  header.version = ANYNET_CACHE_VERSION;
+  header.key = _cache_key;
+  header.nodes = _nodes;
+  header.size = _size;
+  header.channels = _channels;
+  header.routes = _route_port.size();
+
+  ostringstream temp_name;
+  temp_name<<_cache_name<<".tmp."<<getpid()<<"."<<this;
+  ofstream cache(temp_name.str().c_str(), ios::out | ios::binary);
+  cache.write((char const *)&header, sizeof(header));
+  vector<int> const * const arrays[] = {
+    &_node_router, &_node_latency, &_node_port, &_router_node_begin,
+    &_router_node, &_link_begin, &_link_dest, &_link_latency,
+    &_route_begin, &_route_port
+  };
+  for(size_t i = 0; i < sizeof(arrays) / sizeof(arrays[0]); i++){
+    if(!arrays[i]->empty()){
+      cache.write((char const *)&(*arrays[i])[0], 
+		  arrays[i]->size() * sizeof(int));
+    }
+  }
+  cache.close();
+  if(cache.fail() || rename(temp_name.str().c_str(), _cache_name.c_str())){
+    *gContext->out<<"Anynet:could not write cache "<<_cache_name<<endl;
+    remove(temp_name.str().c_str());
+  }
+}
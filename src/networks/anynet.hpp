@@ -32,25 +32,54 @@
 #include "routefunc.hpp"
 #include <cassert>
 #include <string>
-#include <map>
-#include <list>
+#include <vector>
 
 class AnyNet : public Network {
 
   string file_name;
-  //associtation between  nodes and routers
-  map<int, int > node_list;
-  //[link type][src router][dest router]=(port, latency)
-  vector<map<int,  map<int, pair<int,int> > > > router_list;
-  //stores minimal routing information from every router to every node
-  //[router][dest_node]=port
-  vector<map<int, int> > routing_table;
+
+  // router and injection/ejection latency of each node
+  vector<int> _node_router;
+  vector<int> _node_latency;
+  // port at which each node is attached to its router; routers number 
+  // their node ports first, in order of node ID, then their router links
+  vector<int> _node_port;
+  // nodes attached to router r are [_router_node_begin[r], 
+  // _router_node_begin[r+1]) in _router_node
+  vector<int> _router_node_begin;
+  vector<int> _router_node;
+
+  // router-to-router links in compressed sparse row form: the links 
+  // leaving router r are [_link_begin[r], _link_begin[r+1]), in order of 
+  // the router they lead to
+  vector<int> _link_begin;
+  vector<int> _link_dest;
+  vector<int> _link_latency;
+
+  // all equal-cost next hops: the output ports of router r on shortest 
+  // paths to router d are _route_port[_route_begin[d*_size+r]] up to 
+  // _route_port[_route_begin[d*_size+r+1]-1], in increasing order
+  vector<int> _route_begin;
+  vector<int> _route_port;
+  // the routing table in use, either the vectors above or a mapped cache
+  int const * _route_begin_ptr;
+  int const * _route_port_ptr;
+
+  // optional on-disk cache of the parsed topology and routing table, 
+  // keyed by a hash of the network file
+  string _cache_name;
+  unsigned long long _cache_key;
+  void * _cache_map;
+  size_t _cache_size;
 
   void _ComputeSize( const Configuration &config );
   void _BuildNet( const Configuration &config );
   void readFile();
-  void buildRoutingTable();
-  void route(int r_start);
+  void parseFile( string const & contents );
+  bool _LoadCache();
+  void _SaveCache() const;
+  void buildRoutingTable( const Configuration &config );
+  static void _RouteTask( void * job, int thread );
 
 public:
   AnyNet( const Configuration &config, const string & name );
@@ -59,6 +88,20 @@ public:
   int GetN( ) const{ return -1;}
   int GetK( ) const{ return -1;}
 
+  // output ports of router r on shortest paths to node dest
+  inline void NextPorts( int r, int dest, int const * & begin, 
+			 int const * & end ) const {
+    int const d = _node_router[dest];
+    if ( d == r ) {
+      begin = &_node_port[dest];
+      end = begin + 1;
+    } else {
+      int const i = d * _size + r;
+      begin = _route_port_ptr + _route_begin_ptr[i];
+      end = _route_port_ptr + _route_begin_ptr[i+1];
+    }
+  }
+
   static void RegisterRoutingFunctions();
   double Capacity( ) const {return -1;}
   void InsertRandomFaults( const Configuration &config ){}
@@ -66,4 +109,6 @@ public:
 
 void min_anynet( const Router *r, const Flit *f, int in_channel, 
 		      OutputSet *outputs, bool inject );
+void ecmp_anynet( const Router *r, const Flit *f, int in_channel, 
+		  OutputSet *outputs, bool inject );
 #endif
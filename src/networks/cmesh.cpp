@@ -47,11 +47,6 @@
 #include "misc_utils.hpp"
 #include "cmesh.hpp"
 
-int CMesh::_cX = 0 ;
-int CMesh::_cY = 0 ;
-int CMesh::_memo_NodeShiftX = 0 ;
-int CMesh::_memo_NodeShiftY = 0 ;
-int CMesh::_memo_PortShiftY = 0 ;
 
 CMesh::CMesh( const Configuration& config, const string & name ) 
   : Network(config, name) 
@@ -62,10 +57,10 @@ CMesh::CMesh( const Configuration& config, const string & name )
 }
 
 void CMesh::RegisterRoutingFunctions() {
-  gRoutingFunctionMap["dor_cmesh"] = &dor_cmesh;
-  gRoutingFunctionMap["dor_no_express_cmesh"] = &dor_no_express_cmesh;
-  gRoutingFunctionMap["xy_yx_cmesh"] = &xy_yx_cmesh;
-  gRoutingFunctionMap["xy_yx_no_express_cmesh"]  = &xy_yx_no_express_cmesh;
+  gContext->routing_function_map["dor_cmesh"] = &dor_cmesh;
+  gContext->routing_function_map["dor_no_express_cmesh"] = &dor_no_express_cmesh;
+  gContext->routing_function_map["xy_yx_cmesh"] = &xy_yx_cmesh;
+  gContext->routing_function_map["xy_yx_no_express_cmesh"]  = &xy_yx_no_express_cmesh;
 }
 
 void CMesh::_ComputeSize( const Configuration &config ) {
@@ -86,9 +81,9 @@ void CMesh::_ComputeSize( const Configuration &config ) {
   _yrouter = config.GetInt("yr");
   assert(_xrouter == _yrouter); // broken for asymmetric concentration
 
-  gK = _k = k ;
-  gN = _n = n ;
-  gC = _c = c ;
+  gContext->k = _k = k ;
+  gContext->n = _n = n ;
+  gContext->c = _c = c ;
 
   assert(c == _xrouter*_yrouter);
   
@@ -96,13 +91,13 @@ void CMesh::_ComputeSize( const Configuration &config ) {
   _size     = powi( _k, _n);      // Number of routers in network
   _channels = 2 * _n * _size;     // Number of channels in network
 
-  _cX = _c / _n ;   // Concentration in X Dimension 
-  _cY = _c / _cX ;  // Concentration in Y Dimension
+  gContext->cmesh_cx = _c / _n ;   // Concentration in X Dimension 
+  gContext->cmesh_cy = _c / gContext->cmesh_cx ;  // Concentration in Y Dimension
 
   //
-  _memo_NodeShiftX = _cX >> 1 ;
-  _memo_NodeShiftY = log_two(gK * _cX) + ( _cY >> 1 ) ;
-  _memo_PortShiftY = log_two(gK * _cX)  ;
+  gContext->cmesh_node_shift_x = gContext->cmesh_cx >> 1 ;
+  gContext->cmesh_node_shift_y = log_two(gContext->k * gContext->cmesh_cx) + ( gContext->cmesh_cy >> 1 ) ;
+  gContext->cmesh_port_shift_y = log_two(gContext->k * gContext->cmesh_cx)  ;
 
 }
 
@@ -112,8 +107,8 @@ void CMesh::_BuildNet( const Configuration& config ) {
   int y_index ;
 
   //standard trace configuration 
-  if(gTrace){
-    cout<<"Setup Finished Router"<<endl;
+  if(gContext->trace){
+    *gContext->out<<"Setup Finished Router"<<endl;
   }
 
   //latency type, noc or conventional network
@@ -158,9 +153,9 @@ void CMesh::_BuildNet( const Configuration& config ) {
     //
     // Processing node channels
     //
-    for (int y = 0; y < _cY ; y++) {
-      for (int x = 0; x < _cX ; x++) {
-	int link = (_k * _cX) * (_cY * y_index + y) + (_cX * x_index + x) ;
+    for (int y = 0; y < gContext->cmesh_cy ; y++) {
+      for (int x = 0; x < gContext->cmesh_cx ; x++) {
+	int link = (_k * gContext->cmesh_cx) * (gContext->cmesh_cy * y_index + y) + (gContext->cmesh_cx * x_index + x) ;
 	assert( link >= 0 ) ;
 	assert( link < _nodes ) ;
 	assert( channel_vector[ link ] == false ) ;
@@ -233,7 +228,7 @@ void CMesh::_BuildNet( const Configuration& config ) {
 
     // Port 0: +x channel
     if(use_noc_latency) {
-      int const px_latency = (x == _k-1) ? (_cY*_k/2) : _cX;
+      int const px_latency = (x == _k-1) ? (gContext->cmesh_cy*_k/2) : gContext->cmesh_cx;
       _chan[px_out]->SetLatency( px_latency );
       _chan_cred[px_out]->SetLatency( px_latency );
     } else {
@@ -243,13 +238,13 @@ void CMesh::_BuildNet( const Configuration& config ) {
     _routers[node]->AddOutputChannel( _chan[px_out], _chan_cred[px_out] );
     _routers[node]->AddInputChannel( _chan[px_in], _chan_cred[px_in] );
     
-    if(gTrace) {
-      cout<<"Link "<<" "<<px_out<<" "<<px_in<<" "<<node<<" "<<_chan[px_out]->GetLatency()<<endl;
+    if(gContext->trace) {
+      *gContext->out<<"Link "<<" "<<px_out<<" "<<px_in<<" "<<node<<" "<<_chan[px_out]->GetLatency()<<endl;
     }
 
     // Port 1: -x channel
     if(use_noc_latency) {
-      int const nx_latency = (x == 0) ? (_cY*_k/2) : _cX;
+      int const nx_latency = (x == 0) ? (gContext->cmesh_cy*_k/2) : gContext->cmesh_cx;
       _chan[nx_out]->SetLatency( nx_latency );
       _chan_cred[nx_out]->SetLatency( nx_latency );
     } else {
@@ -259,13 +254,13 @@ void CMesh::_BuildNet( const Configuration& config ) {
     _routers[node]->AddOutputChannel( _chan[nx_out], _chan_cred[nx_out] );
     _routers[node]->AddInputChannel( _chan[nx_in], _chan_cred[nx_in] );
 
-    if(gTrace){
-      cout<<"Link "<<" "<<nx_out<<" "<<nx_in<<" "<<node<<" "<<_chan[nx_out]->GetLatency()<<endl;
+    if(gContext->trace){
+      *gContext->out<<"Link "<<" "<<nx_out<<" "<<nx_in<<" "<<node<<" "<<_chan[nx_out]->GetLatency()<<endl;
     }
 
     // Port 2: +y channel
     if(use_noc_latency) {
-      int const py_latency = (y == _k-1) ? (_cX*_k/2) : _cY;
+      int const py_latency = (y == _k-1) ? (gContext->cmesh_cx*_k/2) : gContext->cmesh_cy;
       _chan[py_out]->SetLatency( py_latency );
       _chan_cred[py_out]->SetLatency( py_latency );
     } else {
@@ -275,13 +270,13 @@ void CMesh::_BuildNet( const Configuration& config ) {
     _routers[node]->AddOutputChannel( _chan[py_out], _chan_cred[py_out] );
     _routers[node]->AddInputChannel( _chan[py_in], _chan_cred[py_in] );
     
-    if(gTrace){
-      cout<<"Link "<<" "<<py_out<<" "<<py_in<<" "<<node<<" "<<_chan[py_out]->GetLatency()<<endl;
+    if(gContext->trace){
+      *gContext->out<<"Link "<<" "<<py_out<<" "<<py_in<<" "<<node<<" "<<_chan[py_out]->GetLatency()<<endl;
     }
 
     // Port 3: -y channel
     if(use_noc_latency){
-      int const ny_latency = (y == 0) ? (_cX*_k/2) : _cY;
+      int const ny_latency = (y == 0) ? (gContext->cmesh_cx*_k/2) : gContext->cmesh_cy;
       _chan[ny_out]->SetLatency( ny_latency );
       _chan_cred[ny_out]->SetLatency( ny_latency );
     } else {
@@ -291,8 +286,8 @@ void CMesh::_BuildNet( const Configuration& config ) {
     _routers[node]->AddOutputChannel( _chan[ny_out], _chan_cred[ny_out] );
     _routers[node]->AddInputChannel( _chan[ny_in], _chan_cred[ny_in] );    
 
-    if(gTrace){
-      cout<<"Link "<<" "<<ny_out<<" "<<ny_in<<" "<<node<<" "<<_chan[ny_out]->GetLatency()<<endl;
+    if(gContext->trace){
+      *gContext->out<<"Link "<<" "<<ny_out<<" "<<ny_in<<" "<<node<<" "<<_chan[ny_out]->GetLatency()<<endl;
     }
     
   }    
@@ -301,8 +296,8 @@ void CMesh::_BuildNet( const Configuration& config ) {
   for ( int i = 0 ; i < _nodes ; i++ ) 
     assert( channel_vector[i] == true ) ;
   
-  if(gTrace){
-    cout<<"Setup Finished Link"<<endl;
+  if(gContext->trace){
+    *gContext->out<<"Setup Finished Link"<<endl;
   }
 }
 
@@ -315,22 +310,22 @@ void CMesh::_BuildNet( const Configuration& config ) {
 
 int CMesh::NodeToRouter( int address ) {
 
-  int y  = (address /  (_cX*gK))/_cY ;
-  int x  = (address %  (_cX*gK))/_cY ;
-  int router = y*gK + x ;
+  int y  = (address /  (gContext->cmesh_cx*gContext->k))/gContext->cmesh_cy ;
+  int x  = (address %  (gContext->cmesh_cx*gContext->k))/gContext->cmesh_cy ;
+  int router = y*gContext->k + x ;
   
   return router ;
 }
 
 int CMesh::NodeToPort( int address ) {
   
-  const int maskX  = _cX - 1 ;
-  const int maskY  = _cY - 1 ;
+  const int maskX  = gContext->cmesh_cx - 1 ;
+  const int maskY  = gContext->cmesh_cy - 1 ;
 
   int x = address & maskX ;
-  int y = (int)(address/(2*gK)) & maskY ;
+  int y = (int)(address/(2*gContext->k)) & maskY ;
 
-  return (gC / 2) * y + x;
+  return (gContext->c / 2) * y + x;
 }
 
 // ----------------------------------------------------------------------
@@ -347,51 +342,51 @@ int cmesh_xy( int cur, int dest ) {
   const int POSITIVE_Y = 2 ;
   const int NEGATIVE_Y = 3 ;
 
-  int cur_y  = cur / gK;
-  int cur_x  = cur % gK;
-  int dest_y = dest / gK;
-  int dest_x = dest % gK;
+  int cur_y  = cur / gContext->k;
+  int cur_x  = cur % gContext->k;
+  int dest_y = dest / gContext->k;
+  int dest_x = dest % gContext->k;
 
   // Dimension-order Routing: x , y
   if (cur_x < dest_x) {
     // Express?
     if ((dest_x - cur_x) > 1){
       if (cur_y == 0)
-    	return gC + NEGATIVE_Y ;
-      if (cur_y == (gK-1))
-    	return gC + POSITIVE_Y ;
+    	return gContext->c + NEGATIVE_Y ;
+      if (cur_y == (gContext->k-1))
+    	return gContext->c + POSITIVE_Y ;
     }
-    return gC + POSITIVE_X ;
+    return gContext->c + POSITIVE_X ;
   }
   if (cur_x > dest_x) {
     // Express ? 
     if ((cur_x - dest_x) > 1){
       if (cur_y == 0)
-    	return gC + NEGATIVE_Y ;
-      if (cur_y == (gK-1))
-    	return gC + POSITIVE_Y ;
+    	return gContext->c + NEGATIVE_Y ;
+      if (cur_y == (gContext->k-1))
+    	return gContext->c + POSITIVE_Y ;
     }
-    return gC + NEGATIVE_X ;
+    return gContext->c + NEGATIVE_X ;
   }
   if (cur_y < dest_y) {
     // Express?
     if ((dest_y - cur_y) > 1) {
       if (cur_x == 0)
-    	return gC + NEGATIVE_X ;
-      if (cur_x == (gK-1))
-    	return gC + POSITIVE_X ;
+    	return gContext->c + NEGATIVE_X ;
+      if (cur_x == (gContext->k-1))
+    	return gContext->c + POSITIVE_X ;
     }
-    return gC + POSITIVE_Y ;
+    return gContext->c + POSITIVE_Y ;
   }
   if (cur_y > dest_y) {
     // Express ?
     if ((cur_y - dest_y) > 1 ){
       if (cur_x == 0)
-    	return gC + NEGATIVE_X ;
-      if (cur_x == (gK-1))
-    	return gC + POSITIVE_X ;
+    	return gContext->c + NEGATIVE_X ;
+      if (cur_x == (gContext->k-1))
+    	return gContext->c + POSITIVE_X ;
     }
-    return gC + NEGATIVE_Y ;
+    return gContext->c + NEGATIVE_Y ;
   }
   return 0;
 }
@@ -403,51 +398,51 @@ int cmesh_yx( int cur, int dest ) {
   const int POSITIVE_Y = 2 ;
   const int NEGATIVE_Y = 3 ;
 
-  int cur_y  = cur / gK ;
-  int cur_x  = cur % gK ;
-  int dest_y = dest / gK ;
-  int dest_x = dest % gK ;
+  int cur_y  = cur / gContext->k ;
+  int cur_x  = cur % gContext->k ;
+  int dest_y = dest / gContext->k ;
+  int dest_x = dest % gContext->k ;
 
   // Dimension-order Routing: y, x
   if (cur_y < dest_y) {
     // Express?
     if ((dest_y - cur_y) > 1) {
       if (cur_x == 0)
-    	return gC + NEGATIVE_X ;
-      if (cur_x == (gK-1))
-    	return gC + POSITIVE_X ;
+    	return gContext->c + NEGATIVE_X ;
+      if (cur_x == (gContext->k-1))
+    	return gContext->c + POSITIVE_X ;
     }
-    return gC + POSITIVE_Y ;
+    return gContext->c + POSITIVE_Y ;
   }
   if (cur_y > dest_y) {
     // Express ?
     if ((cur_y - dest_y) > 1 ){
       if (cur_x == 0)
-    	return gC + NEGATIVE_X ;
-      if (cur_x == (gK-1))
-    	return gC + POSITIVE_X ;
+    	return gContext->c + NEGATIVE_X ;
+      if (cur_x == (gContext->k-1))
+    	return gContext->c + POSITIVE_X ;
     }
-    return gC + NEGATIVE_Y ;
+    return gContext->c + NEGATIVE_Y ;
   }
   if (cur_x < dest_x) {
     // Express?
     if ((dest_x - cur_x) > 1){
       if (cur_y == 0)
-    	return gC + NEGATIVE_Y ;
-      if (cur_y == (gK-1))
-    	return gC + POSITIVE_Y ;
+    	return gContext->c + NEGATIVE_Y ;
+      if (cur_y == (gContext->k-1))
+    	return gContext->c + POSITIVE_Y ;
     }
-    return gC + POSITIVE_X ;
+    return gContext->c + POSITIVE_X ;
   }
   if (cur_x > dest_x) {
     // Express ? 
     if ((cur_x - dest_x) > 1){
       if (cur_y == 0)
-    	return gC + NEGATIVE_Y ;
-      if (cur_y == (gK-1))
-    	return gC + POSITIVE_Y ;
+    	return gContext->c + NEGATIVE_Y ;
+      if (cur_y == (gContext->k-1))
+    	return gContext->c + POSITIVE_Y ;
     }
-    return gC + NEGATIVE_X ;
+    return gContext->c + NEGATIVE_X ;
   }
   return 0;
 }
@@ -457,19 +452,19 @@ void xy_yx_cmesh( const Router *r, const Flit *f, int in_channel,
 {
 
   // ( Traffic Class , Routing Order ) -> Virtual Channel Range
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -501,7 +496,7 @@ void xy_yx_cmesh( const Router *r, const Flit *f, int in_channel,
       assert(available_vcs > 0);
 
       // randomly select dimension order at first hop
-      bool x_then_y = ((in_channel < gC) ?
+      bool x_then_y = ((in_channel < gContext->c) ?
 		       (RandomInt(1) > 0) :
 		       (f->vc < (vcBegin + available_vcs)));
 
@@ -537,27 +532,27 @@ int cmesh_xy_no_express( int cur, int dest ) {
   const int POSITIVE_Y = 2 ;
   const int NEGATIVE_Y = 3 ;
 
-  const int cur_y  = cur  / gK ;
-  const int cur_x  = cur  % gK ;
-  const int dest_y = dest / gK ;
-  const int dest_x = dest % gK ;
+  const int cur_y  = cur  / gContext->k ;
+  const int cur_x  = cur  % gContext->k ;
+  const int dest_y = dest / gContext->k ;
+  const int dest_x = dest % gContext->k ;
 
 
-  //  Note: channel numbers bellow gC (degree of concentration) are
+  //  Note: channel numbers bellow gContext->c (degree of concentration) are
   //        injection and ejection links
 
   // Dimension-order Routing: X , Y
   if (cur_x < dest_x) {
-    return gC + POSITIVE_X ;
+    return gContext->c + POSITIVE_X ;
   }
   if (cur_x > dest_x) {
-    return gC + NEGATIVE_X ;
+    return gContext->c + NEGATIVE_X ;
   }
   if (cur_y < dest_y) {
-    return gC + POSITIVE_Y ;
+    return gContext->c + POSITIVE_Y ;
   }
   if (cur_y > dest_y) {
-    return gC + NEGATIVE_Y ;
+    return gContext->c + NEGATIVE_Y ;
   }
   return 0;
 }
@@ -569,26 +564,26 @@ int cmesh_yx_no_express( int cur, int dest ) {
   const int POSITIVE_Y = 2 ;
   const int NEGATIVE_Y = 3 ;
   
-  const int cur_y  = cur / gK ;
-  const int cur_x  = cur % gK ;
-  const int dest_y = dest / gK ;
-  const int dest_x = dest % gK ;
+  const int cur_y  = cur / gContext->k ;
+  const int cur_x  = cur % gContext->k ;
+  const int dest_y = dest / gContext->k ;
+  const int dest_x = dest % gContext->k ;
 
-  //  Note: channel numbers bellow gC (degree of concentration) are
+  //  Note: channel numbers bellow gContext->c (degree of concentration) are
   //        injection and ejection links
 
   // Dimension-order Routing: X , Y
   if (cur_y < dest_y) {
-    return gC + POSITIVE_Y ;
+    return gContext->c + POSITIVE_Y ;
   }
   if (cur_y > dest_y) {
-    return gC + NEGATIVE_Y ;
+    return gContext->c + NEGATIVE_Y ;
   }
   if (cur_x < dest_x) {
-    return gC + POSITIVE_X ;
+    return gContext->c + POSITIVE_X ;
   }
   if (cur_x > dest_x) {
-    return gC + NEGATIVE_X ;
+    return gContext->c + NEGATIVE_X ;
   }
   return 0;
 }
@@ -597,19 +592,19 @@ void xy_yx_no_express_cmesh( const Router *r, const Flit *f, int in_channel,
 			     OutputSet *outputs, bool inject )
 {
   // ( Traffic Class , Routing Order ) -> Virtual Channel Range
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -641,7 +636,7 @@ void xy_yx_no_express_cmesh( const Router *r, const Flit *f, int in_channel,
       assert(available_vcs > 0);
 
       // randomly select dimension order at first hop
-      bool x_then_y = ((in_channel < gC) ?
+      bool x_then_y = ((in_channel < gContext->c) ?
 		       (RandomInt(1) > 0) :
 		       (f->vc < (vcBegin + available_vcs)));
 
@@ -669,51 +664,51 @@ int cmesh_next( int cur, int dest ) {
   const int POSITIVE_Y = 2 ;
   const int NEGATIVE_Y = 3 ;
   
-  int cur_y  = cur / gK ;
-  int cur_x  = cur % gK ;
-  int dest_y = dest / gK ;
-  int dest_x = dest % gK ;
+  int cur_y  = cur / gContext->k ;
+  int cur_x  = cur % gContext->k ;
+  int dest_y = dest / gContext->k ;
+  int dest_x = dest % gContext->k ;
 
   // Dimension-order Routing: x , y
   if (cur_x < dest_x) {
     // Express?
-    if ((dest_x - cur_x) > gK/2-1){
+    if ((dest_x - cur_x) > gContext->k/2-1){
       if (cur_y == 0)
-	return gC + NEGATIVE_Y ;
-      if (cur_y == (gK-1))
-	return gC + POSITIVE_Y ;
+	return gContext->c + NEGATIVE_Y ;
+      if (cur_y == (gContext->k-1))
+	return gContext->c + POSITIVE_Y ;
     }
-    return gC + POSITIVE_X ;
+    return gContext->c + POSITIVE_X ;
   }
   if (cur_x > dest_x) {
     // Express ? 
-    if ((cur_x - dest_x) > gK/2-1){
+    if ((cur_x - dest_x) > gContext->k/2-1){
       if (cur_y == 0)
-	return gC + NEGATIVE_Y ;
-      if (cur_y == (gK-1)) 
-	return gC + POSITIVE_Y ;
+	return gContext->c + NEGATIVE_Y ;
+      if (cur_y == (gContext->k-1)) 
+	return gContext->c + POSITIVE_Y ;
     }
-    return gC + NEGATIVE_X ;
+    return gContext->c + NEGATIVE_X ;
   }
   if (cur_y < dest_y) {
     // Express?
-    if ((dest_y - cur_y) > gK/2-1) {
+    if ((dest_y - cur_y) > gContext->k/2-1) {
       if (cur_x == 0)
-	return gC + NEGATIVE_X ;
-      if (cur_x == (gK-1))
-	return gC + POSITIVE_X ;
+	return gContext->c + NEGATIVE_X ;
+      if (cur_x == (gContext->k-1))
+	return gContext->c + POSITIVE_X ;
     }
-    return gC + POSITIVE_Y ;
+    return gContext->c + POSITIVE_Y ;
   }
   if (cur_y > dest_y) {
     // Express ?
-    if ((cur_y - dest_y) > gK/2-1){
+    if ((cur_y - dest_y) > gContext->k/2-1){
       if (cur_x == 0)
-	return gC + NEGATIVE_X ;
-      if (cur_x == (gK-1))
-	return gC + POSITIVE_X ;
+	return gContext->c + NEGATIVE_X ;
+      if (cur_x == (gContext->k-1))
+	return gContext->c + POSITIVE_X ;
     }
-    return gC + NEGATIVE_Y ;
+    return gContext->c + NEGATIVE_Y ;
   }
 
   assert(false);
@@ -724,19 +719,19 @@ void dor_cmesh( const Router *r, const Flit *f, int in_channel,
 		OutputSet *outputs, bool inject )
 {
   // ( Traffic Class , Routing Order ) -> Virtual Channel Range
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -781,24 +776,24 @@ int cmesh_next_no_express( int cur, int dest ) {
   const int POSITIVE_Y = 2 ;
   const int NEGATIVE_Y = 3 ;
   
-  //magic constant 2, which is supose to be _cX and _cY
-  int cur_y  = cur/gK ;
-  int cur_x  = cur%gK ;
-  int dest_y = dest/gK;
-  int dest_x = dest%gK ;
+  //magic constant 2, which is supose to be gContext->cmesh_cx and gContext->cmesh_cy
+  int cur_y  = cur/gContext->k ;
+  int cur_x  = cur%gContext->k ;
+  int dest_y = dest/gContext->k;
+  int dest_x = dest%gContext->k ;
 
   // Dimension-order Routing: x , y
   if (cur_x < dest_x) {
-    return gC + POSITIVE_X ;
+    return gContext->c + POSITIVE_X ;
   }
   if (cur_x > dest_x) {
-    return gC + NEGATIVE_X ;
+    return gContext->c + NEGATIVE_X ;
   }
   if (cur_y < dest_y) {
-    return gC + POSITIVE_Y ;
+    return gContext->c + POSITIVE_Y ;
   }
   if (cur_y > dest_y) {
-    return gC + NEGATIVE_Y ;
+    return gContext->c + NEGATIVE_Y ;
   }
   assert(false);
   return -1;
@@ -808,19 +803,19 @@ void dor_no_express_cmesh( const Router *r, const Flit *f, int in_channel,
 			   OutputSet *outputs, bool inject )
 {
   // ( Traffic Class , Routing Order ) -> Virtual Channel Range
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
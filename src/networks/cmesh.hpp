@@ -57,13 +57,6 @@ public:
 
 private:
 
-  static int _cX ;
-  static int _cY ;
-
-  static int _memo_NodeShiftX ;
-  static int _memo_NodeShiftY ;
-  static int _memo_PortShiftY ;
-
   void _ComputeSize( const Configuration &config );
   void _BuildNet( const Configuration& config );
 
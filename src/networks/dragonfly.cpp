@@ -37,7 +37,6 @@
 
 #define DRAGON_LATENCY
 
-int gP, gA, gG;
 
 //calculate the hop count between src and estination
 int dragonflynew_hopcnt(int src, int dest) 
@@ -49,15 +48,15 @@ int dragonflynew_hopcnt(int src, int dest)
   int grp_output, dest_grp_output;
   int grp_output_RID;
 
-  int _grp_num_routers= gA;
-  int _grp_num_nodes =_grp_num_routers*gP;
+  int _grp_num_routers= gContext->dragonfly_a;
+  int _grp_num_nodes =_grp_num_routers*gContext->dragonfly_p;
   
   dest_grp_ID = int(dest/_grp_num_nodes);
   src_grp_ID = int(src / _grp_num_nodes);
   
   //source and dest are in the same group, either 0-1 hop
   if (dest_grp_ID == src_grp_ID) {
-    if ((int)(dest / gP) == (int)(src /gP))
+    if ((int)(dest / gContext->dragonfly_p) == (int)(src /gContext->dragonfly_p))
       hopcnt = 0;
     else
       hopcnt = 1;
@@ -74,20 +73,20 @@ int dragonflynew_hopcnt(int src, int dest)
       grp_output = dest_grp_ID - 1;
       dest_grp_output = src_grp_ID;
     }
-    grp_output_RID = ((int) (grp_output / (gP))) + src_grp_ID * _grp_num_routers;
-    src_intm = grp_output_RID * gP;
+    grp_output_RID = ((int) (grp_output / (gContext->dragonfly_p))) + src_grp_ID * _grp_num_routers;
+    src_intm = grp_output_RID * gContext->dragonfly_p;
 
-    grp_output_RID = ((int) (dest_grp_output / (gP))) + dest_grp_ID * _grp_num_routers;
-    dest_intm = grp_output_RID * gP;
+    grp_output_RID = ((int) (dest_grp_output / (gContext->dragonfly_p))) + dest_grp_ID * _grp_num_routers;
+    dest_intm = grp_output_RID * gContext->dragonfly_p;
 
     //hop count in source group
-    if ((int)( src_intm / gP) == (int)( src / gP ) )
+    if ((int)( src_intm / gContext->dragonfly_p) == (int)( src / gContext->dragonfly_p ) )
       src_hopcnt = 0;
     else
       src_hopcnt = 1; 
 
     //hop count in destination group
-    if ((int)( dest_intm / gP) == (int)( dest / gP ) ){
+    if ((int)( dest_intm / gContext->dragonfly_p) == (int)( dest / gContext->dragonfly_p ) ){
       dest_hopcnt = 0;
     }else{
       dest_hopcnt = 1;
@@ -103,8 +102,8 @@ int dragonflynew_hopcnt(int src, int dest)
 
 //packet output port based on the source, destination and current location
 int dragonfly_port(int rID, int source, int dest){
-  int _grp_num_routers= gA;
-  int _grp_num_nodes =_grp_num_routers*gP;
+  int _grp_num_routers= gContext->dragonfly_a;
+  int _grp_num_nodes =_grp_num_routers*gContext->dragonfly_p;
 
   int out_port = -1;
   int grp_ID = int(rID / _grp_num_routers); 
@@ -114,30 +113,30 @@ int dragonfly_port(int rID, int source, int dest){
   
   //which router within this group the packet needs to go to
   if (dest_grp_ID == grp_ID) {
-    grp_RID = int(dest / gP);
+    grp_RID = int(dest / gContext->dragonfly_p);
   } else {
     if (grp_ID > dest_grp_ID) {
       grp_output = dest_grp_ID;
     } else {
       grp_output = dest_grp_ID - 1;
     }
-    grp_RID = int(grp_output /gP) + grp_ID * _grp_num_routers;
+    grp_RID = int(grp_output /gContext->dragonfly_p) + grp_ID * _grp_num_routers;
   }
 
   //At the last hop
-  if (dest >= rID*gP && dest < (rID+1)*gP) {    
-    out_port = dest%gP;
+  if (dest >= rID*gContext->dragonfly_p && dest < (rID+1)*gContext->dragonfly_p) {    
+    out_port = dest%gContext->dragonfly_p;
   } else if (grp_RID == rID) {
     //At the optical link
-    out_port = gP + (gA-1) + grp_output %(gP);
+    out_port = gContext->dragonfly_p + (gContext->dragonfly_a-1) + grp_output %(gContext->dragonfly_p);
   } else {
     //need to route within a group
     assert(grp_RID!=-1);
 
     if (rID < grp_RID){
-      out_port = (grp_RID % _grp_num_routers) - 1 + gP;
+      out_port = (grp_RID % _grp_num_routers) - 1 + gContext->dragonfly_p;
     }else{
-      out_port = (grp_RID % _grp_num_routers) + gP;
+      out_port = (grp_RID % _grp_num_routers) + gContext->dragonfly_p;
     }
   }  
  
@@ -185,7 +184,7 @@ void DragonFlyNew::_ComputeSize( const Configuration &config )
 
   
   // FIX...
-  gK = _p; gN = _n;
+  gContext->k = _p; gContext->n = _n;
 
   // with 1 dimension, total of 2p routers per group
   // N = 2p * p * (2p^2 + 1)
@@ -210,11 +209,11 @@ void DragonFlyNew::_ComputeSize( const Configuration &config )
 
 
   
-  gG = _g;
-  gP = _p;
-  gA = _a;
-  _grp_num_routers = gA;
-  _grp_num_nodes =_grp_num_routers*gP;
+  gContext->dragonfly_g = _g;
+  gContext->dragonfly_p = _p;
+  gContext->dragonfly_a = _a;
+  _grp_num_routers = gContext->dragonfly_a;
+  _grp_num_nodes =_grp_num_routers*gContext->dragonfly_p;
 
 }
 
@@ -231,14 +230,14 @@ void DragonFlyNew::_BuildNet( const Configuration &config )
 
 
 
-  cout << " Dragonfly " << endl;
-  cout << " p = " << _p << " n = " << _n << endl;
-  cout << " each switch - total radix =  "<< _k << endl;
-  cout << " # of switches = "<<  _num_of_switch << endl;
-  cout << " # of channels = "<<  _channels << endl;
-  cout << " # of nodes ( size of network ) = " << _nodes << endl;
-  cout << " # of groups (_g) = " << _g << endl;
-  cout << " # of routers per group (_a) = " << _a << endl;
+  *gContext->out << " Dragonfly " << endl;
+  *gContext->out << " p = " << _p << " n = " << _n << endl;
+  *gContext->out << " each switch - total radix =  "<< _k << endl;
+  *gContext->out << " # of switches = "<<  _num_of_switch << endl;
+  *gContext->out << " # of channels = "<<  _channels << endl;
+  *gContext->out << " # of nodes ( size of network ) = " << _nodes << endl;
+  *gContext->out << " # of groups (_g) = " << _g << endl;
+  *gContext->out << " # of routers per group (_a) = " << _a << endl;
 
   for ( int node = 0; node < _num_of_switch; ++node ) {
     // ID of the group
@@ -382,7 +381,7 @@ void DragonFlyNew::_BuildNet( const Configuration &config )
 
   }
 
-  cout<<"Done links"<<endl;
+  *gContext->out<<"Done links"<<endl;
 }
 
 
@@ -408,8 +407,8 @@ double DragonFlyNew::Capacity( ) const
 
 void DragonFlyNew::RegisterRoutingFunctions(){
 
-  gRoutingFunctionMap["min_dragonflynew"] = &min_dragonflynew;
-  gRoutingFunctionMap["ugal_dragonflynew"] = &ugal_dragonflynew;
+  gContext->routing_function_map["min_dragonflynew"] = &min_dragonflynew;
+  gContext->routing_function_map["ugal_dragonflynew"] = &ugal_dragonflynew;
 }
 
 
@@ -419,12 +418,12 @@ void min_dragonflynew( const Router *r, const Flit *f, int in_channel,
   outputs->Clear( );
 
   if(inject) {
-    int inject_vc= RandomInt(gNumVCs-1);
+    int inject_vc= RandomInt(gContext->num_vcs-1);
     outputs->AddRange(-1, inject_vc, inject_vc);
     return;
   }
 
-  int _grp_num_routers= gA;
+  int _grp_num_routers= gContext->dragonfly_a;
 
   int dest  = f->dest;
   int rID =  r->GetID(); 
@@ -435,7 +434,7 @@ void min_dragonflynew( const Router *r, const Flit *f, int in_channel,
   int out_vc = 0;
   int dest_grp_ID=-1;
 
-  if ( in_channel < gP ) {
+  if ( in_channel < gContext->dragonfly_p ) {
     out_vc = 0;
     f->ph = 0;
     if (dest_grp_ID == grp_ID) {
@@ -447,13 +446,13 @@ void min_dragonflynew( const Router *r, const Flit *f, int in_channel,
   out_port = dragonfly_port(rID, f->src, dest);
 
   //optical dateline
-  if (out_port >=gP + (gA-1)) {
+  if (out_port >=gContext->dragonfly_p + (gContext->dragonfly_a-1)) {
     f->ph = 1;
   }  
   
   out_vc = f->ph;
   if (debug)
-    *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+    *gContext->watch_out << GetSimTime() << " | " << r->FullName() << " | "
 	       << "	through output port : " << out_port 
 	       << " out vc: " << out_vc << endl;
   outputs->AddRange( out_port, out_vc, out_vc );
@@ -466,10 +465,10 @@ void ugal_dragonflynew( const Router *r, const Flit *f, int in_channel,
 {
   //need 3 VCs for deadlock freedom
 
-  assert(gNumVCs==3);
+  assert(gContext->num_vcs==3);
   outputs->Clear( );
   if(inject) {
-    int inject_vc= RandomInt(gNumVCs-1);
+    int inject_vc= RandomInt(gContext->num_vcs-1);
     outputs->AddRange(-1, inject_vc, inject_vc);
     return;
   }
@@ -478,9 +477,9 @@ void ugal_dragonflynew( const Router *r, const Flit *f, int in_channel,
   //negative value woudl biases it towards nonminimum routing
   int adaptive_threshold = 30;
 
-  int _grp_num_routers= gA;
-  int _grp_num_nodes =_grp_num_routers*gP;
-  int _network_size =  gA * gP * gG;
+  int _grp_num_routers= gContext->dragonfly_a;
+  int _grp_num_nodes =_grp_num_routers*gContext->dragonfly_p;
+  int _network_size =  gContext->dragonfly_a * gContext->dragonfly_p * gContext->dragonfly_g;
 
  
   int dest  = f->dest;
@@ -502,7 +501,7 @@ void ugal_dragonflynew( const Router *r, const Flit *f, int in_channel,
   int min_router_output, nonmin_router_output;
   
   //at the source router, make the adaptive routing decision
-  if ( in_channel < gP )   {
+  if ( in_channel < gContext->dragonfly_p )   {
     //dest are in the same group, only use minimum routing
     if (dest_grp_ID == grp_ID) {
       f->ph = 2;
@@ -539,7 +538,7 @@ void ugal_dragonflynew( const Router *r, const Flit *f, int in_channel,
 
   //transition from nonminimal phase to minimal
   if(f->ph==0){
-    intm_rID= (int)(f->intm/gP);
+    intm_rID= (int)(f->intm/gContext->dragonfly_p);
     if( rID == intm_rID){
       f->ph = 1;
     }
@@ -557,7 +556,7 @@ void ugal_dragonflynew( const Router *r, const Flit *f, int in_channel,
   }
 
   //optical dateline
-  if (f->ph == 1 && out_port >=gP + (gA-1)) {
+  if (f->ph == 1 && out_port >=gContext->dragonfly_p + (gContext->dragonfly_a-1)) {
     f->ph = 2;
   }  
 
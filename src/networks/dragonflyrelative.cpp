@@ -37,7 +37,6 @@
 
 #define DRAGON_LATENCY
 
-int gPP, gAA, gGG;
 
 //calculate the hop count between src and estination
 int dragonflyrelative_hopcnt(int src, int dest) 
@@ -49,15 +48,15 @@ int dragonflyrelative_hopcnt(int src, int dest)
   int grp_output, dest_grp_output;
   int grp_output_RID;
 
-  int _grp_num_routers= gAA;
-  int _grp_num_nodes =_grp_num_routers*gPP;
+  int _grp_num_routers= gContext->dragonfly_rel_a;
+  int _grp_num_nodes =_grp_num_routers*gContext->dragonfly_rel_p;
   
   dest_grp_ID = int(dest/_grp_num_nodes);
   src_grp_ID = int(src / _grp_num_nodes);
   
   //source and dest are in the same group, either 0-1 hop
   if (dest_grp_ID == src_grp_ID) {
-    if ((int)(dest / gPP) == (int)(src /gPP))
+    if ((int)(dest / gContext->dragonfly_rel_p) == (int)(src /gContext->dragonfly_rel_p))
       hopcnt = 0;
     else
       hopcnt = 1;
@@ -74,20 +73,20 @@ int dragonflyrelative_hopcnt(int src, int dest)
       grp_output = dest_grp_ID - 1;
       dest_grp_output = src_grp_ID;
     }
-    grp_output_RID = ((int) (grp_output / (gPP))) + src_grp_ID * _grp_num_routers;
-    src_intm = grp_output_RID * gPP;
+    grp_output_RID = ((int) (grp_output / (gContext->dragonfly_rel_p))) + src_grp_ID * _grp_num_routers;
+    src_intm = grp_output_RID * gContext->dragonfly_rel_p;
 
-    grp_output_RID = ((int) (dest_grp_output / (gPP))) + dest_grp_ID * _grp_num_routers;
-    dest_intm = grp_output_RID * gPP;
+    grp_output_RID = ((int) (dest_grp_output / (gContext->dragonfly_rel_p))) + dest_grp_ID * _grp_num_routers;
+    dest_intm = grp_output_RID * gContext->dragonfly_rel_p;
 
     //hop count in source group
-    if ((int)( src_intm / gPP) == (int)( src / gPP ) )
+    if ((int)( src_intm / gContext->dragonfly_rel_p) == (int)( src / gContext->dragonfly_rel_p ) )
       src_hopcnt = 0;
     else
       src_hopcnt = 1; 
 
     //hop count in destination group
-    if ((int)( dest_intm / gPP) == (int)( dest / gPP ) ){
+    if ((int)( dest_intm / gContext->dragonfly_rel_p) == (int)( dest / gContext->dragonfly_rel_p ) ){
       dest_hopcnt = 0;
     }else{
       dest_hopcnt = 1;
@@ -105,40 +104,40 @@ int dragonflyrelative_hopcnt(int src, int dest)
 // MS: it seems as though the returned value is the offset to the global
 //     port in the current router's channel array
 int dragonflyrelative_port(int rID, int source, int dest) {
-  int _grp_num_routers= gAA;
-  int _grp_num_nodes =_grp_num_routers*gPP;
+  int _grp_num_routers= gContext->dragonfly_rel_a;
+  int _grp_num_nodes =_grp_num_routers*gContext->dragonfly_rel_p;
 
   int out_port = -1;
   int my_group = int(rID / _grp_num_routers); 
   int to_group = int(dest/_grp_num_nodes);
-  int my_router = rID % gAA; // router in group
+  int my_router = rID % gContext->dragonfly_rel_a; // router in group
 
   int target_router=-1;
 
-  int dist = (( to_group + gGG ) - my_group ) % gGG; // forward distance
+  int dist = (( to_group + gContext->dragonfly_rel_g ) - my_group ) % gContext->dragonfly_rel_g; // forward distance
 
   // which router within this group the packet needs to go to
   // Node channels are first
   if (to_group == my_group) {
-    target_router = (dest % _grp_num_nodes) / gPP;  // router with the dest node
+    target_router = (dest % _grp_num_nodes) / gContext->dragonfly_rel_p;  // router with the dest node
   } else {
-    target_router = (dist - 1) / gPP; // router with the global link to our hop
+    target_router = (dist - 1) / gContext->dragonfly_rel_p; // router with the global link to our hop
   }
   
   if (my_router == target_router && my_group == to_group) {
     // at the last hop  
-    out_port = dest % gPP; // channel to the node
+    out_port = dest % gContext->dragonfly_rel_p; // channel to the node
   } else if (target_router == my_router) {
     // at the optical link
-    out_port = gPP + (gAA-1) + ( (dist - 1) % gPP );
+    out_port = gContext->dragonfly_rel_p + (gContext->dragonfly_rel_a-1) + ( (dist - 1) % gContext->dragonfly_rel_p );
   } else {
     // need to route within a group
     assert(target_router!=-1);
 
     if (my_router < target_router){
-      out_port = (target_router % _grp_num_routers) - 1 + gPP;
+      out_port = (target_router % _grp_num_routers) - 1 + gContext->dragonfly_rel_p;
     }else{
-      out_port = (target_router % _grp_num_routers) + gPP;
+      out_port = (target_router % _grp_num_routers) + gContext->dragonfly_rel_p;
     }
   }  
  
@@ -179,7 +178,7 @@ void DragonFlyRelative::_ComputeSize( const Configuration &config )
 
   
   // FIX...
-  gK = _p; gN = _n;
+  gContext->k = _p; gContext->n = _n;
 
   // with 1 dimension, total of 2p routers per group
   // N = 2p * p * (2p^2 + 1)
@@ -204,11 +203,11 @@ void DragonFlyRelative::_ComputeSize( const Configuration &config )
 
 
   
-  gGG = _g;
-  gPP = _p;
-  gAA = _a;
-  _grp_num_routers = gAA;
-  _grp_num_nodes =_grp_num_routers*gPP;
+  gContext->dragonfly_rel_g = _g;
+  gContext->dragonfly_rel_p = _p;
+  gContext->dragonfly_rel_a = _a;
+  _grp_num_routers = gContext->dragonfly_rel_a;
+  _grp_num_nodes =_grp_num_routers*gContext->dragonfly_rel_p;
 
 }
 
@@ -224,14 +223,14 @@ void DragonFlyRelative::_BuildNet( const Configuration &config )
 
 
 
-  cout << " Dragonfly Relative" << endl;
-  cout << " processors per router = " << _p << " dimension = " << _n << endl; // MS: _p - processors per router, _n - dimension, always 1
-  cout << " each router has radix =  "<< _k << endl;
-  cout << " # of routers = "<<  _num_of_switch << endl;
-  cout << " # of channels = "<<  _channels << endl;
-  cout << " # of nodes (processors) = " << _nodes << endl;
-  cout << " # of groups = " << _g << endl;
-  cout << " # of routers per group = " << _a << endl;
+  *gContext->out << " Dragonfly Relative" << endl;
+  *gContext->out << " processors per router = " << _p << " dimension = " << _n << endl; // MS: _p - processors per router, _n - dimension, always 1
+  *gContext->out << " each router has radix =  "<< _k << endl;
+  *gContext->out << " # of routers = "<<  _num_of_switch << endl;
+  *gContext->out << " # of channels = "<<  _channels << endl;
+  *gContext->out << " # of nodes (processors) = " << _nodes << endl;
+  *gContext->out << " # of groups = " << _g << endl;
+  *gContext->out << " # of routers per group = " << _a << endl;
 
   // MS: loop through each router. this is confusing because they call it node
   // which is not the terminology which we have been using
@@ -378,7 +377,7 @@ void DragonFlyRelative::_BuildNet( const Configuration &config )
 
   }
 
-  cout<<"Done links"<<endl;
+  *gContext->out<<"Done links"<<endl;
 }
 
 
@@ -405,8 +404,8 @@ double DragonFlyRelative::Capacity( ) const
 // routing functions are stored globally and usually added in ../routefunc.cpp
 void DragonFlyRelative::RegisterRoutingFunctions(){
 
-  gRoutingFunctionMap["min_dragonflyrelative"] = &min_dragonflyrelative;
-  gRoutingFunctionMap["ugal_dragonflyrelative"] = &ugal_dragonflyrelative;
+  gContext->routing_function_map["min_dragonflyrelative"] = &min_dragonflyrelative;
+  gContext->routing_function_map["ugal_dragonflyrelative"] = &ugal_dragonflyrelative;
 }
 
 // route based on the shortest path algorithm
@@ -416,12 +415,12 @@ void min_dragonflyrelative( const Router *r, const Flit *f, int in_channel,
   outputs->Clear( );
 
   if(inject) {  // create a new packet, add to random injection site
-    int inject_vc= RandomInt(gNumVCs-1);
+    int inject_vc= RandomInt(gContext->num_vcs-1);
     outputs->AddRange(-1, inject_vc, inject_vc);
     return;
   }
 
-  int _grp_num_routers= gAA;
+  int _grp_num_routers= gContext->dragonfly_rel_a;
 
   int dest  = f->dest;
   int rID =  r->GetID(); 
@@ -433,7 +432,7 @@ void min_dragonflyrelative( const Router *r, const Flit *f, int in_channel,
   int dest_grp_ID=-1;
 
   // came from a processor (speculatively):
-  if ( in_channel < gPP ) {
+  if ( in_channel < gContext->dragonfly_rel_p ) {
     out_vc = 0;
     f->ph = 0;
     if (dest_grp_ID == grp_ID) { // does this ever get trigger?
@@ -444,13 +443,13 @@ void min_dragonflyrelative( const Router *r, const Flit *f, int in_channel,
   out_port = dragonflyrelative_port(rID, f->src, dest);
 
   // optical link
-  if( out_port >= gPP + (gAA-1) ) {
+  if( out_port >= gContext->dragonfly_rel_p + (gContext->dragonfly_rel_a-1) ) {
     f->ph = 1;
   }
 
   out_vc = f->ph;
   if (debug)
-    *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+    *gContext->watch_out << GetSimTime() << " | " << r->FullName() << " | "
 	       << "	through output port : " << out_port 
 	       << " out vc: " << out_vc << endl;
   // sets the output element to send flit via those specified virtual channels
@@ -464,10 +463,10 @@ void ugal_dragonflyrelative( const Router *r, const Flit *f, int in_channel,
 {
   //need 3 VCs for deadlock freedom
 
-  assert(gNumVCs==3);
+  assert(gContext->num_vcs==3);
   outputs->Clear( );
   if(inject) {
-    int inject_vc= RandomInt(gNumVCs-1);
+    int inject_vc= RandomInt(gContext->num_vcs-1);
     outputs->AddRange(-1, inject_vc, inject_vc);
     return;
   }
@@ -476,9 +475,9 @@ void ugal_dragonflyrelative( const Router *r, const Flit *f, int in_channel,
   //negative value would biases it towards nonminimum routing
   int adaptive_threshold = 30;
 
-  int _grp_num_routers= gAA;
-  int _grp_num_nodes =_grp_num_routers*gPP;
-  int _network_size =  gAA * gPP * gGG;
+  int _grp_num_routers= gContext->dragonfly_rel_a;
+  int _grp_num_nodes =_grp_num_routers*gContext->dragonfly_rel_p;
+  int _network_size =  gContext->dragonfly_rel_a * gContext->dragonfly_rel_p * gContext->dragonfly_rel_g;
 
  
   int dest  = f->dest;
@@ -500,7 +499,7 @@ void ugal_dragonflyrelative( const Router *r, const Flit *f, int in_channel,
   int min_router_output, nonmin_router_output;
   
   //at the source router, make the adaptive routing decision
-  if ( in_channel < gPP )   {
+  if ( in_channel < gContext->dragonfly_rel_p )   {
     //dest are in the same group, only use minimum routing
     if (dest_grp_ID == grp_ID) {
       f->ph = 2;
@@ -537,7 +536,7 @@ void ugal_dragonflyrelative( const Router *r, const Flit *f, int in_channel,
 
   //transition from nonminimal phase to minimal
   if(f->ph==0){
-    intm_rID= (int)(f->intm/gPP);
+    intm_rID= (int)(f->intm/gContext->dragonfly_rel_p);
     if( rID == intm_rID){
       f->ph = 1;
     }
@@ -555,7 +554,7 @@ void ugal_dragonflyrelative( const Router *r, const Flit *f, int in_channel,
   }
 
   //optical dateline
-  if (f->ph == 1 && out_port >=gPP + (gAA-1)) {
+  if (f->ph == 1 && out_port >=gContext->dragonfly_rel_p + (gContext->dragonfly_rel_a-1)) {
     f->ph = 2;
   }  
 
@@ -72,7 +72,7 @@ void FatTree::_ComputeSize( const Configuration& config )
   _k = config.GetInt( "k" );
   _n = config.GetInt( "n" );
    
-  gK = _k; gN = _n;
+  gContext->k = _k; gContext->n = _n;
   
   _nodes = powi( _k, _n );
 
@@ -92,12 +92,12 @@ void FatTree::RegisterRoutingFunctions() {
 
 void FatTree::_BuildNet( const Configuration& config )
 {
- cout << "Fat Tree" << endl;
-  cout << " k = " << _k << " levels = " << _n << endl;
-  cout << " each switch - total radix =  "<< 2*_k << endl;
-  cout << " # of switches = "<<  _size << endl;
-  cout << " # of channels = "<<  _channels << endl;
-  cout << " # of nodes ( size of network ) = " << _nodes << endl;
+ *gContext->out << "Fat Tree" << endl;
+  *gContext->out << " k = " << _k << " levels = " << _n << endl;
+  *gContext->out << " each switch - total radix =  "<< 2*_k << endl;
+  *gContext->out << " # of switches = "<<  _size << endl;
+  *gContext->out << " # of channels = "<<  _channels << endl;
+  *gContext->out << " # of nodes ( size of network ) = " << _nodes << endl;
 
 
   // Number of router positions at each depth of the network
@@ -132,10 +132,10 @@ void FatTree::_BuildNet( const Configuration& config )
   //
 
   //
-  // Router Connection Rule: Output Ports <gK Move DOWN Network
-  //                         Output Ports >=gK Move UP Network
-  //                         Input Ports <gK from DOWN Network
-  //                         Input Ports >=gK  from up Network
+  // Router Connection Rule: Output Ports <gContext->k Move DOWN Network
+  //                         Output Ports >=gContext->k Move UP Network
+  //                         Input Ports <gContext->k from DOWN Network
+  //                         Input Ports >=gContext->k  from up Network
 
   // Connecting  Injection & Ejection Channels  
   for ( pos = 0 ; pos < nPos ; ++pos ) {
@@ -215,8 +215,8 @@ void FatTree::_BuildNet( const Configuration& config )
 	int link = 
 	  ((level+1)*chan_per_level - chan_per_direction)  //which levellevel
 	  +neighborhood*level_offset   //region in level
-	  +port*routers_per_branch*gK  //sub region in region
-	  +(neighborhood_pos)%routers_per_branch*gK  //router in subregion
+	  +port*routers_per_branch*gContext->k  //sub region in region
+	  +(neighborhood_pos)%routers_per_branch*gContext->k  //router in subregion
 	  +(neighborhood_pos)/routers_per_branch; //port on router
 
 	_Router(level, pos)->AddInputChannel( _chan[link],
@@ -244,8 +244,8 @@ void FatTree::_BuildNet( const Configuration& config )
 	int link = 
 	  ((level-1)*chan_per_level) //which levellevel
 	  +neighborhood*level_offset   //region in level
-	  +port*routers_per_branch*gK  //sub region in region
-	  +(neighborhood_pos)%routers_per_branch*gK //router in subregion
+	  +port*routers_per_branch*gContext->k  //sub region in region
+	  +(neighborhood_pos)%routers_per_branch*gContext->k //router in subregion
 	  +(neighborhood_pos)/routers_per_branch; //port on router
 
 	_Router(level, pos)->AddInputChannel( _chan[link],
@@ -60,10 +60,6 @@
 
 //#define DEBUG_FLATFLY
 
-static int _xcount;
-static int _ycount;
-static int _xrouter;
-static int _yrouter;
 
 FlatFlyOnChip::FlatFlyOnChip( const Configuration &config, const string & name ) :
   Network( config, name )
@@ -82,18 +78,18 @@ void FlatFlyOnChip::_ComputeSize( const Configuration &config )
   _r = _c + (_k-1)*_n ;		// total radix of the switch  ( # of inputs/outputs)
 
   //how many routers in the x or y direction
-  _xcount = config.GetInt("x");
-  _ycount = config.GetInt("y");
-  assert(_xcount == _ycount);
+  gContext->flatfly_xcount = config.GetInt("x");
+  gContext->flatfly_ycount = config.GetInt("y");
+  assert(gContext->flatfly_xcount == gContext->flatfly_ycount);
   //configuration of hohw many clients in X and Y per router
-  _xrouter = config.GetInt("xr");
-  _yrouter = config.GetInt("yr");
-  assert(_xrouter == _yrouter);
-  gK = _k; 
-  gN = _n;
-  gC = _c;
+  gContext->flatfly_xrouter = config.GetInt("xr");
+  gContext->flatfly_yrouter = config.GetInt("yr");
+  assert(gContext->flatfly_xrouter == gContext->flatfly_yrouter);
+  gContext->k = _k; 
+  gContext->n = _n;
+  gContext->c = _c;
   
-  assert(_c == _xrouter*_yrouter);
+  assert(_c == gContext->flatfly_xrouter*gContext->flatfly_yrouter);
 
   _nodes = powi( _k, _n )*_c;   //network size
 
@@ -110,7 +106,7 @@ void FlatFlyOnChip::_BuildNet( const Configuration &config )
   ostringstream router_name;
 
   
-  if(gTrace){
+  if(gContext->trace){
 
     cout<<"Setup Finished Router"<<endl;
     
@@ -148,16 +144,16 @@ void FlatFlyOnChip::_BuildNet( const Configuration &config )
     //******************************************************************
     
     //as accurately model the length of these channels as possible
-    int yleng = -_yrouter/2;
-    int xleng = -_xrouter/2;
-    bool yodd = _yrouter%2==1;
-    bool xodd = _xrouter%2==1;
+    int yleng = -gContext->flatfly_yrouter/2;
+    int xleng = -gContext->flatfly_xrouter/2;
+    bool yodd = gContext->flatfly_yrouter%2==1;
+    bool xodd = gContext->flatfly_xrouter%2==1;
     
-    int y_index = node/(_xcount);
-    int x_index = node%(_xcount);
+    int y_index = node/(gContext->flatfly_xcount);
+    int x_index = node%(gContext->flatfly_xcount);
     //estimating distance from client to router
-    for (int y = 0; y < _yrouter ; y++) {
-      for (int x = 0; x < _xrouter ; x++) {
+    for (int y = 0; y < gContext->flatfly_yrouter ; y++) {
+      for (int x = 0; x < gContext->flatfly_xrouter ; x++) {
 	//Zero is a naughty number
 	if(yleng == 0 && !yodd){
 	  yleng++;
@@ -176,12 +172,12 @@ void FlatFlyOnChip::_BuildNet( const Configuration &config )
 	}
 	//increment for the next client, add Y, if full, reset y add x
 	yleng++;
-	if(yleng>_yrouter/2){
-	  yleng= -_yrouter/2;
+	if(yleng>gContext->flatfly_yrouter/2){
+	  yleng= -gContext->flatfly_yrouter/2;
 	  xleng++;
 	}
 	//adopted from the CMESH, the first node has 0,1,8,9 (as an example)
-	int link = (_xcount * _xrouter) * (_yrouter * y_index + y) + (_xrouter * x_index + x) ;
+	int link = (gContext->flatfly_xcount * gContext->flatfly_xrouter) * (gContext->flatfly_yrouter * y_index + y) + (gContext->flatfly_xrouter * x_index + x) ;
 
 	if(use_noc_latency){
 	  _inject[link]->SetLatency(ileng);
@@ -256,9 +252,9 @@ void FlatFlyOnChip::_BuildNet( const Configuration &config )
 	}
 	//calculate channel length
 	int length = 0;
-	int oned = abs((node%_xcount)-(other%_xcount));
-	int twod = abs(node/_xcount-other/_xcount);
-	length = _xrouter*oned + _yrouter *twod;
+	int oned = abs((node%gContext->flatfly_xcount)-(other%gContext->flatfly_xcount));
+	int twod = abs(node/gContext->flatfly_xcount-other/gContext->flatfly_xcount);
+	length = gContext->flatfly_xrouter*oned + gContext->flatfly_yrouter *twod;
 	//oh the node<other silly ness
 	if(node<other){
 	  offset = -1;
@@ -281,14 +277,14 @@ void FlatFlyOnChip::_BuildNet( const Configuration &config )
 	
 	_routers[other]->AddInputChannel( _chan[_output], _chan_cred[_output]);
 	
-	if(gTrace){
+	if(gContext->trace){
 	  cout<<"Link "<<_output<<" "<<node<<" "<<other<<" "<<length<<endl;
 	}
 	
       }
     }
   }
-  if(gTrace){
+  if(gContext->trace){
     cout<<"Setup Finished Link"<<endl;
   }
 }
@@ -318,13 +314,13 @@ double FlatFlyOnChip::Capacity( ) const
 void FlatFlyOnChip::RegisterRoutingFunctions(){
 
   
-  gRoutingFunctionMap["ran_min_flatfly"] = &min_flatfly;
-  gRoutingFunctionMap["adaptive_xyyx_flatfly"] = &adaptive_xyyx_flatfly;
-  gRoutingFunctionMap["xyyx_flatfly"] = &xyyx_flatfly;
-  gRoutingFunctionMap["valiant_flatfly"] = &valiant_flatfly;
-  gRoutingFunctionMap["ugal_flatfly"] = &ugal_flatfly_onchip;
-  gRoutingFunctionMap["ugal_pni_flatfly"] = &ugal_pni_flatfly_onchip;
-  gRoutingFunctionMap["ugal_xyyx_flatfly"] = &ugal_xyyx_flatfly_onchip;
+  gContext->routing_function_map["ran_min_flatfly"] = &min_flatfly;
+  gContext->routing_function_map["adaptive_xyyx_flatfly"] = &adaptive_xyyx_flatfly;
+  gContext->routing_function_map["xyyx_flatfly"] = &xyyx_flatfly;
+  gContext->routing_function_map["valiant_flatfly"] = &valiant_flatfly;
+  gContext->routing_function_map["ugal_flatfly"] = &ugal_flatfly_onchip;
+  gContext->routing_function_map["ugal_pni_flatfly"] = &ugal_pni_flatfly_onchip;
+  gContext->routing_function_map["ugal_xyyx_flatfly"] = &ugal_xyyx_flatfly_onchip;
 
 }
 
@@ -333,19 +329,19 @@ void adaptive_xyyx_flatfly( const Router *r, const Flit *f, int in_channel,
 		  OutputSet *outputs, bool inject )
 { 
   // ( Traffic Class , Routing Order ) -> Virtual Channel Range
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -358,10 +354,10 @@ void adaptive_xyyx_flatfly( const Router *r, const Flit *f, int in_channel,
   } else {
 
     int dest = flatfly_transformation(f->dest);
-    int targetr = (int)(dest/gC);
+    int targetr = (int)(dest/gContext->c);
 
     if(targetr==r->GetID()){ //if we are at the final router, yay, output to client
-      out_port = dest % gC;
+      out_port = dest % gContext->c;
 
     } else {
    
@@ -375,7 +371,7 @@ void adaptive_xyyx_flatfly( const Router *r, const Flit *f, int in_channel,
       // Route order (XY or YX) determined when packet is injected
       //  into the network, adaptively
       bool x_then_y;
-      if(in_channel < gC){
+      if(in_channel < gContext->c){
 	int credit_xy = r->GetUsedCredit(out_port_xy);
 	int credit_yx = r->GetUsedCredit(out_port_yx);
 	if(credit_xy > credit_yx) {
@@ -410,19 +406,19 @@ void xyyx_flatfly( const Router *r, const Flit *f, int in_channel,
 		  OutputSet *outputs, bool inject )
 { 
   // ( Traffic Class , Routing Order ) -> Virtual Channel Range
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -435,10 +431,10 @@ void xyyx_flatfly( const Router *r, const Flit *f, int in_channel,
   } else {
 
     int dest = flatfly_transformation(f->dest);
-    int targetr = (int)(dest/gC);
+    int targetr = (int)(dest/gContext->c);
 
     if(targetr==r->GetID()){ //if we are at the final router, yay, output to client
-      out_port = dest % gC;
+      out_port = dest % gContext->c;
 
     } else {
    
@@ -447,7 +443,7 @@ void xyyx_flatfly( const Router *r, const Flit *f, int in_channel,
       assert(available_vcs > 0);
 
       // randomly select dimension order at first hop
-      bool x_then_y = ((in_channel < gC) ?
+      bool x_then_y = ((in_channel < gContext->c) ?
 		       (RandomInt(1) > 0) : 
 		       (f->vc < (vcBegin + available_vcs)));
 
@@ -468,20 +464,20 @@ void xyyx_flatfly( const Router *r, const Flit *f, int in_channel,
 }
 
 int flatfly_outport_yx(int dest, int rID) {
-  int dest_rID = (int) (dest / gC);
-  int _dim   = gN;
+  int dest_rID = (int) (dest / gContext->c);
+  int _dim   = gContext->n;
   int output = -1, dID, sID;
   
   if(dest_rID==rID){
-    return dest % gC;
+    return dest % gContext->c;
   }
 
   for (int d=_dim-1;d >= 0; d--) {
-    int power = powi(gK,d);
+    int power = powi(gContext->k,d);
     dID = int(dest_rID / power);
     sID = int(rID / power);
     if ( dID != sID ) {
-      output = gC + ((gK-1)*d) - 1;
+      output = gContext->c + ((gContext->k-1)*d) - 1;
       if (dID > sID) {
 	output += dID;
       } else {
@@ -503,19 +499,19 @@ void valiant_flatfly( const Router *r, const Flit *f, int in_channel,
 		  OutputSet *outputs, bool inject )
 {
   // ( Traffic Class , Routing Order ) -> Virtual Channel Range
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -527,15 +523,15 @@ void valiant_flatfly( const Router *r, const Flit *f, int in_channel,
 
   } else {
 
-    if ( in_channel < gC ){
+    if ( in_channel < gContext->c ){
       f->ph = 0;
-      f->intm = RandomInt( powi( gK, gN )*gC-1);
+      f->intm = RandomInt( powi( gContext->k, gContext->n )*gContext->c-1);
     }
 
     int intm = flatfly_transformation(f->intm);
     int dest = flatfly_transformation(f->dest);
 
-    if((int)(intm/gC) == r->GetID() || (int)(dest/gC)== r->GetID()){
+    if((int)(intm/gContext->c) == r->GetID() || (int)(dest/gContext->c)== r->GetID()){
       f->ph = 1;
     }
 
@@ -546,7 +542,7 @@ void valiant_flatfly( const Router *r, const Flit *f, int in_channel,
       out_port = flatfly_outport(dest, r->GetID());
     }
 
-    if((int)(dest/gC) != r->GetID()) {
+    if((int)(dest/gContext->c) != r->GetID()) {
 
       //each class must have at least 2 vcs assigned or else valiant valiant will deadlock
       int const available_vcs = (vcEnd - vcBegin + 1) / 2;
@@ -572,19 +568,19 @@ void min_flatfly( const Router *r, const Flit *f, int in_channel,
 		  OutputSet *outputs, bool inject )
 {
   // ( Traffic Class , Routing Order ) -> Virtual Channel Range
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -597,15 +593,15 @@ void min_flatfly( const Router *r, const Flit *f, int in_channel,
   } else {
 
     int dest  = flatfly_transformation(f->dest);
-    int targetr= (int)(dest/gC);
-    //int xdest = ((int)(dest/gC)) % gK;
-    //int xcurr = ((r->GetID())) % gK;
+    int targetr= (int)(dest/gContext->c);
+    //int xdest = ((int)(dest/gContext->c)) % gContext->k;
+    //int xcurr = ((r->GetID())) % gContext->k;
 
-    //int ydest = ((int)(dest/gC)) / gK;
-    //int ycurr = ((r->GetID())) / gK;
+    //int ydest = ((int)(dest/gContext->c)) / gContext->k;
+    //int ycurr = ((r->GetID())) / gContext->k;
 
     if(targetr==r->GetID()){ //if we are at the final router, yay, output to client
-      out_port = dest % gC;
+      out_port = dest % gContext->c;
     } else{ //else select a dimension at random
       out_port = flatfly_outport(dest, r->GetID());
     }
@@ -627,19 +623,19 @@ void ugal_xyyx_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
 			  OutputSet *outputs, bool inject )
 {
   // ( Traffic Class , Routing Order ) -> Virtual Channel Range
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -654,7 +650,7 @@ void ugal_xyyx_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
     int dest  = flatfly_transformation(f->dest);
 
     int rID =  r->GetID();
-    int _concentration = gC;
+    int _concentration = gContext->c;
     int found;
     int debug = 0;
     int tmp_out_port, _ran_intm;
@@ -662,14 +658,14 @@ void ugal_xyyx_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
     int threshold = 2;
 
 
-    if ( in_channel < gC ){
-      if(gTrace){
+    if ( in_channel < gContext->c ){
+      if(gContext->trace){
 	cout<<"New Flit "<<f->src<<endl;
       }
       f->ph   = 0;
     }
 
-    if(gTrace){
+    if(gContext->trace){
       int load = 0;
       cout<<"Router "<<rID<<endl;
       cout<<"Input Channel "<<in_channel<<endl;
@@ -699,7 +695,7 @@ void ugal_xyyx_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
       }
       else  {
 	found = 1;
-	out_port = dest % gC;
+	out_port = dest % gContext->c;
 	if (debug)   cout << "      final routing to destination ";
       }
     }
@@ -710,7 +706,7 @@ void ugal_xyyx_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
       assert(xy_available_vcs > 0);
 
       // randomly select dimension order at first hop
-      bool x_then_y = ((in_channel < gC) ?
+      bool x_then_y = ((in_channel < gContext->c) ?
 		       (RandomInt(1) > 0) : 
 		       (f->vc < (vcBegin + xy_available_vcs)));
 
@@ -770,18 +766,18 @@ void ugal_xyyx_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
       //dest here should be == intm if ph==1, or dest == dest if ph == 2
       if(x_then_y){
 	out_port =  flatfly_outport(dest, rID);
-	if(out_port >= gC) {
+	if(out_port >= gContext->c) {
 	  vcEnd -= xy_available_vcs;
 	}
       } else {
 	out_port =  flatfly_outport_yx(dest, rID);
-	if(out_port >= gC) {
+	if(out_port >= gContext->c) {
 	  vcBegin += xy_available_vcs;
 	}
       }
 
       // if we haven't reached our destination, restrict VCs appropriately to avoid routing deadlock
-      if(out_port >= gC) {
+      if(out_port >= gContext->c) {
 
 	int const ph_available_vcs = xy_available_vcs / 2;
 	assert(ph_available_vcs > 0);
@@ -802,15 +798,15 @@ void ugal_xyyx_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
       cout << *f; exit (-1);
     }
 
-    if (out_port >= gN*(gK-1) + gC)  {
+    if (out_port >= gContext->n*(gContext->k-1) + gContext->c)  {
       cout << " ERROR: output port too big! " << endl;
       cout << " OUTPUT select: " << out_port << endl;
-      cout << " router radix: " <<  gN*(gK-1) + gK << endl;
+      cout << " router radix: " <<  gContext->n*(gContext->k-1) + gContext->k << endl;
       exit (-1);
     }
 
     if (debug) cout << "        through output port : " << out_port << endl;
-    if(gTrace){cout<<"Outport "<<out_port<<endl;cout<<"Stop Mark"<<endl;}
+    if(gContext->trace){cout<<"Outport "<<out_port<<endl;cout<<"Stop Mark"<<endl;}
 
   }
 
@@ -826,19 +822,19 @@ void ugal_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
 			  OutputSet *outputs, bool inject )
 {
   // ( Traffic Class , Routing Order ) -> Virtual Channel Range
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -853,21 +849,21 @@ void ugal_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
     int dest  = flatfly_transformation(f->dest);
 
     int rID =  r->GetID();
-    int _concentration = gC;
+    int _concentration = gContext->c;
     int found;
     int debug = 0;
     int tmp_out_port, _ran_intm;
     int _min_hop, _nonmin_hop, _min_queucnt, _nonmin_queucnt;
     int threshold = 2;
 
-    if ( in_channel < gC ){
-      if(gTrace){
+    if ( in_channel < gContext->c ){
+      if(gContext->trace){
 	cout<<"New Flit "<<f->src<<endl;
       }
       f->ph   = 0;
     }
 
-    if(gTrace){
+    if(gContext->trace){
       int load = 0;
       cout<<"Router "<<rID<<endl;
       cout<<"Input Channel "<<in_channel<<endl;
@@ -899,7 +895,7 @@ void ugal_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
       }
       else  {
 	found = 1;
-	out_port = dest % gC;
+	out_port = dest % gContext->c;
 	if (debug)   cout << "      final routing to destination ";
       }
     }
@@ -911,7 +907,7 @@ void ugal_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
 	_ran_intm = find_ran_intm(flatfly_transformation(f->src), dest);
 	tmp_out_port =  flatfly_outport(dest, rID);
 	if (f->watch){
-	  *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+	  *gContext->watch_out << GetSimTime() << " | " << r->FullName() << " | "
 		     << " MIN tmp_out_port: " << tmp_out_port;
 	}
 
@@ -921,7 +917,7 @@ void ugal_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
 	tmp_out_port =  flatfly_outport(_ran_intm, rID);
 
 	if (f->watch){
-	  *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+	  *gContext->watch_out << GetSimTime() << " | " << r->FullName() << " | "
 		     << " NONMIN tmp_out_port: " << tmp_out_port << endl;
 	}
 	if (_ran_intm >= rID*_concentration && _ran_intm < (rID+1)*_concentration) {
@@ -955,7 +951,7 @@ void ugal_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
       out_port =  flatfly_outport(dest, rID);
 
       // if we haven't reached our destination, restrict VCs appropriately to avoid routing deadlock
-      if(out_port >= gC) {
+      if(out_port >= gContext->c) {
 	int const available_vcs = (vcEnd - vcBegin + 1) / 2;
 	assert(available_vcs > 0);
 	if(f->ph == 1) {
@@ -974,15 +970,15 @@ void ugal_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
       cout << *f; exit (-1);
     }
 
-    if (out_port >= gN*(gK-1) + gC)  {
+    if (out_port >= gContext->n*(gContext->k-1) + gContext->c)  {
       cout << " ERROR: output port too big! " << endl;
       cout << " OUTPUT select: " << out_port << endl;
-      cout << " router radix: " <<  gN*(gK-1) + gK << endl;
+      cout << " router radix: " <<  gContext->n*(gContext->k-1) + gContext->k << endl;
       exit (-1);
     }
 
     if (debug) cout << "        through output port : " << out_port << endl;
-    if(gTrace) {
+    if(gContext->trace) {
       cout<<"Outport "<<out_port<<endl;
       cout<<"Stop Mark"<<endl;
     }
@@ -999,19 +995,19 @@ void ugal_pni_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
 			      OutputSet *outputs, bool inject )
 {
   // ( Traffic Class , Routing Order ) -> Virtual Channel Range
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -1026,21 +1022,21 @@ void ugal_pni_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
     int dest  = flatfly_transformation(f->dest);
 
     int rID =  r->GetID();
-    int _concentration = gC;
+    int _concentration = gContext->c;
     int found;
     int debug = 0;
     int tmp_out_port, _ran_intm;
     int _min_hop, _nonmin_hop, _min_queucnt, _nonmin_queucnt;
     int threshold = 2;
 
-    if ( in_channel < gC ){
-      if(gTrace){
+    if ( in_channel < gContext->c ){
+      if(gContext->trace){
 	cout<<"New Flit "<<f->src<<endl;
       }
       f->ph   = 0;
     }
 
-    if(gTrace){
+    if(gContext->trace){
       int load = 0;
       cout<<"Router "<<rID<<endl;
       cout<<"Input Channel "<<in_channel<<endl;
@@ -1072,7 +1068,7 @@ void ugal_pni_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
       }
       else  {
 	found = 1;
-	out_port = dest % gC;
+	out_port = dest % gContext->c;
 	if (debug)   cout << "      final routing to destination ";
       }
     }
@@ -1084,7 +1080,7 @@ void ugal_pni_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
 	_ran_intm = find_ran_intm(flatfly_transformation(f->src), dest);
 	tmp_out_port =  flatfly_outport(dest, rID);
 	if (f->watch){
-	  *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+	  *gContext->watch_out << GetSimTime() << " | " << r->FullName() << " | "
 		     << " MIN tmp_out_port: " << tmp_out_port;
 	}
 
@@ -1094,7 +1090,7 @@ void ugal_pni_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
 	tmp_out_port =  flatfly_outport(_ran_intm, rID);
 
 	if (f->watch){
-	  *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+	  *gContext->watch_out << GetSimTime() << " | " << r->FullName() << " | "
 		     << " NONMIN tmp_out_port: " << tmp_out_port << endl;
 	}
 	if (_ran_intm >= rID*_concentration && _ran_intm < (rID+1)*_concentration) {
@@ -1128,7 +1124,7 @@ void ugal_pni_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
       out_port =  flatfly_outport(dest, rID);
 
       // if we haven't reached our destination, restrict VCs appropriately to avoid routing deadlock
-      if(out_port >= gC) {
+      if(out_port >= gContext->c) {
 	int const available_vcs = (vcEnd - vcBegin + 1) / 2;
 	assert(available_vcs > 0);
 	if(f->ph == 1) {
@@ -1147,46 +1143,46 @@ void ugal_pni_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
       cout << *f; exit (-1);
     }
 
-    if (out_port >= gN*(gK-1) + gC)  {
+    if (out_port >= gContext->n*(gContext->k-1) + gContext->c)  {
       cout << " ERROR: output port too big! " << endl;
       cout << " OUTPUT select: " << out_port << endl;
-      cout << " router radix: " <<  gN*(gK-1) + gK << endl;
+      cout << " router radix: " <<  gContext->n*(gContext->k-1) + gContext->k << endl;
       exit (-1);
     }
 
     if (debug) cout << "        through output port : " << out_port << endl;
-    if(gTrace) {
+    if(gContext->trace) {
       cout<<"Outport "<<out_port<<endl;
       cout<<"Stop Mark"<<endl;
     }
   }
 
-  if(inject || (out_port >= gC)) {
+  if(inject || (out_port >= gContext->c)) {
 
     // NOTE: for "proper" flattened butterfly configurations (i.e., ones 
-    // derived from flattening an actual butterfly), gK and gC are the same!
-    assert(gK == gC);
+    // derived from flattening an actual butterfly), gContext->k and gContext->c are the same!
+    assert(gContext->k == gContext->c);
 
     assert(inject ? (f->ph == -1) : (f->ph == 1 || f->ph == 2));
 
     int next_coord = flatfly_transformation(f->dest);
     if(inject) {
-      next_coord /= gC;
-      next_coord %= gK;
+      next_coord /= gContext->c;
+      next_coord %= gContext->k;
     } else {
-      int next_dim = (out_port - gC) / (gK - 1) + 1;
-      if(next_dim == gN) {
-	next_coord %= gC;
+      int next_dim = (out_port - gContext->c) / (gContext->k - 1) + 1;
+      if(next_dim == gContext->n) {
+	next_coord %= gContext->c;
       } else {
-	next_coord /= gC;
+	next_coord /= gContext->c;
 	for(int d = 0; d < next_dim; ++d) {
-	  next_coord /= gK;
+	  next_coord /= gContext->k;
 	}
-	next_coord %= gK;
+	next_coord %= gContext->k;
       }
     }
-    assert(next_coord >= 0 && next_coord < gK);
-    int vcs_per_dest = (vcEnd - vcBegin + 1) / gK;
+    assert(next_coord >= 0 && next_coord < gContext->k);
+    int vcs_per_dest = (vcEnd - vcBegin + 1) / gContext->k;
     assert(vcs_per_dest > 0);
     vcBegin += next_coord * vcs_per_dest;
     vcEnd = vcBegin + vcs_per_dest - 1;
@@ -1203,22 +1199,22 @@ void ugal_pni_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
 //=============================================================^M
 int find_distance (int src, int dest) {
   int dist = 0;
-  int _dim   = gN;
+  int _dim   = gContext->n;
   
-  int src_tmp= (int) src / gC;
-  int dest_tmp = (int) dest / gC;
+  int src_tmp= (int) src / gContext->c;
+  int dest_tmp = (int) dest / gContext->c;
   
   //  cout << " HOP CNT between  src: " << src << " dest: " << dest;
   for (int d=0;d < _dim; d++) {
-    //int _dim_size = powi(gK, d )*gC;
+    //int _dim_size = powi(gContext->k, d )*gContext->c;
     //if ((int)(src / _dim_size) !=  (int)(dest / _dim_size))
     //   dist++;
-    int src_id = src_tmp % gK;
-    int dest_id = dest_tmp % gK;
+    int src_id = src_tmp % gContext->k;
+    int dest_id = dest_tmp % gContext->k;
     if (src_id !=  dest_id)
       dist++;
-    src_tmp = (int) (src_tmp / gK);
-    dest_tmp = (int) (dest_tmp / gK);
+    src_tmp = (int) (src_tmp / gContext->k);
+    dest_tmp = (int) (dest_tmp / gContext->k);
   }
   
   //  cout << " : " << dist << endl;
@@ -1230,7 +1226,7 @@ int find_distance (int src, int dest) {
 // UGAL : find random node for load balancing
 //=============================================================^M
 int find_ran_intm (int src, int dest) {
-  int _dim   = gN;
+  int _dim   = gContext->n;
   int _dim_size;
   int _ran_dest = 0;
   int debug = 0;
@@ -1238,27 +1234,27 @@ int find_ran_intm (int src, int dest) {
   if (debug) 
     cout << " INTM node for  src: " << src << " dest: " <<dest << endl;
   
-  src = (int) (src / gC);
-  dest = (int) (dest / gC);
+  src = (int) (src / gContext->c);
+  dest = (int) (dest / gContext->c);
   
-  _ran_dest = RandomInt(gC - 1);
+  _ran_dest = RandomInt(gContext->c - 1);
   if (debug) cout << " ............ _ran_dest : " << _ran_dest << endl;
   for (int d=0;d < _dim; d++) {
     
-    _dim_size = powi(gK, d)*gC;
-    if ((src % gK) ==  (dest % gK)) {
-      _ran_dest += (src % gK) * _dim_size;
+    _dim_size = powi(gContext->k, d)*gContext->c;
+    if ((src % gContext->k) ==  (dest % gContext->k)) {
+      _ran_dest += (src % gContext->k) * _dim_size;
       if (debug) 
-	cout << "    share same dimension : " << d << " int node : " << _ran_dest << " src ID : " << src % gK << endl;
+	cout << "    share same dimension : " << d << " int node : " << _ran_dest << " src ID : " << src % gContext->k << endl;
     } else {
       // src and dest are in the same dimension "d" + 1
       // ==> thus generate a random destination within
-      _ran_dest += RandomInt(gK - 1) * _dim_size;
+      _ran_dest += RandomInt(gContext->k - 1) * _dim_size;
       if (debug) 
 	cout << "    different  dimension : " << d << " int node : " << _ran_dest << " _dim_size: " << _dim_size << endl;
     }
-    src = (int) (src / gK);
-    dest = (int) (dest / gK);
+    src = (int) (src / gContext->k);
+    dest = (int) (dest / gContext->k);
   }
   
   if (debug) cout << " intermediate destination NODE: " << _ran_dest << endl;
@@ -1273,20 +1269,20 @@ int find_ran_intm (int src, int dest) {
 //=============================================================
 // starting from DIM 0 (x first)
 int flatfly_outport(int dest, int rID) {
-  int dest_rID = (int) (dest / gC);
-  int _dim   = gN;
+  int dest_rID = (int) (dest / gContext->c);
+  int _dim   = gContext->n;
   int output = -1, dID, sID;
   
   if(dest_rID==rID){
-    return dest % gC;
+    return dest % gContext->c;
   }
 
 
   for (int d=0;d < _dim; d++) {
-    dID = (dest_rID % gK);
-    sID = (rID % gK);
+    dID = (dest_rID % gContext->k);
+    sID = (rID % gContext->k);
     if ( dID != sID ) {
-      output = gC + ((gK-1)*d) - 1;
+      output = gContext->c + ((gContext->k-1)*d) - 1;
       if (dID > sID) {
 
 	output += dID;
@@ -1296,8 +1292,8 @@ int flatfly_outport(int dest, int rID) {
       
       return output;
     }
-    dest_rID = (int) (dest_rID / gK);
-    rID      = (int) (rID / gK);
+    dest_rID = (int) (dest_rID / gContext->k);
+    rID      = (int) (rID / gContext->k);
   }
   if (output == -1) {
     cout << " ERROR ---- FLATFLY_OUTPORT function : output not found " << endl;
@@ -1316,14 +1312,14 @@ int flatfly_transformation(int dest){
   //cout<<"ORiginal destination "<<dest<<endl;
   //router in the x direction = find which column, and then mod by cY to find 
   //which horizontal router
-  int horizontal = (dest%(_xcount*_xrouter))/(_xrouter);
-  int horizontal_rem = (dest%(_xcount*_xrouter))%(_xrouter);
+  int horizontal = (dest%(gContext->flatfly_xcount*gContext->flatfly_xrouter))/(gContext->flatfly_xrouter);
+  int horizontal_rem = (dest%(gContext->flatfly_xcount*gContext->flatfly_xrouter))%(gContext->flatfly_xrouter);
   //router in the y direction = find which row, and then divided by cX to find 
   //vertical router
-  int vertical = (dest/(_xcount*_xrouter))/(_yrouter);
-  int vertical_rem = (dest/(_xcount*_xrouter))%(_yrouter);
+  int vertical = (dest/(gContext->flatfly_xcount*gContext->flatfly_xrouter))/(gContext->flatfly_yrouter);
+  int vertical_rem = (dest/(gContext->flatfly_xcount*gContext->flatfly_xrouter))%(gContext->flatfly_yrouter);
   //transform the destination to as if node0 was 0,1,2,3 and so forth
-  dest = (vertical*_xcount + horizontal)*gC+_xrouter*vertical_rem+horizontal_rem;
+  dest = (vertical*gContext->flatfly_xcount + horizontal)*gContext->c+gContext->flatfly_xrouter*vertical_rem+horizontal_rem;
   //cout<<"Transformed destination "<<dest<<endl<<endl;
   return dest;
 }
@@ -57,7 +57,7 @@ void KNCube::_ComputeSize( const Configuration &config )
   _k = config.GetInt( "k" );
   _n = config.GetInt( "n" );
 
-  gK = _k; gN = _n;
+  gContext->k = _k; gContext->n = _n;
   _size     = powi( _k, _n );
   _channels = 2*_n*_size;
 
@@ -239,7 +239,7 @@ void KNCube::InsertRandomFaults( const Configuration &config )
     int fail_seed;
     if ( config.GetStr( "fail_seed" ) == "time" ) {
       fail_seed = int( time( NULL ) );
-      cout << "SEED: fail_seed=" << fail_seed << endl;
+      *gContext->out << "SEED: fail_seed=" << fail_seed << endl;
     } else {
       fail_seed = config.GetInt( "fail_seed" );
     }
@@ -293,7 +293,7 @@ void KNCube::InsertRandomFaults( const Configuration &config )
 	}
 	
 	if ( !available ) {
-	  cout << "skipping " << node << endl;
+	  *gContext->out << "skipping " << node << endl;
 	}
       }
 
@@ -311,7 +311,7 @@ void KNCube::InsertRandomFaults( const Configuration &config )
 	fail_nodes[_RightNode( node, n )] = true;
       }
 
-      cout << "failure at node " << node << ", channel " 
+      *gContext->out << "failure at node " << node << ", channel " 
 	   << chan << endl;
     }
 
@@ -37,6 +37,7 @@
 
 #include "booksim.hpp"
 #include "network.hpp"
+#include "checkpoint.hpp"
 
 #include "kncube.hpp"
 #include "fly.hpp"
@@ -57,10 +58,25 @@ Network::Network( const Configuration &config, const string & name ) :
   _nodes    = -1; 
   _channels = -1;
   _classes  = config.GetInt("classes");
+
+  _pool = NULL;
+  _parallel_phase = -1;
+  int const threads = config.GetInt("sim_threads");
+  if ( threads > 1 ) {
+    if ( _ParallelEvaluateSafe( config ) ) {
+      _pool = new ThreadPool( threads );
+      gContext->flit_pool.locked = true;
+      gContext->credit_pool.locked = true;
+    } else {
+      *gContext->out << "Warning: " << name << " uses randomized or tracing components; "
+	   << "ignoring sim_threads = " << threads << endl;
+    }
+  }
 }
 
 Network::~Network( )
 {
+  if ( _pool ) delete _pool;
   for ( int r = 0; r < _size; ++r ) {
     if ( _routers[r] ) delete _routers[r];
   }
@@ -135,7 +151,7 @@ void Network::_Alloc( )
 	  ( _channels != -1 ) );
 
   _routers.resize(_size);
-  gNodes = _nodes;
+  gContext->nodes = _nodes;
 
   /*booksim used arrays of flits as the channels which makes have capacity of
    *one. To simulate channel latency, flitchannel class has been added
@@ -183,30 +199,199 @@ void Network::_Alloc( )
   }
 }
 
+// The three phases only touch state owned by the module being stepped:
+// channels move their own input/output registers, while routers read their
+// input channels and write their output channels in disjoint phases.  Credit
+// allocation is locked, so modules can be stepped concurrently as long as
+// router evaluation does not consume the shared random number stream or
+// write trace output (see _ParallelEvaluateSafe).
+
+bool Network::_ParallelEvaluateSafe( const Configuration &config ) const
+{
+  // routing functions that are free of random draws and only inspect the
+  // router they are invoked for through GetID()
+  static char const * const deterministic_rf[] = {
+    "dor_mesh", "dim_order_mesh", "dim_order_ni_mesh", "dim_order_pni_mesh",
+    "nca_qtree", "dest_tag_fly", "min_anynet", "dor_cmesh",
+    "dor_no_express_cmesh", "ran_min_flatfly", NULL
+  };
+
+  if ( gContext->watch_out || gContext->trace ) {
+    return false;
+  }
+  if ( config.GetStr( "router" ) != "iq" ) {
+    return false;
+  }
+  // with per-router random streams, draws made during evaluation no 
+  // longer depend on the order in which routers are stepped
+  static char const * const randomized_rf[] = {
+    "xy_yx_mesh", "ecmp_anynet", NULL
+  };
+  bool const streams = ( config.GetInt( "random_streams" ) > 0 );
+
+  if ( !streams &&
+       ( ( config.GetStr( "vc_allocator" ).substr( 0, 3 ) == "pim" ) ||
+	 ( config.GetStr( "sw_allocator" ).substr( 0, 3 ) == "pim" ) ) ) {
+    return false;
+  }
+  string const rf = config.GetStr( "routing_function" ) + "_" + config.GetStr( "topology" );
+  for ( int i = 0; deterministic_rf[i]; ++i ) {
+    if ( rf == deterministic_rf[i] ) {
+      return true;
+    }
+  }
+  for ( int i = 0; streams && randomized_rf[i]; ++i ) {
+    if ( rf == randomized_rf[i] ) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void Network::_ParallelTask( void * net, int thread )
+{
+  Network * const n = static_cast<Network *>( net );
+  int const threads = n->_pool->NumThreads( );
+
+  for ( int list = 0; list < 2; ++list ) {
+    vector<TimedModule *> const & modules = 
+      list ? n->_parallel_routers : n->_parallel_channels;
+    size_t const begin = ( modules.size( ) * thread ) / threads;
+    size_t const end = ( modules.size( ) * ( thread + 1 ) ) / threads;
+    for ( size_t i = begin; i < end; ++i ) {
+      switch ( n->_parallel_phase ) {
+      case 0: modules[i]->Step( &TimedModule::ReadInputs ); break;
+      case 1: modules[i]->Step( &TimedModule::Evaluate ); break;
+      case 2: modules[i]->Step( &TimedModule::WriteOutputs ); break;
+      }
+    }
+  }
+}
+
+void Network::_RunParallel( int phase )
+{
+  if ( _parallel_routers.empty( ) && _parallel_channels.empty( ) ) {
+    for(deque<TimedModule *>::const_iterator iter = _timed_modules.begin();
+	iter != _timed_modules.end();
+	++iter) {
+      if ( dynamic_cast<Router *>( *iter ) ) {
+	_parallel_routers.push_back( *iter );
+      } else {
+	_parallel_channels.push_back( *iter );
+      }
+    }
+  }
+  _parallel_phase = phase;
+  _pool->Run( &Network::_ParallelTask, this );
+}
+
 void Network::ReadInputs( )
 {
-  for(deque<TimedModule *>::const_iterator iter = _timed_modules.begin();
-      iter != _timed_modules.end();
-      ++iter) {
-    (*iter)->ReadInputs( );
+  if ( _pool ) {
+    _RunParallel( 0 );
+    return;
+  }
+  if ( _active_set.Empty( ) ) {
+    _active_set.Init( _timed_modules );
   }
+  _active_set.Step( &TimedModule::ReadInputs );
 }
 
 void Network::Evaluate( )
 {
-  for(deque<TimedModule *>::const_iterator iter = _timed_modules.begin();
-      iter != _timed_modules.end();
-      ++iter) {
-    (*iter)->Evaluate( );
+  if ( _pool ) {
+    _RunParallel( 1 );
+    return;
   }
+  if ( _active_set.Empty( ) ) {
+    _active_set.Init( _timed_modules );
+  }
+  _active_set.Step( &TimedModule::Evaluate );
 }
 
 void Network::WriteOutputs( )
 {
-  for(deque<TimedModule *>::const_iterator iter = _timed_modules.begin();
-      iter != _timed_modules.end();
-      ++iter) {
-    (*iter)->WriteOutputs( );
+  if ( _pool ) {
+    _RunParallel( 2 );
+    return;
+  }
+  if ( _active_set.Empty( ) ) {
+    _active_set.Init( _timed_modules );
+  }
+  _active_set.Step( &TimedModule::WriteOutputs );
+  _active_set.Retire( );
+}
+
+bool Network::Idle( ) const
+{
+  if ( !_pool && !_active_set.Empty( ) ) {
+    return _active_set.NoneActive( );
+  }
+  for ( deque<TimedModule *>::const_iterator iter = _timed_modules.begin( );
+	iter != _timed_modules.end( );
+	++iter ) {
+    if ( !(*iter)->Idle( ) ) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Network::SetRandomStreams( long seed, int stream )
+{
+  _random_streams.resize( _size );
+  for ( int r = 0; r < _size; ++r ) {
+    _random_streams[r].Reset( seed, r, stream );
+    _routers[r]->SetRandomStream( &_random_streams[r] );
+  }
+}
+
+void Network::SyncState( Checkpoint & cp )
+{
+  cp.Check( _size, "number of routers" );
+  cp.Check( _nodes, "number of nodes" );
+  cp.Check( _channels, "number of channels" );
+
+  for ( int r = 0; r < _size; ++r ) {
+    _routers[r]->SyncState( cp );
+  }
+  for ( int s = 0; s < _nodes; ++s ) {
+    _inject[s]->SyncState( cp );
+    _inject_cred[s]->SyncState( cp );
+    _eject[s]->SyncState( cp );
+    _eject_cred[s]->SyncState( cp );
+  }
+  for ( int c = 0; c < _channels; ++c ) {
+    _chan[c]->SyncState( cp );
+    _chan_cred[c]->SyncState( cp );
+  }
+
+  // routers keep pointers to their streams, which must thus stay in place
+  cp.Check( _random_streams.size( ), "number of router random streams" );
+  for ( size_t r = 0; r < _random_streams.size( ); ++r ) {
+    cp.Sync( _random_streams[r] );
+  }
+
+  if ( cp.Restoring( ) ) {
+    // modules may have gone idle in an earlier simulation
+    for ( deque<TimedModule *>::const_iterator iter = _timed_modules.begin( );
+	  iter != _timed_modules.end( ); ++iter ) {
+      (*iter)->Wake( );
+    }
+  }
+}
+
+void Network::SetClock( int const * clock )
+{
+  for ( int s = 0; s < _nodes; ++s ) {
+    _inject[s]->SetClock( clock );
+    _inject_cred[s]->SetClock( clock );
+    _eject[s]->SetClock( clock );
+    _eject_cred[s]->SetClock( clock );
+  }
+  for ( int c = 0; c < _channels; ++c ) {
+    _chan[c]->SetClock( clock );
+    _chan_cred[c]->SetClock( clock );
   }
 }
 
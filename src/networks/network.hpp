@@ -41,6 +41,7 @@
 #include "channel.hpp"
 #include "config_utils.hpp"
 #include "globals.hpp"
+#include "thread_pool.hpp"
 
 typedef Channel<Credit> CreditChannel;
 
@@ -66,6 +67,22 @@ protected:
 
   deque<TimedModule *> _timed_modules;
 
+  // modules that need to be stepped in the current cycle
+  ActiveSet _active_set;
+
+  // per-router random streams (random_streams > 0)
+  vector<RandomStream> _random_streams;
+
+  // parallel cycle engine (sim_threads > 1)
+  ThreadPool * _pool;
+  vector<TimedModule *> _parallel_routers;
+  vector<TimedModule *> _parallel_channels;
+  int _parallel_phase;
+
+  bool _ParallelEvaluateSafe( const Configuration &config ) const;
+  void _RunParallel( int phase );
+  static void _ParallelTask( void * net, int thread );
+
   virtual void _ComputeSize( const Configuration &config ) = 0;
   virtual void _BuildNet( const Configuration &config ) = 0;
 
@@ -90,10 +107,21 @@ public:
 
   virtual double Capacity( ) const;
 
+  // point all channels at the simulator's cycle counter
+  void SetClock( int const * clock );
+
+  // give every router its own random stream, keyed by its ID
+  void SetRandomStreams( long seed, int stream );
+
+  // save or restore the state of all routers and channels
+  void SyncState( Checkpoint & cp );
+
   virtual void ReadInputs( );
   virtual void Evaluate( );
   virtual void WriteOutputs( );
 
+  virtual bool Idle( ) const;
+
   void Display( ostream & os = cout ) const;
   void DumpChannelMap( ostream & os = cout, string const & prefix = "" ) const;
   void DumpNodeMap( ostream & os = cout, string const & prefix = "" ) const;
@@ -69,7 +69,7 @@ void Tree4::_ComputeSize( const Configuration& config )
   _n = config.GetInt( "n" );
   assert(_n == 3);
   
-  gK = _k; gN = _n;
+  gContext->k = _k; gContext->n = _n;
   
   _nodes = powi( _k, _n );
   
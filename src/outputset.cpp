@@ -37,6 +37,65 @@
 
 #include "booksim.hpp"
 #include "outputset.hpp"
+#include "checkpoint.hpp"
+
+void OutputSet::ElementSet::clear( )
+{
+  _size = 0;
+  _overflow.clear( );
+}
+
+void OutputSet::ElementSet::insert( sSetElement const & s )
+{
+  sSetElement * const elements = 
+    ( _size <= INLINE_ELEMENTS ) ? _inline : &_overflow[0];
+
+  // higher priorities first; equal priorities keep the existing element
+  int pos = 0;
+  while ( ( pos < _size ) && ( elements[pos].pri > s.pri ) ) {
+    ++pos;
+  }
+  if ( ( pos < _size ) && ( elements[pos].pri == s.pri ) ) {
+    return;
+  }
+
+  if ( _size < INLINE_ELEMENTS ) {
+    for ( int i = _size; i > pos; --i ) {
+      _inline[i] = _inline[i-1];
+    }
+    _inline[pos] = s;
+  } else {
+    if ( _size == INLINE_ELEMENTS ) {
+      _overflow.assign( _inline, _inline + INLINE_ELEMENTS );
+    }
+    _overflow.insert( _overflow.begin( ) + pos, s );
+  }
+  ++_size;
+}
+
+void OutputSet::SyncState( Checkpoint & cp )
+{
+  int size = _outputs.size( );
+  cp.Sync( size );
+  if ( cp.Restoring( ) ) {
+    _outputs.clear( );
+  }
+  ElementSet::const_iterator iter = _outputs.begin( );
+  for ( int i = 0; i < size; ++i ) {
+    sSetElement s;
+    if ( cp.Saving( ) ) {
+      s = *iter++;
+    }
+    cp.Sync( s.vc_start );
+    cp.Sync( s.vc_end );
+    cp.Sync( s.pri );
+    cp.Sync( s.output_port );
+    if ( cp.Restoring( ) ) {
+      // elements were saved in order, so this rebuilds the same set
+      _outputs.insert( s );
+    }
+  }
+}
 
 void OutputSet::Clear( )
 {
@@ -64,7 +123,7 @@ void OutputSet::AddRange( int output_port, int vc_start, int vc_end, int pri )
 int OutputSet::NumVCs( int output_port ) const
 {
   int total = 0;
-  set<sSetElement>::const_iterator i = _outputs.begin( );
+  ElementSet::const_iterator i = _outputs.begin( );
   while(i!=_outputs.end( )){
     if(i->output_port == output_port){
       total += (i->vc_end - i->vc_start + 1);
@@ -76,7 +135,7 @@ int OutputSet::NumVCs( int output_port ) const
 
 bool OutputSet::OutputEmpty( int output_port ) const
 {
-  set<sSetElement>::const_iterator i = _outputs.begin( );
+  ElementSet::const_iterator i = _outputs.begin( );
   while(i!=_outputs.end( )){
     if(i->output_port == output_port){
       return false;
@@ -87,10 +146,6 @@ bool OutputSet::OutputEmpty( int output_port ) const
 }
 
 
-const set<OutputSet::sSetElement> & OutputSet::GetSet() const{
-  return _outputs;
-}
-
 //legacy support, for performance, just use GetSet()
 int OutputSet::GetVC( int output_port, int vc_index, int *pri ) const
 {
@@ -101,7 +156,7 @@ int OutputSet::GetVC( int output_port, int vc_index, int *pri ) const
   
   if ( pri ) { *pri = -1; }
 
-  set<sSetElement>::const_iterator i = _outputs.begin( );
+  ElementSet::const_iterator i = _outputs.begin( );
   while(i!=_outputs.end( )){
     if(i->output_port == output_port){
       range = i->vc_end - i->vc_start + 1;
@@ -128,7 +183,7 @@ bool OutputSet::GetPortVC( int *out_port, int *out_vc ) const
   bool single_output = false;
   int  used_outputs  = 0;
 
-  set<sSetElement>::const_iterator i = _outputs.begin( );
+  ElementSet::const_iterator i = _outputs.begin( );
   if(i!=_outputs.end( )){
     used_outputs = i->output_port;
   }
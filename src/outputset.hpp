@@ -28,7 +28,11 @@
 #ifndef _OUTPUTSET_HPP_
 #define _OUTPUTSET_HPP_
 
-#include <set>
+#include <vector>
+
+using namespace std;
+
+class Checkpoint;
 
 class OutputSet {
 
@@ -41,6 +45,40 @@ public:
     int output_port;
   };
 
+  // Route sets rarely hold more than a handful of entries, so elements are
+  // kept in a small inline array sorted by descending priority; only sets
+  // with more than INLINE_ELEMENTS entries move to the heap. As with the
+  // std::set this replaces, an element whose priority is already present
+  // is dropped.
+  class ElementSet {
+  public:
+    typedef sSetElement const * const_iterator;
+
+    ElementSet( ) : _size(0) {}
+
+    inline const_iterator begin( ) const {
+      return ( _size <= INLINE_ELEMENTS ) ? _inline : &_overflow[0];
+    }
+    inline const_iterator end( ) const {
+      return begin( ) + _size;
+    }
+    inline size_t size( ) const {
+      return _size;
+    }
+    inline bool empty( ) const {
+      return ( _size == 0 );
+    }
+
+    void clear( );
+    void insert( sSetElement const & s );
+
+  private:
+    enum { INLINE_ELEMENTS = 8 };
+    int _size;
+    sSetElement _inline[INLINE_ELEMENTS];
+    vector<sSetElement> _overflow;
+  };
+
   void Clear( );
   void Add( int output_port, int vc, int pri = 0 );
   void AddRange( int output_port, int vc_start, int vc_end, int pri = 0 );
@@ -48,19 +86,18 @@ public:
   bool OutputEmpty( int output_port ) const;
   int NumVCs( int output_port ) const;
   
-  const set<sSetElement> & GetSet() const;
+  // The elements are contiguous and stay valid until the set is next 
+  // modified; callers should hold on to the reference rather than copy it.
+  inline const ElementSet & GetSet() const {
+    return _outputs;
+  }
 
   int  GetVC( int output_port,  int vc_index, int *pri = 0 ) const;
   bool GetPortVC( int *out_port, int *out_vc ) const;
+
+  void SyncState( Checkpoint & cp );
 private:
-  set<sSetElement> _outputs;
+  ElementSet _outputs;
 };
 
-inline bool operator<(const OutputSet::sSetElement & se1, 
-	       const OutputSet::sSetElement & se2) {
-  return se1.pri > se2.pri; // higher priorities first!
-}
-
 #endif
-
-
@@ -26,32 +26,53 @@
 */
 
 #include "packet_reply_info.hpp"
-
-stack<PacketReplyInfo*> PacketReplyInfo::_all;
-stack<PacketReplyInfo*> PacketReplyInfo::_free;
+#include "simulation_context.hpp"
+#include "checkpoint.hpp"
 
 PacketReplyInfo * PacketReplyInfo::New()
 {
+  Pool & pool = gContext->reply_pool;
   PacketReplyInfo * pr;
-  if(_free.empty()) {
+  if(pool.free.empty()) {
     pr = new PacketReplyInfo();
-    _all.push(pr);
+    pool.all.push(pr);
   } else {
-    pr = _free.top();
-    _free.pop();
+    pr = pool.free.top();
+    pool.free.pop();
   }
   return pr;
 }
 
+void PacketReplyInfo::SyncState(Checkpoint & cp)
+{
+  cp.Sync(source);
+  cp.Sync(time);
+  cp.Sync(record);
+  cp.SyncEnum(type);
+}
+
 void PacketReplyInfo::Free()
 {
-  _free.push(this);
+  gContext->reply_pool.free.push(this);
 }
 
 void PacketReplyInfo::FreeAll()
 {
-  while(!_all.empty()) {
-    delete _all.top();
-    _all.pop();
+  gContext->reply_pool.Release();
+}
+
+PacketReplyInfo::Pool::~Pool()
+{
+  Release();
+}
+
+void PacketReplyInfo::Pool::Release()
+{
+  while(!all.empty()) {
+    delete all.top();
+    all.pop();
+  }
+  while(!free.empty()) {
+    free.pop();
   }
 }
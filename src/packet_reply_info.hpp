@@ -32,6 +32,8 @@
 
 #include "flit.hpp"
 
+class Checkpoint;
+
 //register the requests to a node
 class PacketReplyInfo {
 
@@ -41,14 +43,21 @@ public:
   bool record;
   Flit::FlitType type;
 
+  void SyncState(Checkpoint & cp);
+
   static PacketReplyInfo* New();
   void Free();
   static void FreeAll();
 
-private:
+  // a simulation's reply records (owned by its SimulationContext)
+  struct Pool {
+    stack<PacketReplyInfo*> all;
+    stack<PacketReplyInfo*> free;
+    ~Pool();
+    void Release();
+  };
 
-  static stack<PacketReplyInfo*> _all;
-  static stack<PacketReplyInfo*> _free;
+private:
 
   PacketReplyInfo() {}
   ~PacketReplyInfo() {}
@@ -0,0 +1,159 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2015, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _PIPELINE_STAGE_HPP_
+#define _PIPELINE_STAGE_HPP_
+
+#include <vector>
+#include <cassert>
+
+#include "checkpoint.hpp"
+
+// ----------------------------------------------------------------------
+//
+//  PipelineStage: FIFO of the entries waiting in one stage of a router 
+//  pipeline, each tagged with the time at which it completes the stage. 
+//  Entries live in a ring buffer sized for the most entries the stage can 
+//  hold (e.g. one per input VC), so steady-state operation allocates 
+//  nothing; should the bound be exceeded, the buffer doubles. Timestamps 
+//  are kept apart from the entries, so scanning a stage for entries that 
+//  are due touches only them. Entry i counts from the oldest entry.
+//
+// ----------------------------------------------------------------------
+
+template<class T> class PipelineStage {
+  int _mask;
+  int _head;
+  int _size;
+
+  vector<int> _time;
+  vector<T> _entry;
+
+  inline int _Index( int i ) const {
+    return ( _head + i ) & _mask;
+  }
+
+  void _Resize( int capacity );
+
+public:
+  PipelineStage( int capacity = 1 );
+
+  // make room for at least capacity entries
+  void Reserve( int capacity );
+
+  inline bool Empty( ) const { return ( _size == 0 ); }
+  inline int Size( ) const { return _size; }
+
+  inline int & Time( int i ) {
+    assert( ( i >= 0 ) && ( i < _size ) );
+    return _time[_Index( i )];
+  }
+  inline int Time( int i ) const {
+    assert( ( i >= 0 ) && ( i < _size ) );
+    return _time[_Index( i )];
+  }
+  inline T & Entry( int i ) {
+    assert( ( i >= 0 ) && ( i < _size ) );
+    return _entry[_Index( i )];
+  }
+  inline T const & Entry( int i ) const {
+    assert( ( i >= 0 ) && ( i < _size ) );
+    return _entry[_Index( i )];
+  }
+
+  inline void PushBack( int time, T const & entry ) {
+    if ( _size > _mask ) {
+      _Resize( 2 * ( _mask + 1 ) );
+    }
+    int const tail = _Index( _size );
+    _time[tail] = time;
+    _entry[tail] = entry;
+    ++_size;
+  }
+
+  inline void PopFront( ) {
+    assert( _size > 0 );
+    _head = ( _head + 1 ) & _mask;
+    --_size;
+  }
+
+  inline void Clear( ) {
+    _head = 0;
+    _size = 0;
+  }
+
+  void SyncState( Checkpoint & cp );
+};
+
+template<class T> PipelineStage<T>::PipelineStage( int capacity )
+  : _mask( 0 ), _head( 0 ), _size( 0 ), _time( 1 ), _entry( 1 )
+{
+  Reserve( capacity );
+}
+
+template<class T> void PipelineStage<T>::Reserve( int capacity )
+{
+  int c = _mask + 1;
+  while ( c < capacity ) {
+    c *= 2;
+  }
+  if ( c > _mask + 1 ) {
+    _Resize( c );
+  }
+}
+
+template<class T> void PipelineStage<T>::_Resize( int capacity )
+{
+  assert( capacity >= _size );
+  vector<int> time( capacity );
+  vector<T> entry( capacity );
+  for ( int i = 0; i < _size; ++i ) {
+    time[i] = _time[_Index( i )];
+    entry[i] = _entry[_Index( i )];
+  }
+  _time.swap( time );
+  _entry.swap( entry );
+  _mask = capacity - 1;
+  _head = 0;
+}
+
+template<class T> void PipelineStage<T>::SyncState( Checkpoint & cp )
+{
+  int size = _size;
+  cp.Sync( size );
+  if ( cp.Restoring( ) ) {
+    Clear( );
+    Reserve( size );
+    _size = size;
+  }
+  for ( int i = 0; i < _size; ++i ) {
+    cp.Sync( Time( i ) );
+    cp.Sync( Entry( i ) );
+  }
+}
+
+#endif
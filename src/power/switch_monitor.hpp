@@ -34,6 +34,7 @@
 using namespace std;
 
 class Flit;
+class Checkpoint;
 
 class SwitchMonitor {
   int  _cycles ;
@@ -58,6 +59,7 @@ public:
     return _classes;
   }
   void traversal( int input, int output, Flit const * f ) ;
+  void SyncState( Checkpoint & cp ) ;
   void display(ostream & os) const;
 } ;
 
@@ -29,8 +29,56 @@
 #include <algorithm>
 #include <cassert>
 
-extern long ran_x[];
-extern double ran_u[];
+__thread RandomStream * gRandomStream = NULL;
+
+void RandomStream::Reset( long seed, int id, int stream )
+{
+  unsigned long long const key = (unsigned long long)seed;
+  _key[0] = (uint32_t)key;
+  _key[1] = (uint32_t)( key >> 32 );
+  _ctr[0] = 0;
+  _ctr[1] = 0;
+  _ctr[2] = (uint32_t)id;
+  _ctr[3] = (uint32_t)stream;
+  _avail = 0;
+}
+
+// one Philox4x32-10 block for the current counter, which is then advanced
+void RandomStream::_Refill( )
+{
+  static uint32_t const M0 = 0xD2511F53;
+  static uint32_t const M1 = 0xCD9E8D57;
+  static uint32_t const W0 = 0x9E3779B9;
+  static uint32_t const W1 = 0xBB67AE85;
+
+  uint32_t x0 = _ctr[0], x1 = _ctr[1], x2 = _ctr[2], x3 = _ctr[3];
+  uint32_t k0 = _key[0], k1 = _key[1];
+  for ( int round = 0; round < 10; ++round ) {
+    uint64_t const p0 = (uint64_t)M0 * x0;
+    uint64_t const p1 = (uint64_t)M1 * x2;
+    uint32_t const y0 = (uint32_t)( p1 >> 32 ) ^ x1 ^ k0;
+    uint32_t const y2 = (uint32_t)( p0 >> 32 ) ^ x3 ^ k1;
+    x0 = y0;
+    x1 = (uint32_t)p1;
+    x2 = y2;
+    x3 = (uint32_t)p0;
+    k0 += W0;
+    k1 += W1;
+  }
+  // consumed back to front by Next()
+  _out[3] = x0;
+  _out[2] = x1;
+  _out[1] = x2;
+  _out[0] = x3;
+  _avail = 4;
+
+  if ( ++_ctr[0] == 0 ) {
+    ++_ctr[1];
+  }
+}
+
+extern __thread long ran_x[];
+extern __thread double ran_u[];
 #define KK 100
 
 void SaveRandomState( std::vector<long> & save_x, std::vector<double> & save_u ) {
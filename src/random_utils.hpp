@@ -29,6 +29,7 @@
 #define _RANDOM_UTILS_HPP_
 
 #include <vector>
+#include <stdint.h>
 
 // interface to Knuth's RANARRAY RNG
 void   ran_start(long seed);
@@ -36,28 +37,90 @@ long   ran_next( );
 void   ranf_start(long seed);
 double ranf_next( );
 
+// complete state of the generators, including the unused part of the 
+// current batch of numbers
+void ran_get_state( std::vector<long> & state );
+void ran_set_state( std::vector<long> const & state );
+void ranf_get_state( std::vector<double> & state );
+void ranf_set_state( std::vector<double> const & state );
+
+// Counter-based generator (Philox4x32-10) keyed by a seed, an owner ID and 
+// a stream number. The n-th value of a stream only depends on these and n, 
+// so each owner draws the same numbers no matter how many other streams 
+// exist or in which order (or on which thread) they are used.
+class RandomStream {
+  uint32_t _key[2];
+  uint32_t _ctr[4];
+  uint32_t _out[4];
+  int _avail;
+  void _Refill( );
+public:
+  RandomStream( long seed = 0, int id = 0, int stream = 0 ) {
+    Reset( seed, id, stream );
+  }
+  void Reset( long seed, int id, int stream );
+  inline uint32_t Next( ) {
+    if ( _avail == 0 ) {
+      _Refill( );
+    }
+    return _out[--_avail];
+  }
+  // uniform in [0,1) with 53 bits of precision
+  inline double NextFloat( ) {
+    uint32_t const a = Next( ) >> 5;
+    uint32_t const b = Next( ) >> 6;
+    return ( a * 67108864.0 + b ) * ( 1.0 / 9007199254740992.0 );
+  }
+};
+
+// Stream that RandomInt and RandomFloat draw from on the calling thread; 
+// NULL selects the global generator.
+extern __thread RandomStream * gRandomStream;
+
+// Redirects the calling thread's random draws to a stream for the lifetime 
+// of the object.
+class RandomStreamScope {
+  RandomStream * _prev;
+public:
+  explicit RandomStreamScope( RandomStream * s ) : _prev( gRandomStream ) {
+    gRandomStream = s;
+  }
+  ~RandomStreamScope( ) {
+    gRandomStream = _prev;
+  }
+};
+
 inline void RandomSeed( long seed ) {
   ran_start( seed );
   ranf_start( seed );
 }
 
 inline unsigned long RandomIntLong( ) {
+  if ( gRandomStream ) {
+    return gRandomStream->Next( );
+  }
   return ran_next( );
 }
 
 // Returns a random integer in the range [0,max]
 inline int RandomInt( int max ) {
+  if ( gRandomStream ) {
+    return ( gRandomStream->Next( ) % (unsigned)(max+1) );
+  }
   return ( ran_next( ) % (max+1) );
 }
 
 // Returns a random floating-point value in the rage [0,1]
 inline double RandomFloat(  ) {
+  if ( gRandomStream ) {
+    return gRandomStream->NextFloat( );
+  }
   return ranf_next( );
 }
 
 // Returns a random floating-point value in the rage [0,max]
 inline double RandomFloat( double max ) {
-  return ( ranf_next( ) * max );
+  return ( RandomFloat( ) * max );
 }
 
 // Saves the current generator state
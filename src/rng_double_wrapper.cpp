@@ -25,6 +25,10 @@
  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <vector>
+#include <algorithm>
+#include <cassert>
+
 #define main rng_double_main
 #include "rng-double.c"
 
@@ -32,3 +36,32 @@ double ranf_next( )
 {
   return ranf_arr_next( );
 }
+
+// see ran_get_state
+void ranf_get_state( std::vector<double> & state )
+{
+  state.assign( ran_u, ran_u + KK );
+  state.insert( state.end( ), ranf_arr_buf, ranf_arr_buf + QUALITY );
+  if ( ranf_arr_ptr == &ranf_arr_dummy ) {
+    state.push_back( -2 );
+  } else if ( ranf_arr_ptr == &ranf_arr_started ) {
+    state.push_back( -1 );
+  } else {
+    state.push_back( ranf_arr_ptr - ranf_arr_buf );
+  }
+}
+
+void ranf_set_state( std::vector<double> const & state )
+{
+  assert( state.size( ) == KK + QUALITY + 1 );
+  std::copy( state.begin( ), state.begin( ) + KK, ran_u );
+  std::copy( state.begin( ) + KK, state.begin( ) + KK + QUALITY, ranf_arr_buf );
+  int const pos = (int)state.back( );
+  if ( pos == -2 ) {
+    ranf_arr_ptr = &ranf_arr_dummy;
+  } else if ( pos == -1 ) {
+    ranf_arr_ptr = &ranf_arr_started;
+  } else {
+    ranf_arr_ptr = ranf_arr_buf + pos;
+  }
+}
@@ -25,6 +25,10 @@
  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <vector>
+#include <algorithm>
+#include <cassert>
+
 #define main rng_main
 #include "rng.c"
 
@@ -32,3 +36,34 @@ long ran_next( )
 {
   return ran_arr_next( );
 }
+
+// The complete state consists of the generator state proper, the current 
+// batch of numbers and the position within that batch (-1 if no batch has 
+// been generated since seeding, -2 if the generator was never seeded).
+void ran_get_state( std::vector<long> & state )
+{
+  state.assign( ran_x, ran_x + KK );
+  state.insert( state.end( ), ran_arr_buf, ran_arr_buf + QUALITY );
+  if ( ran_arr_ptr == &ran_arr_dummy ) {
+    state.push_back( -2 );
+  } else if ( ran_arr_ptr == &ran_arr_started ) {
+    state.push_back( -1 );
+  } else {
+    state.push_back( ran_arr_ptr - ran_arr_buf );
+  }
+}
+
+void ran_set_state( std::vector<long> const & state )
+{
+  assert( state.size( ) == KK + QUALITY + 1 );
+  std::copy( state.begin( ), state.begin( ) + KK, ran_x );
+  std::copy( state.begin( ) + KK, state.begin( ) + KK + QUALITY, ran_arr_buf );
+  long const pos = state.back( );
+  if ( pos == -2 ) {
+    ran_arr_ptr = &ran_arr_dummy;
+  } else if ( pos == -1 ) {
+    ran_arr_ptr = &ran_arr_started;
+  } else {
+    ran_arr_ptr = ran_arr_buf + pos;
+  }
+}
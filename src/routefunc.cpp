@@ -52,42 +52,34 @@
 
 
 
-map<string, tRoutingFunction> gRoutingFunctionMap;
-
-/* Global information used by routing functions */
-
-int gNumVCs;
+/* Global information used by routing functions is kept in the 
+ * SimulationContext (number of VCs, VC ranges per packet type, and the 
+ * topology parameters)
+ */
 
 /* Add more functions here
  *
  */
 
-// ============================================================
-//  Balfour-Schultz
-int gReadReqBeginVC, gReadReqEndVC;
-int gWriteReqBeginVC, gWriteReqEndVC;
-int gReadReplyBeginVC, gReadReplyEndVC;
-int gWriteReplyBeginVC, gWriteReplyEndVC;
-
 // ============================================================
 //  QTree: Nearest Common Ancestor
 // ===
 void qtree_nca( const Router *r, const Flit *f,
 		int in_channel, OutputSet* outputs, bool inject)
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -104,14 +96,14 @@ void qtree_nca( const Router *r, const Flit *f,
     
     int dest   = f->dest;
     
-    for (int i = height+1; i < gN; i++) 
-      dest /= gK;
-    if ( pos == dest / gK ) 
+    for (int i = height+1; i < gContext->n; i++) 
+      dest /= gContext->k;
+    if ( pos == dest / gContext->k ) 
       // Route down to child
-      out_port = dest % gK ; 
+      out_port = dest % gContext->k ; 
     else
       // Route up to parent
-      out_port = gK;        
+      out_port = gContext->k;        
 
   }
 
@@ -126,19 +118,19 @@ void qtree_nca( const Router *r, const Flit *f,
 void tree4_anca( const Router *r, const Flit *f,
 		 int in_channel, OutputSet* outputs, bool inject)
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -167,14 +159,14 @@ void tree4_anca( const Router *r, const Flit *f,
       if ( dest / 4 == rP / 2 )
 	out_port = dest % 4;
       else {
-	out_port = gK;
-	range = gK;
+	out_port = gContext->k;
+	range = gContext->k;
       }
     } else {
       if ( dest/4 == rP )
 	out_port = dest % 4;
       else {
-	out_port = gK;
+	out_port = gContext->k;
 	range = 2;
       }
     }
@@ -196,19 +188,19 @@ void tree4_anca( const Router *r, const Flit *f,
 void tree4_nca( const Router *r, const Flit *f,
 		int in_channel, OutputSet* outputs, bool inject)
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -235,12 +227,12 @@ void tree4_nca( const Router *r, const Flit *f,
       if ( dest / 4 == rP / 2 )
 	out_port = dest % 4;
       else
-	out_port = gK + RandomInt(gK-1);
+	out_port = gContext->k + RandomInt(gContext->k-1);
     } else {
       if ( dest/4 == rP )
 	out_port = dest % 4;
       else
-	out_port = gK + RandomInt(1);
+	out_port = gContext->k + RandomInt(1);
     }
     
     //  cout << "Router("<<rH<<","<<rP<<"): id= " << f->id << " dest= " << f->dest << " out_port = "
@@ -259,19 +251,19 @@ void tree4_nca( const Router *r, const Flit *f,
 void fattree_nca( const Router *r, const Flit *f,
                int in_channel, OutputSet* outputs, bool inject)
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -285,12 +277,12 @@ void fattree_nca( const Router *r, const Flit *f,
     
     int dest = f->dest;
     int router_id = r->GetID(); //routers are numbered with smallest at the top level
-    int routers_per_level = powi(gK, gN-1);
+    int routers_per_level = powi(gContext->k, gContext->n-1);
     int pos = router_id%routers_per_level;
     int router_depth  = router_id/ routers_per_level; //which level
-    int routers_per_neighborhood = powi(gK,gN-router_depth-1);
+    int routers_per_neighborhood = powi(gContext->k,gContext->n-router_depth-1);
     int router_neighborhood = pos/routers_per_neighborhood; //coverage of this tree
-    int router_coverage = powi(gK, gN-router_depth);  //span of the tree from this router
+    int router_coverage = powi(gContext->k, gContext->n-router_depth);  //span of the tree from this router
     
 
     //NCA reached going down
@@ -299,17 +291,17 @@ void fattree_nca( const Router *r, const Flit *f,
       //down ports are numbered first
 
       //ejection
-      if(router_depth == gN-1){
-	out_port = dest%gK;
+      if(router_depth == gContext->n-1){
+	out_port = dest%gContext->k;
       } else {	
 	//find the down port for the destination
-	int router_branch_coverage = powi(gK, gN-(router_depth+1)); 
+	int router_branch_coverage = powi(gContext->k, gContext->n-(router_depth+1)); 
 	out_port = (dest-router_neighborhood* router_coverage)/router_branch_coverage;
       }
     } else {
       //up ports are numbered last
-      assert(in_channel<gK);//came from a up channel
-      out_port = gK+RandomInt(gK-1);
+      assert(in_channel<gContext->k);//came from a up channel
+      out_port = gContext->k+RandomInt(gContext->k-1);
     }
   }  
   outputs->Clear( );
@@ -324,19 +316,19 @@ void fattree_anca( const Router *r, const Flit *f,
                 int in_channel, OutputSet* outputs, bool inject)
 {
 
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -352,12 +344,12 @@ void fattree_anca( const Router *r, const Flit *f,
 
     int dest = f->dest;
     int router_id = r->GetID(); //routers are numbered with smallest at the top level
-    int routers_per_level = powi(gK, gN-1);
+    int routers_per_level = powi(gContext->k, gContext->n-1);
     int pos = router_id%routers_per_level;
     int router_depth  = router_id/ routers_per_level; //which level
-    int routers_per_neighborhood = powi(gK,gN-router_depth-1);
+    int routers_per_neighborhood = powi(gContext->k,gContext->n-router_depth-1);
     int router_neighborhood = pos/routers_per_neighborhood; //coverage of this tree
-    int router_coverage = powi(gK, gN-router_depth);  //span of the tree from this router
+    int router_coverage = powi(gContext->k, gContext->n-router_depth);  //span of the tree from this router
     
 
     //NCA reached going down
@@ -366,19 +358,19 @@ void fattree_anca( const Router *r, const Flit *f,
       //down ports are numbered first
 
       //ejection
-      if(router_depth == gN-1){
-	out_port = dest%gK;
+      if(router_depth == gContext->n-1){
+	out_port = dest%gContext->k;
       } else {	
 	//find the down port for the destination
-	int router_branch_coverage = powi(gK, gN-(router_depth+1)); 
+	int router_branch_coverage = powi(gContext->k, gContext->n-(router_depth+1)); 
 	out_port = (dest-router_neighborhood* router_coverage)/router_branch_coverage;
       }
     } else {
       //up ports are numbered last
-      assert(in_channel<gK);//came from a up channel
-      out_port = gK;
-      int random1 = RandomInt(gK-1); // Chose two ports out of the possible at random, compare loads, choose one.
-      int random2 = RandomInt(gK-1);
+      assert(in_channel<gContext->k);//came from a up channel
+      out_port = gContext->k;
+      int random1 = RandomInt(gContext->k-1); // Chose two ports out of the possible at random, compare loads, choose one.
+      int random2 = RandomInt(gContext->k-1);
       if (r->GetUsedCredit(out_port + random1) > r->GetUsedCredit(out_port + random2)){
 	out_port = out_port + random2;
       }else{
@@ -404,19 +396,19 @@ int dor_next_mesh( int cur, int dest, bool descending = false );
 void adaptive_xy_yx_mesh( const Router *r, const Flit *f, 
 		 int in_channel, OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -429,7 +421,7 @@ void adaptive_xy_yx_mesh( const Router *r, const Flit *f,
   } else if(r->GetID() == f->dest) {
 
     // at destination router, we don't need to separate VCs by dim order
-    out_port = 2*gN;
+    out_port = 2*gContext->n;
 
   } else {
 
@@ -443,7 +435,7 @@ void adaptive_xy_yx_mesh( const Router *r, const Flit *f,
     // Route order (XY or YX) determined when packet is injected
     //  into the network, adaptively
     bool x_then_y;
-    if(in_channel < 2*gN){
+    if(in_channel < 2*gContext->n){
       x_then_y =  (f->vc < (vcBegin + available_vcs));
     } else {
       int credit_xy = r->GetUsedCredit(out_port_xy);
@@ -476,19 +468,19 @@ void adaptive_xy_yx_mesh( const Router *r, const Flit *f,
 void xy_yx_mesh( const Router *r, const Flit *f, 
 		 int in_channel, OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -501,7 +493,7 @@ void xy_yx_mesh( const Router *r, const Flit *f,
   } else if(r->GetID() == f->dest) {
 
     // at destination router, we don't need to separate VCs by dim order
-    out_port = 2*gN;
+    out_port = 2*gContext->n;
 
   } else {
 
@@ -511,7 +503,7 @@ void xy_yx_mesh( const Router *r, const Flit *f,
 
     // Route order (XY or YX) determined when packet is injected
     //  into the network
-    bool x_then_y = ((in_channel < 2*gN) ?
+    bool x_then_y = ((in_channel < 2*gContext->n) ?
 		     (f->vc < (vcBegin + available_vcs)) :
 		     (RandomInt(1) > 0));
 
@@ -540,25 +532,25 @@ void xy_yx_mesh( const Router *r, const Flit *f,
 int dor_next_mesh( int cur, int dest, bool descending )
 {
   if ( cur == dest ) {
-    return 2*gN;  // Eject
+    return 2*gContext->n;  // Eject
   }
 
   int dim_left;
 
   if(descending) {
-    for ( dim_left = ( gN - 1 ); dim_left > 0; --dim_left ) {
-      if ( ( cur * gK / gNodes ) != ( dest * gK / gNodes ) ) { break; }
-      cur = (cur * gK) % gNodes; dest = (dest * gK) % gNodes;
+    for ( dim_left = ( gContext->n - 1 ); dim_left > 0; --dim_left ) {
+      if ( ( cur * gContext->k / gContext->nodes ) != ( dest * gContext->k / gContext->nodes ) ) { break; }
+      cur = (cur * gContext->k) % gContext->nodes; dest = (dest * gContext->k) % gContext->nodes;
     }
-    cur = (cur * gK) / gNodes;
-    dest = (dest * gK) / gNodes;
+    cur = (cur * gContext->k) / gContext->nodes;
+    dest = (dest * gContext->k) / gContext->nodes;
   } else {
-    for ( dim_left = 0; dim_left < ( gN - 1 ); ++dim_left ) {
-      if ( ( cur % gK ) != ( dest % gK ) ) { break; }
-      cur /= gK; dest /= gK;
+    for ( dim_left = 0; dim_left < ( gContext->n - 1 ); ++dim_left ) {
+      if ( ( cur % gContext->k ) != ( dest % gContext->k ) ) { break; }
+      cur /= gContext->k; dest /= gContext->k;
     }
-    cur %= gK;
-    dest %= gK;
+    cur %= gContext->k;
+    dest %= gContext->k;
   }
 
   if ( cur < dest ) {
@@ -578,18 +570,18 @@ void dor_next_torus( int cur, int dest, int in_port,
   int dir;
   int dist2;
 
-  for ( dim_left = 0; dim_left < gN; ++dim_left ) {
-    if ( ( cur % gK ) != ( dest % gK ) ) { break; }
-    cur /= gK; dest /= gK;
+  for ( dim_left = 0; dim_left < gContext->n; ++dim_left ) {
+    if ( ( cur % gContext->k ) != ( dest % gContext->k ) ) { break; }
+    cur /= gContext->k; dest /= gContext->k;
   }
   
-  if ( dim_left < gN ) {
+  if ( dim_left < gContext->n ) {
 
     if ( (in_port/2) != dim_left ) {
       // Turning into a new dimension
 
-      cur %= gK; dest %= gK;
-      dist2 = gK - 2 * ( ( dest - cur + gK ) % gK );
+      cur %= gContext->k; dest %= gContext->k;
+      dist2 = gContext->k - 2 * ( ( dest - cur + gContext->k ) % gContext->k );
       
       if ( ( dist2 > 0 ) || 
 	   ( ( dist2 == 0 ) && ( RandomInt( 1 ) ) ) ) {
@@ -610,8 +602,8 @@ void dor_next_torus( int cur, int dest, int in_port,
 	  if ( ( ( dir == 0 ) && ( cur > dest ) ) ||
 	       ( ( dir == 1 ) && ( cur < dest ) ) ) {
 	    *partition = 1;
-	  } else if ( ( ( dir == 0 ) && ( cur <= (gK-1)/2 ) && ( dest >  (gK-1)/2 ) ) ||
-		      ( ( dir == 1 ) && ( cur >  (gK-1)/2 ) && ( dest <= (gK-1)/2 ) ) ) {
+	  } else if ( ( ( dir == 0 ) && ( cur <= (gContext->k-1)/2 ) && ( dest >  (gContext->k-1)/2 ) ) ||
+		      ( ( dir == 1 ) && ( cur >  (gContext->k-1)/2 ) && ( dest <= (gContext->k-1)/2 ) ) ) {
 	    *partition = 0;
 	  } else {
 	    *partition = RandomInt( 1 ); // use either VC set
@@ -634,7 +626,7 @@ void dor_next_torus( int cur, int dest, int in_port,
     }    
 
   } else {
-    *out_port = 2*gN;  // Eject
+    *out_port = 2*gContext->n;  // Eject
   }
 }
 
@@ -644,24 +636,24 @@ void dim_order_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *
 {
   int out_port = inject ? -1 : dor_next_mesh( r->GetID( ), f->dest );
   
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   if ( !inject && f->watch ) {
-    *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+    *gContext->watch_out << GetSimTime() << " | " << r->FullName() << " | "
 	       << "Adding VC range [" 
 	       << vcBegin << "," 
 	       << vcEnd << "]"
@@ -683,26 +675,26 @@ void dim_order_ni_mesh( const Router *r, const Flit *f, int in_channel, OutputSe
 {
   int out_port = inject ? -1 : dor_next_mesh( r->GetID( ), f->dest );
   
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   // at the destination router, we don't need to separate VCs by destination
   if(inject || (r->GetID() != f->dest)) {
 
-    int const vcs_per_dest = (vcEnd - vcBegin + 1) / gNodes;
+    int const vcs_per_dest = (vcEnd - vcBegin + 1) / gContext->nodes;
     assert(vcs_per_dest > 0);
 
     vcBegin += f->dest * vcs_per_dest;
@@ -711,7 +703,7 @@ void dim_order_ni_mesh( const Router *r, const Flit *f, int in_channel, OutputSe
   }
   
   if( !inject && f->watch ) {
-    *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+    *gContext->watch_out << GetSimTime() << " | " << r->FullName() << " | "
 	       << "Adding VC range [" 
 	       << vcBegin << "," 
 	       << vcEnd << "]"
@@ -733,19 +725,19 @@ void dim_order_pni_mesh( const Router *r, const Flit *f, int in_channel, OutputS
 {
   int out_port = inject ? -1 : dor_next_mesh( r->GetID(), f->dest );
   
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -754,19 +746,19 @@ void dim_order_pni_mesh( const Router *r, const Flit *f, int in_channel, OutputS
     if(!inject) {
       int out_dim = out_port / 2;
       for(int d = 0; d < out_dim; ++d) {
-	next_coord /= gK;
+	next_coord /= gContext->k;
       }
     }
-    next_coord %= gK;
-    assert(next_coord >= 0 && next_coord < gK);
-    int vcs_per_dest = (vcEnd - vcBegin + 1) / gK;
+    next_coord %= gContext->k;
+    assert(next_coord >= 0 && next_coord < gContext->k);
+    int vcs_per_dest = (vcEnd - vcBegin + 1) / gContext->k;
     assert(vcs_per_dest > 0);
     vcBegin += next_coord * vcs_per_dest;
     vcEnd = vcBegin + vcs_per_dest - 1;
   }
 
   if( !inject && f->watch ) {
-    *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+    *gContext->watch_out << GetSimTime() << " | " << r->FullName() << " | "
 	       << "Adding VC range [" 
 	       << vcBegin << "," 
 	       << vcEnd << "]"
@@ -793,17 +785,17 @@ int rand_min_intr_mesh( int src, int dest )
   int intm = 0;
   int offset = 1;
 
-  for ( int n = 0; n < gN; ++n ) {
-    dist = ( dest % gK ) - ( src % gK );
+  for ( int n = 0; n < gContext->n; ++n ) {
+    dist = ( dest % gContext->k ) - ( src % gContext->k );
 
     if ( dist > 0 ) {
-      intm += offset * ( ( src % gK ) + RandomInt( dist ) );
+      intm += offset * ( ( src % gContext->k ) + RandomInt( dist ) );
     } else {
-      intm += offset * ( ( dest % gK ) + RandomInt( -dist ) );
+      intm += offset * ( ( dest % gContext->k ) + RandomInt( -dist ) );
     }
 
-    offset *= gK;
-    dest /= gK; src /= gK;
+    offset *= gContext->k;
+    dest /= gContext->k; src /= gContext->k;
   }
 
   return intm;
@@ -813,19 +805,19 @@ int rand_min_intr_mesh( int src, int dest )
 
 void romm_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -837,7 +829,7 @@ void romm_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *outpu
 
   } else {
 
-    if ( in_channel == 2*gN ) {
+    if ( in_channel == 2*gContext->n ) {
       f->ph   = 0;  // Phase 0
       f->intm = rand_min_intr_mesh( f->src, f->dest );
     } 
@@ -874,26 +866,26 @@ void romm_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *outpu
 
 void romm_ni_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   // at the destination router, we don't need to separate VCs by destination
   if(inject || (r->GetID() != f->dest)) {
 
-    int const vcs_per_dest = (vcEnd - vcBegin + 1) / gNodes;
+    int const vcs_per_dest = (vcEnd - vcBegin + 1) / gContext->nodes;
     assert(vcs_per_dest > 0);
 
     vcBegin += f->dest * vcs_per_dest;
@@ -909,7 +901,7 @@ void romm_ni_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *ou
 
   } else {
 
-    if ( in_channel == 2*gN ) {
+    if ( in_channel == 2*gContext->n ) {
       f->ph   = 0;  // Phase 0
       f->intm = rand_min_intr_mesh( f->src, f->dest );
     } 
@@ -931,19 +923,19 @@ void romm_ni_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *ou
 
 void min_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -955,13 +947,13 @@ void min_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *
     return;
   } else if(r->GetID() == f->dest) {
     // ejection can also use all VCs
-    outputs->AddRange(2*gN, vcBegin, vcEnd);
+    outputs->AddRange(2*gContext->n, vcBegin, vcEnd);
     return;
   }
 
   int in_vc;
 
-  if ( in_channel == 2*gN ) {
+  if ( in_channel == 2*gContext->n ) {
     in_vc = vcEnd; // ignore the injection VC
   } else {
     in_vc = f->vc;
@@ -972,7 +964,7 @@ void min_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *
   outputs->AddRange( out_port, 0, vcBegin, vcBegin );
   
   if ( f->watch ) {
-      *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+      *gContext->watch_out << GetSimTime() << " | " << r->FullName() << " | "
 		  << "Adding VC range [" 
 		  << vcBegin << "," 
 		  << vcBegin << "]"
@@ -988,12 +980,12 @@ void min_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *
     int cur = r->GetID( );
     int dest = f->dest;
     
-    for ( int n = 0; n < gN; ++n ) {
-      if ( ( cur % gK ) != ( dest % gK ) ) { 
+    for ( int n = 0; n < gContext->n; ++n ) {
+      if ( ( cur % gContext->k ) != ( dest % gContext->k ) ) { 
 	// Add minimal direction in dimension 'n'
-	if ( ( cur % gK ) < ( dest % gK ) ) { // Right
+	if ( ( cur % gContext->k ) < ( dest % gContext->k ) ) { // Right
 	  if ( f->watch ) {
-	    *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+	    *gContext->watch_out << GetSimTime() << " | " << r->FullName() << " | "
 			<< "Adding VC range [" 
 		       << (vcBegin+1) << "," 
 			<< vcEnd << "]"
@@ -1007,7 +999,7 @@ void min_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *
 	  outputs->AddRange( 2*n, vcBegin+1, vcEnd, 1 ); 
 	} else { // Left
 	  if ( f->watch ) {
-	    *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+	    *gContext->watch_out << GetSimTime() << " | " << r->FullName() << " | "
 			<< "Adding VC range [" 
 		       << (vcBegin+1) << "," 
 			<< vcEnd << "]"
@@ -1021,8 +1013,8 @@ void min_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *
 	  outputs->AddRange( 2*n + 1, vcBegin+1, vcEnd, 1 ); 
 	}
       }
-      cur  /= gK;
-      dest /= gK;
+      cur  /= gContext->k;
+      dest /= gContext->k;
     }
   } 
 }
@@ -1031,19 +1023,19 @@ void min_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *
 
 void planar_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -1069,22 +1061,22 @@ void planar_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSe
     // In this case, go to the last dimension instead.
 
     int n;
-    for ( n = 0; n < gN; ++n ) {
-      if ( ( ( cur % gK ) != ( dest % gK ) ) &&
+    for ( n = 0; n < gContext->n; ++n ) {
+      if ( ( ( cur % gContext->k ) != ( dest % gContext->k ) ) &&
 	   !( ( in_channel/2 == 0 ) &&
 	      ( n == 0 ) &&
 	      ( in_vc < vcBegin+2*vc_mult ) ) ) {
 	break;
       }
 
-      cur  /= gK;
-      dest /= gK;
+      cur  /= gContext->k;
+      dest /= gContext->k;
     }
 
-    assert( n < gN );
+    assert( n < gContext->n );
 
     if ( f->watch ) {
-      *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+      *gContext->watch_out << GetSimTime() << " | " << r->FullName() << " | "
 		  << "PLANAR ADAPTIVE: flit " << f->id 
 		  << " in adaptive plane " << n << "." << endl;
     }
@@ -1094,14 +1086,14 @@ void planar_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSe
     // Can route productively in d_{i,2}
     bool increase;
     bool fault;
-    if ( ( cur % gK ) < ( dest % gK ) ) { // Increasing
+    if ( ( cur % gContext->k ) < ( dest % gContext->k ) ) { // Increasing
       increase = true;
       if ( !r->IsFaultyOutput( 2*n ) ) {
 	outputs->AddRange( 2*n, vcBegin+2*vc_mult, vcEnd );
 	fault = false;
 
 	if ( f->watch ) {
-	  *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+	  *gContext->watch_out << GetSimTime() << " | " << r->FullName() << " | "
 		      << "PLANAR ADAPTIVE: increasing in dimension " << n
 		      << "." << endl;
 	}
@@ -1115,7 +1107,7 @@ void planar_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSe
 	fault = false;
 
 	if ( f->watch ) {
-	  *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+	  *gContext->watch_out << GetSimTime() << " | " << r->FullName() << " | "
 		      << "PLANAR ADAPTIVE: decreasing in dimension " << n
 		      << "." << endl;
 	}
@@ -1124,9 +1116,9 @@ void planar_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSe
       }
     }
       
-    n = ( n + 1 ) % gN;
-    cur  /= gK;
-    dest /= gK;
+    n = ( n + 1 ) % gContext->n;
+    cur  /= gContext->k;
+    dest /= gContext->k;
       
     if ( !increase ) {
       vcBegin += vc_mult;
@@ -1134,9 +1126,9 @@ void planar_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSe
     vcEnd = vcBegin + vc_mult - 1;
       
     int d1_min_c;
-    if ( ( cur % gK ) < ( dest % gK ) ) { // Increasing in d_{i+1}
+    if ( ( cur % gContext->k ) < ( dest % gContext->k ) ) { // Increasing in d_{i+1}
       d1_min_c = 2*n;
-    } else if ( ( cur % gK ) != ( dest % gK ) ) {  // Decreasing in d_{i+1}
+    } else if ( ( cur % gContext->k ) != ( dest % gContext->k ) ) {  // Decreasing in d_{i+1}
       d1_min_c = 2*n + 1;
     } else {
       d1_min_c = -1;
@@ -1154,7 +1146,7 @@ void planar_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSe
       }
 
       if ( f->watch ) {
-	*gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+	*gContext->watch_out << GetSimTime() << " | " << r->FullName() << " | "
 		    << "PLANAR ADAPTIVE: avoiding 180 in dimension " << n
 		    << "." << endl;
       }
@@ -1169,10 +1161,10 @@ void planar_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSe
       }
     } else if ( fault ) { // need to misroute!
       bool atedge;
-      if ( cur % gK == 0 ) {
+      if ( cur % gContext->k == 0 ) {
 	d1_min_c = 2*n;
 	atedge = true;
-      } else if ( cur % gK == gK - 1 ) {
+      } else if ( cur % gContext->k == gContext->k - 1 ) {
 	d1_min_c = 2*n + 1;
 	atedge = true;
       } else {
@@ -1194,7 +1186,7 @@ void planar_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSe
       }
     }
   } else {
-    outputs->AddRange( 2*gN, vcBegin, vcEnd ); 
+    outputs->AddRange( 2*gContext->n, vcBegin, vcEnd ); 
   }
 }
 
@@ -1208,19 +1200,19 @@ void limited_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputS
 {
   outputs->Clear( );
 
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -1237,10 +1229,10 @@ void limited_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputS
     if ( ( f->vc != vcEnd ) && 
 	 ( f->dr != vcEnd - 1 ) ) {
       
-      for ( int n = 0; n < gN; ++n ) {
-	if ( ( cur % gK ) != ( dest % gK ) ) { 
+      for ( int n = 0; n < gContext->n; ++n ) {
+	if ( ( cur % gContext->k ) != ( dest % gContext->k ) ) { 
 	  int min_port;
-	  if ( ( cur % gK ) < ( dest % gK ) ) { 
+	  if ( ( cur % gContext->k ) < ( dest % gContext->k ) ) { 
 	    min_port = 2*n; // Right
 	  } else {
 	    min_port = 2*n + 1; // Left
@@ -1257,8 +1249,8 @@ void limited_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputS
 	  outputs->AddRange( 2*n+1, vcBegin, vcEnd - 1, 1 );
 	}
 	
-	cur  /= gK;
-	dest /= gK;
+	cur  /= gContext->k;
+	dest /= gContext->k;
       }
       
     } else {
@@ -1267,7 +1259,7 @@ void limited_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputS
     }
     
   } else { // at destination
-    outputs->AddRange( 2*gN, vcBegin, vcEnd ); 
+    outputs->AddRange( 2*gContext->n, vcBegin, vcEnd ); 
   }
 }
 */
@@ -1275,19 +1267,19 @@ void limited_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputS
 
 void valiant_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -1299,9 +1291,9 @@ void valiant_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *ou
 
   } else {
 
-    if ( in_channel == 2*gN ) {
+    if ( in_channel == 2*gContext->n ) {
       f->ph   = 0;  // Phase 0
-      f->intm = RandomInt( gNodes - 1 );
+      f->intm = RandomInt( gContext->nodes - 1 );
     }
 
     if ( ( f->ph == 0 ) && ( r->GetID( ) == f->intm ) ) {
@@ -1336,19 +1328,19 @@ void valiant_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *ou
 
 void valiant_torus( const Router *r, const Flit *f, int in_channel, OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -1361,16 +1353,16 @@ void valiant_torus( const Router *r, const Flit *f, int in_channel, OutputSet *o
   } else {
 
     int phase;
-    if ( in_channel == 2*gN ) {
+    if ( in_channel == 2*gContext->n ) {
       phase   = 0;  // Phase 0
-      f->intm = RandomInt( gNodes - 1 );
+      f->intm = RandomInt( gContext->nodes - 1 );
     } else {
       phase = f->ph / 2;
     }
 
     if ( ( phase == 0 ) && ( r->GetID( ) == f->intm ) ) {
       phase = 1; // Go to phase 1
-      in_channel = 2*gN; // ensures correct vc selection at the beginning of phase 2
+      in_channel = 2*gContext->n; // ensures correct vc selection at the beginning of phase 2
     }
   
     int ring_part;
@@ -1415,26 +1407,26 @@ void valiant_torus( const Router *r, const Flit *f, int in_channel, OutputSet *o
 void valiant_ni_torus( const Router *r, const Flit *f, int in_channel, 
 		       OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   // at the destination router, we don't need to separate VCs by destination
   if(inject || (r->GetID() != f->dest)) {
 
-    int const vcs_per_dest = (vcEnd - vcBegin + 1) / gNodes;
+    int const vcs_per_dest = (vcEnd - vcBegin + 1) / gContext->nodes;
     assert(vcs_per_dest > 0);
 
     vcBegin += f->dest * vcs_per_dest;
@@ -1451,16 +1443,16 @@ void valiant_ni_torus( const Router *r, const Flit *f, int in_channel,
   } else {
 
     int phase;
-    if ( in_channel == 2*gN ) {
+    if ( in_channel == 2*gContext->n ) {
       phase   = 0;  // Phase 0
-      f->intm = RandomInt( gNodes - 1 );
+      f->intm = RandomInt( gContext->nodes - 1 );
     } else {
       phase = f->ph / 2;
     }
 
     if ( ( f->ph == 0 ) && ( r->GetID( ) == f->intm ) ) {
       f->ph = 1; // Go to phase 1
-      in_channel = 2*gN; // ensures correct vc selection at the beginning of phase 2
+      in_channel = 2*gContext->n; // ensures correct vc selection at the beginning of phase 2
     }
   
     int ring_part;
@@ -1494,7 +1486,7 @@ void valiant_ni_torus( const Router *r, const Flit *f, int in_channel,
     }
 
     if (f->watch) {
-      *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+      *gContext->watch_out << GetSimTime() << " | " << r->FullName() << " | "
 		 << "Adding VC range [" 
 		 << vcBegin << "," 
 		 << vcEnd << "]"
@@ -1517,19 +1509,19 @@ void valiant_ni_torus( const Router *r, const Flit *f, int in_channel,
 void dim_order_torus( const Router *r, const Flit *f, int in_channel, 
 		      OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -1544,8 +1536,10 @@ void dim_order_torus( const Router *r, const Flit *f, int in_channel,
     int cur  = r->GetID( );
     int dest = f->dest;
 
+    int ph = f->ph;
     dor_next_torus( cur, dest, in_channel,
-		    &out_port, &f->ph, false );
+		    &out_port, &ph, false );
+    f->ph = ph;
 
 
     // at the destination router, we don't need to separate VCs by ring partition
@@ -1562,7 +1556,7 @@ void dim_order_torus( const Router *r, const Flit *f, int in_channel,
     }
 
     if ( f->watch ) {
-      *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+      *gContext->watch_out << GetSimTime() << " | " << r->FullName() << " | "
 		 << "Adding VC range [" 
 		 << vcBegin << "," 
 		 << vcEnd << "]"
@@ -1585,19 +1579,19 @@ void dim_order_torus( const Router *r, const Flit *f, int in_channel,
 void dim_order_ni_torus( const Router *r, const Flit *f, int in_channel, 
 			 OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -1618,7 +1612,7 @@ void dim_order_ni_torus( const Router *r, const Flit *f, int in_channel,
     // at the destination router, we don't need to separate VCs by destination
     if(cur != dest) {
 
-      int const vcs_per_dest = (vcEnd - vcBegin + 1) / gNodes;
+      int const vcs_per_dest = (vcEnd - vcBegin + 1) / gContext->nodes;
       assert(vcs_per_dest);
 
       vcBegin += f->dest * vcs_per_dest;
@@ -1627,7 +1621,7 @@ void dim_order_ni_torus( const Router *r, const Flit *f, int in_channel,
     }
 
     if ( f->watch ) {
-      *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+      *gContext->watch_out << GetSimTime() << " | " << r->FullName() << " | "
 		 << "Adding VC range [" 
 		 << vcBegin << "," 
 		 << vcEnd << "]"
@@ -1650,19 +1644,19 @@ void dim_order_ni_torus( const Router *r, const Flit *f, int in_channel,
 void dim_order_bal_torus( const Router *r, const Flit *f, int in_channel, 
 			  OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -1677,8 +1671,10 @@ void dim_order_bal_torus( const Router *r, const Flit *f, int in_channel,
     int cur  = r->GetID( );
     int dest = f->dest;
 
+    int ph = f->ph;
     dor_next_torus( cur, dest, in_channel,
-		    &out_port, &f->ph, true );
+		    &out_port, &ph, true );
+    f->ph = ph;
 
     // at the destination router, we don't need to separate VCs by ring partition
     if(cur != dest) {
@@ -1695,7 +1691,7 @@ void dim_order_bal_torus( const Router *r, const Flit *f, int in_channel,
     }
 
     if ( f->watch ) {
-      *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+      *gContext->watch_out << GetSimTime() << " | " << r->FullName() << " | "
 		 << "Adding VC range [" 
 		 << vcBegin << "," 
 		 << vcEnd << "]"
@@ -1717,19 +1713,19 @@ void dim_order_bal_torus( const Router *r, const Flit *f, int in_channel,
 
 void min_adapt_torus( const Router *r, const Flit *f, int in_channel, OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -1741,11 +1737,11 @@ void min_adapt_torus( const Router *r, const Flit *f, int in_channel, OutputSet
     return;
   } else if(r->GetID() == f->dest) {
     // ejection can also use all VCs
-    outputs->AddRange(2*gN, vcBegin, vcEnd);
+    outputs->AddRange(2*gContext->n, vcBegin, vcEnd);
   }
 
   int in_vc;
-  if ( in_channel == 2*gN ) {
+  if ( in_channel == 2*gContext->n ) {
     in_vc = vcEnd; // ignore the injection VC
   } else {
     in_vc = f->vc;
@@ -1759,9 +1755,9 @@ void min_adapt_torus( const Router *r, const Flit *f, int in_channel, OutputSet
   if ( in_vc > ( vcBegin + 1 ) ) { // If not in the escape VCs
     // Minimal adaptive for all other channels
     
-    for ( int n = 0; n < gN; ++n ) {
-      if ( ( cur % gK ) != ( dest % gK ) ) {
-	int dist2 = gK - 2 * ( ( ( dest % gK ) - ( cur % gK ) + gK ) % gK );
+    for ( int n = 0; n < gContext->n; ++n ) {
+      if ( ( cur % gContext->k ) != ( dest % gContext->k ) ) {
+	int dist2 = gContext->k - 2 * ( ( ( dest % gContext->k ) - ( cur % gContext->k ) + gContext->k ) % gContext->k );
 	
 	if ( dist2 > 0 ) { /*) || 
 			     ( ( dist2 == 0 ) && ( RandomInt( 1 ) ) ) ) {*/
@@ -1771,19 +1767,23 @@ void min_adapt_torus( const Router *r, const Flit *f, int in_channel, OutputSet
 	}
       }
 
-      cur  /= gK;
-      dest /= gK;
+      cur  /= gContext->k;
+      dest /= gContext->k;
     }
     
     // DOR for the escape channel (VCs 0-1), low priority --- 
     // trick the algorithm with the in channel.  want VC assignment
     // as if we had injected at this node
-    dor_next_torus( r->GetID( ), f->dest, 2*gN,
-		    &out_port, &f->ph, false );
+    int ph = f->ph;
+    dor_next_torus( r->GetID( ), f->dest, 2*gContext->n,
+		    &out_port, &ph, false );
+    f->ph = ph;
   } else {
     // DOR for the escape channel (VCs 0-1), low priority 
+    int ph = f->ph;
     dor_next_torus( cur, dest, in_channel,
-		    &out_port, &f->ph, false );
+		    &out_port, &ph, false );
+    f->ph = ph;
   }
 
   if ( f->ph == 0 ) {
@@ -1798,19 +1798,19 @@ void min_adapt_torus( const Router *r, const Flit *f, int in_channel, OutputSet
 void dest_tag_fly( const Router *r, const Flit *f, int in_channel, 
 		   OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
+  int vcBegin = 0, vcEnd = gContext->num_vcs-1;
   if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
+    vcBegin = gContext->read_req_begin_vc;
+    vcEnd = gContext->read_req_end_vc;
   } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
+    vcBegin = gContext->write_req_begin_vc;
+    vcEnd = gContext->write_req_end_vc;
   } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
+    vcBegin = gContext->read_reply_begin_vc;
+    vcEnd = gContext->read_reply_end_vc;
   } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
+    vcBegin = gContext->write_reply_begin_vc;
+    vcEnd = gContext->write_reply_end_vc;
   }
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
@@ -1822,15 +1822,15 @@ void dest_tag_fly( const Router *r, const Flit *f, int in_channel,
 
   } else {
 
-    int stage = ( r->GetID( ) * gK ) / gNodes;
+    int stage = ( r->GetID( ) * gContext->k ) / gContext->nodes;
     int dest  = f->dest;
 
-    while( stage < ( gN - 1 ) ) {
-      dest /= gK;
+    while( stage < ( gContext->n - 1 ) ) {
+      dest /= gContext->k;
       ++stage;
     }
 
-    out_port = dest % gK;
+    out_port = dest % gContext->k;
   }
 
   outputs->Clear( );
@@ -1856,10 +1856,10 @@ void chaos_torus( const Router *r, const Flit *f,
   int dest = f->dest;
   
   if ( cur != dest ) {
-    for ( int n = 0; n < gN; ++n ) {
+    for ( int n = 0; n < gContext->n; ++n ) {
 
-      if ( ( cur % gK ) != ( dest % gK ) ) { 
-	int dist2 = gK - 2 * ( ( ( dest % gK ) - ( cur % gK ) + gK ) % gK );
+      if ( ( cur % gContext->k ) != ( dest % gContext->k ) ) { 
+	int dist2 = gContext->k - 2 * ( ( ( dest % gContext->k ) - ( cur % gContext->k ) + gContext->k ) % gContext->k );
       
 	if ( dist2 >= 0 ) {
 	  outputs->AddRange( 2*n, 0, 0 ); // Right
@@ -1870,11 +1870,11 @@ void chaos_torus( const Router *r, const Flit *f,
 	}
       }
 
-      cur  /= gK;
-      dest /= gK;
+      cur  /= gContext->k;
+      dest /= gContext->k;
     }
   } else {
-    outputs->AddRange( 2*gN, 0, 0 ); 
+    outputs->AddRange( 2*gContext->n, 0, 0 ); 
   }
 }
 
@@ -1895,20 +1895,20 @@ void chaos_mesh( const Router *r, const Flit *f,
   int dest = f->dest;
   
   if ( cur != dest ) {
-    for ( int n = 0; n < gN; ++n ) {
-      if ( ( cur % gK ) != ( dest % gK ) ) { 
+    for ( int n = 0; n < gContext->n; ++n ) {
+      if ( ( cur % gContext->k ) != ( dest % gContext->k ) ) { 
 	// Add minimal direction in dimension 'n'
-	if ( ( cur % gK ) < ( dest % gK ) ) { // Right
+	if ( ( cur % gContext->k ) < ( dest % gContext->k ) ) { // Right
 	  outputs->AddRange( 2*n, 0, 0 ); 
 	} else { // Left
 	  outputs->AddRange( 2*n + 1, 0, 0 ); 
 	}
       }
-      cur  /= gK;
-      dest /= gK;
+      cur  /= gContext->k;
+      dest /= gContext->k;
     }
   } else {
-    outputs->AddRange( 2*gN, 0, 0 ); 
+    outputs->AddRange( 2*gContext->n, 0, 0 ); 
   }
 }
 
@@ -1917,83 +1917,83 @@ void chaos_mesh( const Router *r, const Flit *f,
 void InitializeRoutingMap( const Configuration & config )
 {
 
-  gNumVCs = config.GetInt( "num_vcs" );
+  gContext->num_vcs = config.GetInt( "num_vcs" );
 
   //
   // traffic class partitions
   //
-  gReadReqBeginVC    = config.GetInt("read_request_begin_vc");
-  if(gReadReqBeginVC < 0) {
-    gReadReqBeginVC = 0;
+  gContext->read_req_begin_vc    = config.GetInt("read_request_begin_vc");
+  if(gContext->read_req_begin_vc < 0) {
+    gContext->read_req_begin_vc = 0;
   }
-  gReadReqEndVC      = config.GetInt("read_request_end_vc");
-  if(gReadReqEndVC < 0) {
-    gReadReqEndVC = gNumVCs / 2 - 1;
+  gContext->read_req_end_vc      = config.GetInt("read_request_end_vc");
+  if(gContext->read_req_end_vc < 0) {
+    gContext->read_req_end_vc = gContext->num_vcs / 2 - 1;
   }
-  gWriteReqBeginVC   = config.GetInt("write_request_begin_vc");
-  if(gWriteReqBeginVC < 0) {
-    gWriteReqBeginVC = 0;
+  gContext->write_req_begin_vc   = config.GetInt("write_request_begin_vc");
+  if(gContext->write_req_begin_vc < 0) {
+    gContext->write_req_begin_vc = 0;
   }
-  gWriteReqEndVC     = config.GetInt("write_request_end_vc");
-  if(gWriteReqEndVC < 0) {
-    gWriteReqEndVC = gNumVCs / 2 - 1;
+  gContext->write_req_end_vc     = config.GetInt("write_request_end_vc");
+  if(gContext->write_req_end_vc < 0) {
+    gContext->write_req_end_vc = gContext->num_vcs / 2 - 1;
   }
-  gReadReplyBeginVC  = config.GetInt("read_reply_begin_vc");
-  if(gReadReplyBeginVC < 0) {
-    gReadReplyBeginVC = gNumVCs / 2;
+  gContext->read_reply_begin_vc  = config.GetInt("read_reply_begin_vc");
+  if(gContext->read_reply_begin_vc < 0) {
+    gContext->read_reply_begin_vc = gContext->num_vcs / 2;
   }
-  gReadReplyEndVC    = config.GetInt("read_reply_end_vc");
-  if(gReadReplyEndVC < 0) {
-    gReadReplyEndVC = gNumVCs - 1;
+  gContext->read_reply_end_vc    = config.GetInt("read_reply_end_vc");
+  if(gContext->read_reply_end_vc < 0) {
+    gContext->read_reply_end_vc = gContext->num_vcs - 1;
   }
-  gWriteReplyBeginVC = config.GetInt("write_reply_begin_vc");
-  if(gWriteReplyBeginVC < 0) {
-    gWriteReplyBeginVC = gNumVCs / 2;
+  gContext->write_reply_begin_vc = config.GetInt("write_reply_begin_vc");
+  if(gContext->write_reply_begin_vc < 0) {
+    gContext->write_reply_begin_vc = gContext->num_vcs / 2;
   }
-  gWriteReplyEndVC   = config.GetInt("write_reply_end_vc");
-  if(gWriteReplyEndVC < 0) {
-    gWriteReplyEndVC = gNumVCs - 1;
+  gContext->write_reply_end_vc   = config.GetInt("write_reply_end_vc");
+  if(gContext->write_reply_end_vc < 0) {
+    gContext->write_reply_end_vc = gContext->num_vcs - 1;
   }
 
   /* Register routing functions here */
 
   // ===================================================
   // Balfour-Schultz
-  gRoutingFunctionMap["nca_fattree"]         = &fattree_nca;
-  gRoutingFunctionMap["anca_fattree"]        = &fattree_anca;
-  gRoutingFunctionMap["nca_qtree"]           = &qtree_nca;
-  gRoutingFunctionMap["nca_tree4"]           = &tree4_nca;
-  gRoutingFunctionMap["anca_tree4"]          = &tree4_anca;
-  gRoutingFunctionMap["dor_mesh"]            = &dim_order_mesh;
-  gRoutingFunctionMap["xy_yx_mesh"]          = &xy_yx_mesh;
-  gRoutingFunctionMap["adaptive_xy_yx_mesh"]          = &adaptive_xy_yx_mesh;
+  gContext->routing_function_map["nca_fattree"]         = &fattree_nca;
+  gContext->routing_function_map["anca_fattree"]        = &fattree_anca;
+  gContext->routing_function_map["nca_qtree"]           = &qtree_nca;
+  gContext->routing_function_map["nca_tree4"]           = &tree4_nca;
+  gContext->routing_function_map["anca_tree4"]          = &tree4_anca;
+  gContext->routing_function_map["dor_mesh"]            = &dim_order_mesh;
+  gContext->routing_function_map["xy_yx_mesh"]          = &xy_yx_mesh;
+  gContext->routing_function_map["adaptive_xy_yx_mesh"]          = &adaptive_xy_yx_mesh;
   // End Balfour-Schultz
   // ===================================================
 
-  gRoutingFunctionMap["dim_order_mesh"]  = &dim_order_mesh;
-  gRoutingFunctionMap["dim_order_ni_mesh"]  = &dim_order_ni_mesh;
-  gRoutingFunctionMap["dim_order_pni_mesh"]  = &dim_order_pni_mesh;
-  gRoutingFunctionMap["dim_order_torus"] = &dim_order_torus;
-  gRoutingFunctionMap["dim_order_ni_torus"] = &dim_order_ni_torus;
-  gRoutingFunctionMap["dim_order_bal_torus"] = &dim_order_bal_torus;
+  gContext->routing_function_map["dim_order_mesh"]  = &dim_order_mesh;
+  gContext->routing_function_map["dim_order_ni_mesh"]  = &dim_order_ni_mesh;
+  gContext->routing_function_map["dim_order_pni_mesh"]  = &dim_order_pni_mesh;
+  gContext->routing_function_map["dim_order_torus"] = &dim_order_torus;
+  gContext->routing_function_map["dim_order_ni_torus"] = &dim_order_ni_torus;
+  gContext->routing_function_map["dim_order_bal_torus"] = &dim_order_bal_torus;
 
-  gRoutingFunctionMap["romm_mesh"]       = &romm_mesh; 
-  gRoutingFunctionMap["romm_ni_mesh"]    = &romm_ni_mesh;
+  gContext->routing_function_map["romm_mesh"]       = &romm_mesh; 
+  gContext->routing_function_map["romm_ni_mesh"]    = &romm_ni_mesh;
 
-  gRoutingFunctionMap["min_adapt_mesh"]   = &min_adapt_mesh;
-  gRoutingFunctionMap["min_adapt_torus"]  = &min_adapt_torus;
+  gContext->routing_function_map["min_adapt_mesh"]   = &min_adapt_mesh;
+  gContext->routing_function_map["min_adapt_torus"]  = &min_adapt_torus;
 
-  gRoutingFunctionMap["planar_adapt_mesh"] = &planar_adapt_mesh;
+  gContext->routing_function_map["planar_adapt_mesh"] = &planar_adapt_mesh;
 
   // FIXME: This is broken.
-  //  gRoutingFunctionMap["limited_adapt_mesh"] = &limited_adapt_mesh;
+  //  gContext->routing_function_map["limited_adapt_mesh"] = &limited_adapt_mesh;
 
-  gRoutingFunctionMap["valiant_mesh"]  = &valiant_mesh;
-  gRoutingFunctionMap["valiant_torus"] = &valiant_torus;
-  gRoutingFunctionMap["valiant_ni_torus"] = &valiant_ni_torus;
+  gContext->routing_function_map["valiant_mesh"]  = &valiant_mesh;
+  gContext->routing_function_map["valiant_torus"] = &valiant_torus;
+  gContext->routing_function_map["valiant_ni_torus"] = &valiant_ni_torus;
 
-  gRoutingFunctionMap["dest_tag_fly"] = &dest_tag_fly;
+  gContext->routing_function_map["dest_tag_fly"] = &dest_tag_fly;
 
-  gRoutingFunctionMap["chaos_mesh"]  = &chaos_mesh;
-  gRoutingFunctionMap["chaos_torus"] = &chaos_torus;
+  gContext->routing_function_map["chaos_mesh"]  = &chaos_mesh;
+  gContext->routing_function_map["chaos_torus"] = &chaos_torus;
 }
@@ -60,8 +60,8 @@ ChaosRouter::ChaosRouter( const Configuration& config,
   // Routing
 
   string rf = config.GetStr("routing_function") + "_" + config.GetStr("topology");
-  map<string, tRoutingFunction>::iterator rf_iter = gRoutingFunctionMap.find(rf);
-  if(rf_iter == gRoutingFunctionMap.end()) {
+  map<string, tRoutingFunction>::iterator rf_iter = gContext->routing_function_map.find(rf);
+  if(rf_iter == gContext->routing_function_map.end()) {
     Error("Invalid routing function: " + rf);
   }
   _rf = rf_iter->second;
@@ -138,7 +138,7 @@ void ChaosRouter::ReadInputs( )
       _input_frame[input].push( f );
 
       if ( f->watch ) {
-	*gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	*gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		    << "Flit arriving at " << FullName() 
 		    << " on channel " << input << endl
 		    << *f;
@@ -512,7 +512,7 @@ void ChaosRouter::_OutputAdvance( )
 	_crossbar_pipe->Write( f, _input_output_match[i] );
 	
 	if ( f->watch ) {
-	  *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	  *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		      << "Flit traversing crossbar from input queue " 
 		      << i << " at " 
 		      << FullName() << endl
@@ -553,7 +553,7 @@ void ChaosRouter::_OutputAdvance( )
 	_multi_queue[mq].push( f );
 	
 	if ( f->watch ) {
-	  *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	  *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		      << "Flit stored in multiqueue at " 
 		      << FullName() << endl
 		      << "State = " << _multi_state[mq] << endl
@@ -581,7 +581,7 @@ void ChaosRouter::_OutputAdvance( )
 	}
 	
 	c = Credit::New( );
-	c->vc.insert(0);
+	c->AddVC(0);
 	_credit_queue[i].push( c );
       }
     }
@@ -600,7 +600,7 @@ void ChaosRouter::_OutputAdvance( )
       _crossbar_pipe->Write( f, _multi_match[m] );
 
       if ( f->watch ) {
-	*gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	*gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		    << "Flit traversing crossbar from multiqueue slot "
 		    << m << " at " 
 		    << FullName() << endl
@@ -668,6 +668,11 @@ void ChaosRouter::_SendCredits( )
   }
 }
 
+void ChaosRouter::SyncState( Checkpoint & cp )
+{
+  Error( "Checkpoints are not supported by this router type." );
+}
+
 void ChaosRouter::Display( ostream & os ) const
 {
 }
@@ -114,6 +114,8 @@ public:
   virtual void ReadInputs( );
   virtual void WriteOutputs( );
 
+  virtual void SyncState( Checkpoint & cp );
+
   virtual int GetUsedCredit(int out) const {return 0;}
   virtual int GetBufferOccupancy(int i) const {return 0;}
 
@@ -56,8 +56,8 @@ EventRouter::EventRouter( const Configuration& config,
   // Routing
 
   string rf = config.GetStr("routing_function") + "_" + config.GetStr("topology");
-  map<string, tRoutingFunction>::iterator rf_iter = gRoutingFunctionMap.find(rf);
-  if(rf_iter == gRoutingFunctionMap.end()) {
+  map<string, tRoutingFunction>::iterator rf_iter = gContext->routing_function_map.find(rf);
+  if(rf_iter == gContext->routing_function_map.end()) {
     Error("Invalid routing function: " + rf);
   }
   _rf = rf_iter->second;
@@ -354,7 +354,7 @@ void EventRouter::_IncomingFlits( )
       }
       
       if ( f->watch ) {
-	*gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	*gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		    << "Received flit at " << FullName() << ".  Output port = " 
 		    << cur_buf->GetOutputPort( vc ) << ", output VC = " 
 		    << cur_buf->GetOutputVC( vc ) << endl
@@ -470,8 +470,8 @@ void EventRouter::_ArrivalArb( int output )
     c = _out_cred_buffer[output].front( );
     _out_cred_buffer[output].pop( );
     
-    assert( c->vc.size() == 1 );
-    int vc = *c->vc.begin();
+    assert( c->NumVCs() == 1 );
+    int vc = c->FirstVC();
 
     EventNextVCState::eNextVCState state = 
       _output_state[output]->GetState( vc );
@@ -671,14 +671,14 @@ void EventRouter::_TransportArb( int input )
     }
 
     c = Credit::New( );
-    c->vc.insert(f->vc);
+    c->AddVC(f->vc);
     c->head          = f->head;
     c->tail          = f->tail;
     c->id            = f->id;
     _credit_pipe->Write( c, input );
     
     if ( f->watch && c->tail ) {
-      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		  << FullName() << " sending tail credit back for flit " << f->id << endl;
     }
 
@@ -689,7 +689,7 @@ void EventRouter::_TransportArb( int input )
     _crossbar_pipe->Write( f, output );
 
     if ( f->watch ) {
-      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		  << "Forwarding flit through crossbar at " << FullName() << ":" << endl
 		  << *f;
     }  
@@ -740,6 +740,11 @@ void EventRouter::_SendCredits( )
   }
 }
 
+void EventRouter::SyncState( Checkpoint & cp )
+{
+  Error( "Checkpoints are not supported by this router type." );
+}
+
 void EventRouter::Display( ostream & os ) const
 {
   for ( int input = 0; input < _inputs; ++input ) {
@@ -169,6 +169,8 @@ public:
   virtual void ReadInputs( );
   virtual void WriteOutputs( );
 
+  virtual void SyncState( Checkpoint & cp );
+
   virtual int GetUsedCredit(int o) const {return 0;}
   virtual int GetBufferOccupancy(int i) const {return 0;}
 
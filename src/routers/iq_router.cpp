@@ -33,6 +33,7 @@
 #include <iomanip>
 #include <cstdlib>
 #include <cassert>
+#include <cmath>
 #include <limits>
 
 #include "globals.hpp"
@@ -46,6 +47,7 @@
 #include "allocator.hpp"
 #include "switch_monitor.hpp"
 #include "buffer_monitor.hpp"
+#include "checkpoint.hpp"
 
 IQRouter::IQRouter( Configuration const & config, Module *parent, 
 		    string const & name, int id, int inputs, int outputs )
@@ -74,8 +76,8 @@ IQRouter::IQRouter( Configuration const & config, Module *parent,
 
   // Routing
   string const rf = config.GetStr("routing_function") + "_" + config.GetStr("topology");
-  map<string, tRoutingFunction>::const_iterator rf_iter = gRoutingFunctionMap.find(rf);
-  if(rf_iter == gRoutingFunctionMap.end()) {
+  map<string, tRoutingFunction>::const_iterator rf_iter = gContext->routing_function_map.find(rf);
+  if(rf_iter == gContext->routing_function_map.end()) {
     Error("Invalid routing function: " + rf);
   }
   _rf = rf_iter->second;
@@ -161,6 +163,7 @@ IQRouter::IQRouter( Configuration const & config, Module *parent,
   _output_buffer_size = config.GetInt("output_buffer_size");
   _output_buffer.resize(_outputs); 
   _credit_buffer.resize(_inputs); 
+  _out_queue_credits.resize(_inputs, NULL);
 
   // Switch configuration (when held for multiple cycles)
   _hold_switch_for_packet = (config.GetInt("hold_switch_for_packet") > 0);
@@ -168,6 +171,17 @@ IQRouter::IQRouter( Configuration const & config, Module *parent,
   _switch_hold_out.resize(_outputs*_output_speedup, -1);
   _switch_hold_vc.resize(_inputs*_input_speedup, -1);
 
+  // Pipeline stages: an input VC waits in at most one entry of each stage, 
+  // each input and output delivers one flit or credit per cycle, and the 
+  // crossbar accepts one flit per expanded input per cycle
+  _in_queue_flits.Reserve(_inputs);
+  _proc_credits.Reserve(_outputs*(_credit_delay+1));
+  _route_vcs.Reserve(_inputs*_vcs);
+  _vc_alloc_vcs.Reserve(_inputs*_vcs);
+  _sw_hold_vcs.Reserve(_inputs*_vcs);
+  _sw_alloc_vcs.Reserve(_inputs*_vcs);
+  _crossbar_flits.Reserve(_inputs*_input_speedup*(_crossbar_delay+1));
+
   _bufferMonitor = new BufferMonitor(inputs, _classes);
   _switchMonitor = new SwitchMonitor(inputs, outputs, _classes);
 
@@ -183,14 +197,14 @@ IQRouter::IQRouter( Configuration const & config, Module *parent,
 IQRouter::~IQRouter( )
 {
 
-  if(gPrintActivity) {
-    cout << Name() << ".bufferMonitor:" << endl ; 
-    cout << *_bufferMonitor << endl ;
+  if(gContext->print_activity) {
+    *gContext->out << Name() << ".bufferMonitor:" << endl ; 
+    *gContext->out << *_bufferMonitor << endl ;
     
-    cout << Name() << ".switchMonitor:" << endl ; 
-    cout << "Inputs=" << _inputs ;
-    cout << "Outputs=" << _outputs ;
-    cout << *_switchMonitor << endl ;
+    *gContext->out << Name() << ".switchMonitor:" << endl ; 
+    *gContext->out << "Inputs=" << _inputs ;
+    *gContext->out << "Outputs=" << _outputs ;
+    *gContext->out << *_switchMonitor << endl ;
   }
 
   for(int i = 0; i < _inputs; ++i)
@@ -230,48 +244,48 @@ void IQRouter::_InternalStep( )
   }
 
   _InputQueuing( );
-  bool activity = !_proc_credits.empty();
+  bool activity = !_proc_credits.Empty();
 
-  if(!_route_vcs.empty())
+  if(!_route_vcs.Empty())
     _RouteEvaluate( );
   if(_vc_allocator) {
     _vc_allocator->Clear();
-    if(!_vc_alloc_vcs.empty())
+    if(!_vc_alloc_vcs.Empty())
       _VCAllocEvaluate( );
   }
   if(_hold_switch_for_packet) {
-    if(!_sw_hold_vcs.empty())
+    if(!_sw_hold_vcs.Empty())
       _SWHoldEvaluate( );
   }
   _sw_allocator->Clear();
   if(_spec_sw_allocator)
     _spec_sw_allocator->Clear();
-  if(!_sw_alloc_vcs.empty())
+  if(!_sw_alloc_vcs.Empty())
     _SWAllocEvaluate( );
-  if(!_crossbar_flits.empty())
+  if(!_crossbar_flits.Empty())
     _SwitchEvaluate( );
 
-  if(!_route_vcs.empty()) {
+  if(!_route_vcs.Empty()) {
     _RouteUpdate( );
-    activity = activity || !_route_vcs.empty();
+    activity = activity || !_route_vcs.Empty();
   }
-  if(!_vc_alloc_vcs.empty()) {
+  if(!_vc_alloc_vcs.Empty()) {
     _VCAllocUpdate( );
-    activity = activity || !_vc_alloc_vcs.empty();
+    activity = activity || !_vc_alloc_vcs.Empty();
   }
   if(_hold_switch_for_packet) {
-    if(!_sw_hold_vcs.empty()) {
+    if(!_sw_hold_vcs.Empty()) {
       _SWHoldUpdate( );
-      activity = activity || !_sw_hold_vcs.empty();
+      activity = activity || !_sw_hold_vcs.Empty();
     }
   }
-  if(!_sw_alloc_vcs.empty()) {
+  if(!_sw_alloc_vcs.Empty()) {
     _SWAllocUpdate( );
-    activity = activity || !_sw_alloc_vcs.empty();
+    activity = activity || !_sw_alloc_vcs.Empty();
   }
-  if(!_crossbar_flits.empty()) {
+  if(!_crossbar_flits.Empty()) {
     _SwitchUpdate( );
-    activity = activity || !_crossbar_flits.empty();
+    activity = activity || !_crossbar_flits.Empty();
   }
 
   _active = activity;
@@ -288,6 +302,27 @@ void IQRouter::WriteOutputs( )
   _SendCredits( );
 }
 
+bool IQRouter::Idle( ) const
+{
+  // with a fractional speedup, every call to Evaluate advances the internal
+  // cycle phase, so skipping the router would shift it
+  if(_active || (_internal_speedup != floor(_internal_speedup)) ||
+     !_in_queue_flits.Empty() || !_proc_credits.Empty()) {
+    return false;
+  }
+  for(int output = 0; output < _outputs; ++output) {
+    if(!_output_buffer[output].empty()) {
+      return false;
+    }
+  }
+  for(int input = 0; input < _inputs; ++input) {
+    if(!_credit_buffer[input].empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 
 //------------------------------------------------------------------------------
 // read inputs
@@ -305,12 +340,12 @@ bool IQRouter::_ReceiveFlits( )
 #endif
 
       if(f->watch) {
-	*gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	*gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		   << "Received flit " << f->id
 		   << " from channel at input " << input
 		   << "." << endl;
       }
-      _in_queue_flits.insert(make_pair(input, f));
+      _in_queue_flits.PushBack(GetSimTime(), sFlitEntry(f, input));
       activity = true;
     }
   }
@@ -323,8 +358,7 @@ bool IQRouter::_ReceiveCredits( )
   for(int output = 0; output < _outputs; ++output) {  
     Credit * const c = _output_credits[output]->Receive();
     if(c) {
-      _proc_credits.push_back(make_pair(GetSimTime() + _credit_delay, 
-					make_pair(c, output)));
+      _proc_credits.PushBack(GetSimTime() + _credit_delay, sCreditEntry(c, output));
       activity = true;
     }
   }
@@ -338,14 +372,14 @@ bool IQRouter::_ReceiveCredits( )
 
 void IQRouter::_InputQueuing( )
 {
-  for(map<int, Flit *>::const_iterator iter = _in_queue_flits.begin();
-      iter != _in_queue_flits.end();
-      ++iter) {
+  for(int i = 0; i < _in_queue_flits.Size(); ++i) {
+
+    sFlitEntry const & entry = _in_queue_flits.Entry(i);
 
-    int const input = iter->first;
+    int const input = entry.input;
     assert((input >= 0) && (input < _inputs));
 
-    Flit * const f = iter->second;
+    Flit * const f = entry.f;
     assert(f);
 
     int const vc = f->vc;
@@ -354,18 +388,18 @@ void IQRouter::_InputQueuing( )
     Buffer * const cur_buf = _buf[input];
 
     if(f->watch) {
-      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		 << "Adding flit " << f->id
 		 << " to VC " << vc
 		 << " at input " << input
 		 << " (state: " << VC::VCSTATE[cur_buf->GetState(vc)];
       if(cur_buf->Empty(vc)) {
-	*gWatchOut << ", empty";
+	*gContext->watch_out << ", empty";
       } else {
 	assert(cur_buf->FrontFlit(vc));
-	*gWatchOut << ", front: " << cur_buf->FrontFlit(vc)->id;
+	*gContext->watch_out << ", front: " << cur_buf->FrontFlit(vc)->id;
       }
-      *gWatchOut << ")." << endl;
+      *gContext->watch_out << ")." << endl;
     }
     cur_buf->AddFlit(vc, f);
 
@@ -383,24 +417,22 @@ void IQRouter::_InputQueuing( )
       assert(_switch_hold_vc[input*_input_speedup + vc%_input_speedup] != vc);
       if(_routing_delay) {
 	cur_buf->SetState(vc, VC::routing);
-	_route_vcs.push_back(make_pair(-1, make_pair(input, vc)));
+	_route_vcs.PushBack(-1, sVCEntry(input, vc));
       } else {
 	if(f->watch) {
-	  *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	  *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		     << "Using precomputed lookahead routing information for VC " << vc
 		     << " at input " << input
 		     << " (front: " << f->id
 		     << ")." << endl;
 	}
-	cur_buf->SetRouteSet(vc, &f->la_route_set);
+	cur_buf->SetRouteSet(vc, f->LookaheadRouteSet());
 	cur_buf->SetState(vc, VC::vc_alloc);
 	if(_speculative) {
-	  _sw_alloc_vcs.push_back(make_pair(-1, make_pair(make_pair(input, vc),
-							  -1)));
+	  _sw_alloc_vcs.PushBack(-1, sVCEntry(input, vc));
 	}
 	if(_vc_allocator) {
-	  _vc_alloc_vcs.push_back(make_pair(-1, make_pair(make_pair(input, vc), 
-							  -1)));
+	  _vc_alloc_vcs.PushBack(-1, sVCEntry(input, vc));
 	}
 	if(_noq) {
 	  _UpdateNOQ(input, vc, f);
@@ -409,36 +441,33 @@ void IQRouter::_InputQueuing( )
     } else if((cur_buf->GetState(vc) == VC::active) &&
 	      (cur_buf->FrontFlit(vc) == f)) {
       if(_switch_hold_vc[input*_input_speedup + vc%_input_speedup] == vc) {
-	_sw_hold_vcs.push_back(make_pair(-1, make_pair(make_pair(input, vc),
-						       -1)));
+	_sw_hold_vcs.PushBack(-1, sVCEntry(input, vc));
       } else {
-	_sw_alloc_vcs.push_back(make_pair(-1, make_pair(make_pair(input, vc), 
-							-1)));
+	_sw_alloc_vcs.PushBack(-1, sVCEntry(input, vc));
       }
     }
   }
-  _in_queue_flits.clear();
-
-  while(!_proc_credits.empty()) {
+  _in_queue_flits.Clear();
 
-    pair<int, pair<Credit *, int> > const & item = _proc_credits.front();
+  while(!_proc_credits.Empty()) {
 
-    int const time = item.first;
+    int const time = _proc_credits.Time(0);
     if(GetSimTime() < time) {
       break;
     }
 
-    Credit * const c = item.second.first;
+    sCreditEntry const item = _proc_credits.Entry(0);
+
+    Credit * const c = item.c;
     assert(c);
 
-    int const output = item.second.second;
+    int const output = item.output;
     assert((output >= 0) && (output < _outputs));
     
     BufferState * const dest_buf = _next_buf[output];
     
 #ifdef TRACK_FLOWS
-    for(set<int>::const_iterator iter = c->vc.begin(); iter != c->vc.end(); ++iter) {
-      int const vc = *iter;
+    for(int vc = c->FirstVC(); vc >= 0; vc = c->NextVC(vc)) {
       assert(!_outstanding_classes[output][vc].empty());
       int cl = _outstanding_classes[output][vc].front();
       _outstanding_classes[output][vc].pop();
@@ -449,7 +478,7 @@ void IQRouter::_InputQueuing( )
 
     dest_buf->ProcessCredit(c);
     c->Free();
-    _proc_credits.pop_front();
+    _proc_credits.PopFront();
   }
 }
 
@@ -462,19 +491,19 @@ void IQRouter::_RouteEvaluate( )
 {
   assert(_routing_delay);
 
-  for(deque<pair<int, pair<int, int> > >::iterator iter = _route_vcs.begin();
-      iter != _route_vcs.end();
-      ++iter) {
-    
-    int const time = iter->first;
+  for(int i = 0; i < _route_vcs.Size(); ++i) {
+
+    int const time = _route_vcs.Time(i);
     if(time >= 0) {
       break;
     }
-    iter->first = GetSimTime() + _routing_delay - 1;
+
+    sVCEntry & entry = _route_vcs.Entry(i);
+    _route_vcs.Time(i) = GetSimTime() + _routing_delay - 1;
     
-    int const input = iter->second.first;
+    int const input = entry.input;
     assert((input >= 0) && (input < _inputs));
-    int const vc = iter->second.second;
+    int const vc = entry.vc;
     assert((vc >= 0) && (vc < _vcs));
 
     Buffer const * const cur_buf = _buf[input];
@@ -487,7 +516,7 @@ void IQRouter::_RouteEvaluate( )
     assert(f->head);
 
     if(f->watch) {
-      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		 << "Beginning routing for VC " << vc
 		 << " at input " << input
 		 << " (front: " << f->id
@@ -500,19 +529,19 @@ void IQRouter::_RouteUpdate( )
 {
   assert(_routing_delay);
 
-  while(!_route_vcs.empty()) {
+  while(!_route_vcs.Empty()) {
 
-    pair<int, pair<int, int> > const & item = _route_vcs.front();
-
-    int const time = item.first;
+    int const time = _route_vcs.Time(0);
     if((time < 0) || (GetSimTime() < time)) {
       break;
     }
     assert(GetSimTime() == time);
 
-    int const input = item.second.first;
+    sVCEntry const item = _route_vcs.Entry(0);
+
+    int const input = item.input;
     assert((input >= 0) && (input < _inputs));
-    int const vc = item.second.second;
+    int const vc = item.vc;
     assert((vc >= 0) && (vc < _vcs));
     
     Buffer * const cur_buf = _buf[input];
@@ -525,7 +554,7 @@ void IQRouter::_RouteUpdate( )
     assert(f->head);
 
     if(f->watch) {
-      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		 << "Completed routing for VC " << vc
 		 << " at input " << input
 		 << " (front: " << f->id
@@ -535,13 +564,13 @@ void IQRouter::_RouteUpdate( )
     cur_buf->Route(vc, _rf, this, f, input);
     cur_buf->SetState(vc, VC::vc_alloc);
     if(_speculative) {
-      _sw_alloc_vcs.push_back(make_pair(-1, make_pair(item.second, -1)));
+      _sw_alloc_vcs.PushBack(-1, sVCEntry(item.input, item.vc));
     }
     if(_vc_allocator) {
-      _vc_alloc_vcs.push_back(make_pair(-1, make_pair(item.second, -1)));
+      _vc_alloc_vcs.PushBack(-1, sVCEntry(item.input, item.vc));
     }
     // NOTE: No need to handle NOQ here, as it requires lookahead routing!
-    _route_vcs.pop_front();
+    _route_vcs.PopFront();
   }
 }
 
@@ -556,21 +585,21 @@ void IQRouter::_VCAllocEvaluate( )
 
   bool watched = false;
 
-  for(deque<pair<int, pair<pair<int, int>, int> > >::iterator iter = _vc_alloc_vcs.begin();
-      iter != _vc_alloc_vcs.end();
-      ++iter) {
+  for(int i = 0; i < _vc_alloc_vcs.Size(); ++i) {
 
-    int const time = iter->first;
+    int const time = _vc_alloc_vcs.Time(i);
     if(time >= 0) {
       break;
     }
 
-    int const input = iter->second.first.first;
+    sVCEntry & entry = _vc_alloc_vcs.Entry(i);
+
+    int const input = entry.input;
     assert((input >= 0) && (input < _inputs));
-    int const vc = iter->second.first.second;
+    int const vc = entry.vc;
     assert((vc >= 0) && (vc < _vcs));
 
-    assert(iter->second.second == -1);
+    assert(entry.outcome == -1);
 
     Buffer const * const cur_buf = _buf[input];
     assert(!cur_buf->Empty(vc));
@@ -582,7 +611,7 @@ void IQRouter::_VCAllocEvaluate( )
     assert(f->head);
 
     if(f->watch) {
-      *gWatchOut << GetSimTime() << " | " << FullName() << " | " 
+      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | " 
 		 << "Beginning VC allocation for VC " << vc
 		 << " at input " << input
 		 << " (front: " << f->id
@@ -593,7 +622,7 @@ void IQRouter::_VCAllocEvaluate( )
     assert(route_set);
 
     int const out_priority = cur_buf->GetPriority(vc);
-    set<OutputSet::sSetElement> const setlist = route_set->GetSet();
+    OutputSet::ElementSet const & setlist = route_set->GetSet();
 
     bool elig = false;
     bool cred = false;
@@ -601,7 +630,7 @@ void IQRouter::_VCAllocEvaluate( )
 
     assert(!_noq || (setlist.size() == 1));
 
-    for(set<OutputSet::sSetElement>::const_iterator iset = setlist.begin();
+    for(OutputSet::ElementSet::const_iterator iset = setlist.begin();
 	iset != setlist.end();
 	++iset) {
 
@@ -645,24 +674,24 @@ void IQRouter::_VCAllocEvaluate( )
 	    int const use_input_and_vc = dest_buf->UsedBy(out_vc);
 	    int const use_input = use_input_and_vc / _vcs;
 	    int const use_vc = use_input_and_vc % _vcs;
-	    *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	    *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		       << "  VC " << out_vc 
 		       << " at output " << out_port 
 		       << " is in use by VC " << use_vc
 		       << " at input " << use_input;
 	    Flit * cf = _buf[use_input]->FrontFlit(use_vc);
 	    if(cf) {
-	      *gWatchOut << " (front flit: " << cf->id << ")";
+	      *gContext->watch_out << " (front flit: " << cf->id << ")";
 	    } else {
-	      *gWatchOut << " (empty)";
+	      *gContext->watch_out << " (empty)";
 	    }
-	    *gWatchOut << "." << endl;
+	    *gContext->watch_out << "." << endl;
 	  }
 	} else {
 	  elig = true;
 	  if(_vc_busy_when_full && dest_buf->IsFullFor(out_vc)) {
 	    if(f->watch)
-	      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 			 << "  VC " << out_vc 
 			 << " at output " << out_port 
 			 << " is full." << endl;
@@ -670,7 +699,7 @@ void IQRouter::_VCAllocEvaluate( )
 	  } else {
 	    cred = true;
 	    if(f->watch){
-	      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 			 << "  Requesting VC " << out_vc
 			 << " at output " << out_port 
 			 << " (in_pri: " << in_priority
@@ -687,44 +716,44 @@ void IQRouter::_VCAllocEvaluate( )
       }
     }
     if(!elig) {
-      iter->second.second = STALL_BUFFER_BUSY;
+      entry.outcome = STALL_BUFFER_BUSY;
     } else if(_vc_busy_when_full && !cred) {
-      iter->second.second = reserved ? STALL_BUFFER_RESERVED : STALL_BUFFER_FULL;
+      entry.outcome = reserved ? STALL_BUFFER_RESERVED : STALL_BUFFER_FULL;
     }
   }
 
   if(watched) {
-    *gWatchOut << GetSimTime() << " | " << _vc_allocator->FullName() << " | ";
-    _vc_allocator->PrintRequests( gWatchOut );
+    *gContext->watch_out << GetSimTime() << " | " << _vc_allocator->FullName() << " | ";
+    _vc_allocator->PrintRequests( gContext->watch_out );
   }
 
   _vc_allocator->Allocate();
 
   if(watched) {
-    *gWatchOut << GetSimTime() << " | " << _vc_allocator->FullName() << " | ";
-    _vc_allocator->PrintGrants( gWatchOut );
+    *gContext->watch_out << GetSimTime() << " | " << _vc_allocator->FullName() << " | ";
+    _vc_allocator->PrintGrants( gContext->watch_out );
   }
 
-  for(deque<pair<int, pair<pair<int, int>, int> > >::iterator iter = _vc_alloc_vcs.begin();
-      iter != _vc_alloc_vcs.end();
-      ++iter) {
+  for(int i = 0; i < _vc_alloc_vcs.Size(); ++i) {
 
-    int const time = iter->first;
+    int const time = _vc_alloc_vcs.Time(i);
     if(time >= 0) {
       break;
     }
-    iter->first = GetSimTime() + _vc_alloc_delay - 1;
 
-    int const input = iter->second.first.first;
+    sVCEntry & entry = _vc_alloc_vcs.Entry(i);
+    _vc_alloc_vcs.Time(i) = GetSimTime() + _vc_alloc_delay - 1;
+
+    int const input = entry.input;
     assert((input >= 0) && (input < _inputs));
-    int const vc = iter->second.first.second;
+    int const vc = entry.vc;
     assert((vc >= 0) && (vc < _vcs));
 
-    if(iter->second.second < -1) {
+    if(entry.outcome < -1) {
       continue;
     }
 
-    assert(iter->second.second == -1);
+    assert(entry.outcome == -1);
 
     Buffer const * const cur_buf = _buf[input];
     assert(!cur_buf->Empty(vc));
@@ -747,7 +776,7 @@ void IQRouter::_VCAllocEvaluate( )
       assert((match_vc >= 0) && (match_vc < _vcs));
 
       if(f->watch) {
-	*gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	*gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		   << "Assigning VC " << match_vc
 		   << " at output " << match_output 
 		   << " to VC " << vc
@@ -755,18 +784,18 @@ void IQRouter::_VCAllocEvaluate( )
 		   << "." << endl;
       }
 
-      iter->second.second = output_and_vc;
+      entry.outcome = output_and_vc;
 
     } else {
 
       if(f->watch) {
-	*gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	*gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		   << "VC allocation failed for VC " << vc
 		   << " at input " << input
 		   << "." << endl;
       }
       
-      iter->second.second = STALL_BUFFER_CONFLICT;
+      entry.outcome = STALL_BUFFER_CONFLICT;
 
     }
   }
@@ -775,19 +804,19 @@ void IQRouter::_VCAllocEvaluate( )
     return;
   }
 
-  for(deque<pair<int, pair<pair<int, int>, int> > >::iterator iter = _vc_alloc_vcs.begin();
-      iter != _vc_alloc_vcs.end();
-      ++iter) {
-    
-    int const time = iter->first;
+  for(int i = 0; i < _vc_alloc_vcs.Size(); ++i) {
+
+    int const time = _vc_alloc_vcs.Time(i);
     assert(time >= 0);
     if(GetSimTime() < time) {
       break;
     }
+
+    sVCEntry & entry = _vc_alloc_vcs.Entry(i);
     
-    assert(iter->second.second != -1);
+    assert(entry.outcome != -1);
 
-    int const output_and_vc = iter->second.second;
+    int const output_and_vc = entry.outcome;
     
     if(output_and_vc >= 0) {
       
@@ -798,9 +827,9 @@ void IQRouter::_VCAllocEvaluate( )
       
       BufferState const * const dest_buf = _next_buf[match_output];
       
-      int const input = iter->second.first.first;
+      int const input = entry.input;
       assert((input >= 0) && (input < _inputs));
-      int const vc = iter->second.first.second;
+      int const vc = entry.vc;
       assert((vc >= 0) && (vc < _vcs));
       
       Buffer const * const cur_buf = _buf[input];
@@ -814,24 +843,24 @@ void IQRouter::_VCAllocEvaluate( )
       
       if(!dest_buf->IsAvailableFor(match_vc)) {
 	if(f->watch) {
-	  *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	  *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		     << "  Discarding previously generated grant for VC " << vc
 		     << " at input " << input
 		     << ": VC " << match_vc
 		     << " at output " << match_output
 		     << " is no longer available." << endl;
 	}
-	iter->second.second = STALL_BUFFER_BUSY;
+	entry.outcome = STALL_BUFFER_BUSY;
       } else if(_vc_busy_when_full && dest_buf->IsFullFor(match_vc)) {
 	if(f->watch) {
-	  *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	  *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		     << "  Discarding previously generated grant for VC " << vc
 		     << " at input " << input
 		     << ": VC " << match_vc
 		     << " at output " << match_output
 		     << " has become full." << endl;
 	}
-	iter->second.second = dest_buf->IsFull() ? STALL_BUFFER_FULL : STALL_BUFFER_RESERVED;
+	entry.outcome = dest_buf->IsFull() ? STALL_BUFFER_FULL : STALL_BUFFER_RESERVED;
       }
     }
   }
@@ -841,22 +870,22 @@ void IQRouter::_VCAllocUpdate( )
 {
   assert(_vc_allocator);
 
-  while(!_vc_alloc_vcs.empty()) {
+  while(!_vc_alloc_vcs.Empty()) {
 
-    pair<int, pair<pair<int, int>, int> > const & item = _vc_alloc_vcs.front();
-
-    int const time = item.first;
+    int const time = _vc_alloc_vcs.Time(0);
     if((time < 0) || (GetSimTime() < time)) {
       break;
     }
     assert(GetSimTime() == time);
 
-    int const input = item.second.first.first;
+    sVCEntry const item = _vc_alloc_vcs.Entry(0);
+
+    int const input = item.input;
     assert((input >= 0) && (input < _inputs));
-    int const vc = item.second.first.second;
+    int const vc = item.vc;
     assert((vc >= 0) && (vc < _vcs));
     
-    assert(item.second.second != -1);
+    assert(item.outcome != -1);
 
     Buffer * const cur_buf = _buf[input];
     assert(!cur_buf->Empty(vc));
@@ -868,14 +897,14 @@ void IQRouter::_VCAllocUpdate( )
     assert(f->head);
     
     if(f->watch) {
-      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		 << "Completed VC allocation for VC " << vc
 		 << " at input " << input
 		 << " (front: " << f->id
 		 << ")." << endl;
     }
     
-    int const output_and_vc = item.second.second;
+    int const output_and_vc = item.outcome;
     
     if(output_and_vc >= 0) {
       
@@ -885,7 +914,7 @@ void IQRouter::_VCAllocUpdate( )
       assert((match_vc >= 0) && (match_vc < _vcs));
       
       if(f->watch) {
-	*gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	*gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		   << "  Acquiring assigned VC " << match_vc
 		   << " at output " << match_output
 		   << "." << endl;
@@ -899,11 +928,11 @@ void IQRouter::_VCAllocUpdate( )
       cur_buf->SetOutput(vc, match_output, match_vc);
       cur_buf->SetState(vc, VC::active);
       if(!_speculative) {
-	_sw_alloc_vcs.push_back(make_pair(-1, make_pair(item.second.first, -1)));
+	_sw_alloc_vcs.PushBack(-1, sVCEntry(item.input, item.vc));
       }
     } else {
       if(f->watch) {
-	*gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	*gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		   << "  No output VC allocated." << endl;
       }
 
@@ -917,9 +946,9 @@ void IQRouter::_VCAllocUpdate( )
       }
 #endif
 
-      _vc_alloc_vcs.push_back(make_pair(-1, make_pair(item.second.first, -1)));
+      _vc_alloc_vcs.PushBack(-1, sVCEntry(item.input, item.vc));
     }
-    _vc_alloc_vcs.pop_front();
+    _vc_alloc_vcs.PopFront();
   }
 }
 
@@ -932,22 +961,22 @@ void IQRouter::_SWHoldEvaluate( )
 {
   assert(_hold_switch_for_packet);
 
-  for(deque<pair<int, pair<pair<int, int>, int> > >::iterator iter = _sw_hold_vcs.begin();
-      iter != _sw_hold_vcs.end();
-      ++iter) {
-    
-    int const time = iter->first;
+  for(int i = 0; i < _sw_hold_vcs.Size(); ++i) {
+
+    int const time = _sw_hold_vcs.Time(i);
     if(time >= 0) {
       break;
     }
-    iter->first = GetSimTime();
+
+    sVCEntry & entry = _sw_hold_vcs.Entry(i);
+    _sw_hold_vcs.Time(i) = GetSimTime();
     
-    int const input = iter->second.first.first;
+    int const input = entry.input;
     assert((input >= 0) && (input < _inputs));
-    int const vc = iter->second.first.second;
+    int const vc = entry.vc;
     assert((vc >= 0) && (vc < _vcs));
     
-    assert(iter->second.second == -1);
+    assert(entry.outcome == -1);
 
     Buffer const * const cur_buf = _buf[input];
     assert(!cur_buf->Empty(vc));
@@ -958,7 +987,7 @@ void IQRouter::_SWHoldEvaluate( )
     assert(f->vc == vc);
 
     if(f->watch) {
-      *gWatchOut << GetSimTime() << " | " << FullName() << " | " 
+      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | " 
 		 << "Beginning held switch allocation for VC " << vc
 		 << " at input " << input
 		 << " (front: " << f->id
@@ -980,24 +1009,24 @@ void IQRouter::_SWHoldEvaluate( )
     
     if(dest_buf->IsFullFor(match_vc)) {
       if(f->watch) {
-	*gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	*gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		   << "  Unable to reuse held connection from input " << input
 		   << "." << (expanded_input % _input_speedup)
 		   << " to output " << match_port
 		   << "." << (expanded_output % _output_speedup)
 		   << ": No credit available." << endl;
       }
-      iter->second.second = dest_buf->IsFull() ? STALL_BUFFER_FULL : STALL_BUFFER_RESERVED;
+      entry.outcome = dest_buf->IsFull() ? STALL_BUFFER_FULL : STALL_BUFFER_RESERVED;
     } else {
       if(f->watch) {
-	*gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	*gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		   << "  Reusing held connection from input " << input
 		   << "." << (expanded_input % _input_speedup)
 		   << " to output " << match_port
 		   << "." << (expanded_output % _output_speedup)
 		   << "." << endl;
       }
-      iter->second.second = expanded_output;
+      entry.outcome = expanded_output;
     }
   }
 }
@@ -1006,22 +1035,22 @@ void IQRouter::_SWHoldUpdate( )
 {
   assert(_hold_switch_for_packet);
 
-  while(!_sw_hold_vcs.empty()) {
-    
-    pair<int, pair<pair<int, int>, int> > const & item = _sw_hold_vcs.front();
-    
-    int const time = item.first;
+  while(!_sw_hold_vcs.Empty()) {
+
+    int const time = _sw_hold_vcs.Time(0);
     if(time < 0) {
       break;
     }
     assert(GetSimTime() == time);
+
+    sVCEntry const item = _sw_hold_vcs.Entry(0);
     
-    int const input = item.second.first.first;
+    int const input = item.input;
     assert((input >= 0) && (input < _inputs));
-    int const vc = item.second.first.second;
+    int const vc = item.vc;
     assert((vc >= 0) && (vc < _vcs));
     
-    assert(item.second.second != -1);
+    assert(item.outcome != -1);
 
     Buffer * const cur_buf = _buf[input];
     assert(!cur_buf->Empty(vc));
@@ -1032,7 +1061,7 @@ void IQRouter::_SWHoldUpdate( )
     assert(f->vc == vc);
 
     if(f->watch) {
-      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		 << "Completed held switch allocation for VC " << vc
 		 << " at input " << input
 		 << " (front: " << f->id
@@ -1042,7 +1071,7 @@ void IQRouter::_SWHoldUpdate( )
     int const expanded_input = input * _input_speedup + vc % _input_speedup;
     assert(_switch_hold_vc[expanded_input] == vc);
     
-    int const expanded_output = item.second.second;
+    int const expanded_output = item.outcome;
     
     if(expanded_output >= 0 && ( _output_buffer_size==-1 || _output_buffer[expanded_output].size()<size_t(_output_buffer_size))) {
       
@@ -1059,7 +1088,7 @@ void IQRouter::_SWHoldUpdate( )
       BufferState * const dest_buf = _next_buf[output];
       
       if(f->watch) {
-	*gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	*gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		   << "  Scheduling switch connection from input " << input
 		   << "." << (vc % _input_speedup)
 		   << " to output " << output
@@ -1085,7 +1114,7 @@ void IQRouter::_SWHoldUpdate( )
 	if(router) {
 	  if(_noq) {
 	    if(f->watch) {
-	      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 			 << "Updating lookahead routing information for flit " << f->id
 			 << " (NOQ)." << endl;
 	    }
@@ -1098,19 +1127,19 @@ void IQRouter::_SWHoldUpdate( )
 	    int next_vc_end = _noq_next_vc_end[input][vc];
 	    assert(next_vc_end >= 0 && next_vc_end < _vcs);
 	    _noq_next_vc_end[input][vc] = -1;
-	    f->la_route_set.Clear();
-	    f->la_route_set.AddRange(next_output_port, next_vc_start, next_vc_end);
+	    f->ClearLookaheadRouteSet();
+	    f->LookaheadRouteSet()->AddRange(next_output_port, next_vc_start, next_vc_end);
 	  } else {
 	    if(f->watch) {
-	      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 			 << "Updating lookahead routing information for flit " << f->id
 			 << "." << endl;
 	    }
 	    int in_channel = channel->GetSinkPort();
-	    _rf(router, f, in_channel, &f->la_route_set, false);
+	    _rf(router, f, in_channel, f->LookaheadRouteSet(), false);
 	  }
 	} else {
-	  f->la_route_set.Clear();
+	  f->ClearLookaheadRouteSet();
 	}
       }
 
@@ -1121,16 +1150,16 @@ void IQRouter::_SWHoldUpdate( )
 
       dest_buf->SendingFlit(f);
 
-      _crossbar_flits.push_back(make_pair(-1, make_pair(f, make_pair(expanded_input, expanded_output))));
+      _crossbar_flits.PushBack(-1, sFlitEntry(f, expanded_input, expanded_output));
       
-      if(_out_queue_credits.count(input) == 0) {
-	_out_queue_credits.insert(make_pair(input, Credit::New()));
+      if(!_out_queue_credits[input]) {
+	_out_queue_credits[input] = Credit::New();
       }
-      _out_queue_credits.find(input)->second->vc.insert(vc);
+      _out_queue_credits[input]->AddVC(vc);
       
       if(cur_buf->Empty(vc)) {
 	if(f->watch) {
-	  *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	  *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		     << "  Cancelling held connection from input " << input
 		     << "." << (expanded_input % _input_speedup)
 		     << " to " << output
@@ -1150,7 +1179,7 @@ void IQRouter::_SWHoldUpdate( )
 	if(f->tail) {
 	  assert(nf->head);
 	  if(f->watch) {
-	    *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	    *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		       << "  Cancelling held connection from input " << input
 		       << "." << (expanded_input % _input_speedup)
 		       << " to " << output
@@ -1162,32 +1191,29 @@ void IQRouter::_SWHoldUpdate( )
 	  _switch_hold_out[expanded_output] = -1;
 	  if(_routing_delay) {
 	    cur_buf->SetState(vc, VC::routing);
-	    _route_vcs.push_back(make_pair(-1, item.second.first));
+	    _route_vcs.PushBack(-1, sVCEntry(item.input, item.vc));
 	  } else {
 	    if(nf->watch) {
-	      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 			 << "Using precomputed lookahead routing information for VC " << vc
 			 << " at input " << input
 			 << " (front: " << nf->id
 			 << ")." << endl;
 	    }
-	    cur_buf->SetRouteSet(vc, &nf->la_route_set);
+	    cur_buf->SetRouteSet(vc, nf->LookaheadRouteSet());
 	    cur_buf->SetState(vc, VC::vc_alloc);
 	    if(_speculative) {
-	      _sw_alloc_vcs.push_back(make_pair(-1, make_pair(item.second.first,
-							      -1)));
+	      _sw_alloc_vcs.PushBack(-1, sVCEntry(item.input, item.vc));
 	    }
 	    if(_vc_allocator) {
-	      _vc_alloc_vcs.push_back(make_pair(-1, make_pair(item.second.first,
-							      -1)));
+	      _vc_alloc_vcs.PushBack(-1, sVCEntry(item.input, item.vc));
 	    }
 	    if(_noq) {
 	      _UpdateNOQ(input, vc, nf);
 	    }
 	  }
 	} else {
-	  _sw_hold_vcs.push_back(make_pair(-1, make_pair(item.second.first,
-							 -1)));
+	  _sw_hold_vcs.PushBack(-1, sVCEntry(item.input, item.vc));
 	}
       }
     } else {
@@ -1199,7 +1225,7 @@ void IQRouter::_SWHoldUpdate( )
       assert(held_expanded_output >= 0);
       
       if(f->watch) {
-	*gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	*gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		   << "  Cancelling held connection from input " << input
 		   << "." << (expanded_input % _input_speedup)
 		   << " to " << (held_expanded_output / _output_speedup)
@@ -1209,10 +1235,9 @@ void IQRouter::_SWHoldUpdate( )
       _switch_hold_vc[expanded_input] = -1;
       _switch_hold_in[expanded_input] = -1;
       _switch_hold_out[held_expanded_output] = -1;
-      _sw_alloc_vcs.push_back(make_pair(-1, make_pair(item.second.first,
-						      -1)));
+      _sw_alloc_vcs.PushBack(-1, sVCEntry(item.input, item.vc));
     }
-    _sw_hold_vcs.pop_front();
+    _sw_hold_vcs.PopFront();
   }
 }
 
@@ -1264,7 +1289,7 @@ bool IQRouter::_SWAllocAddReq(int input, int vc, int output)
       if(RoundRobinArbiter::Supersedes(vc, prio, req.label, req.in_pri, 
 				       _sw_rr_offset[expanded_input], _vcs)) {
 	if(f->watch) {
-	  *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	  *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		     << "  Replacing earlier request from VC " << req.label
 		     << " for output " << output 
 		     << "." << (expanded_output % _output_speedup)
@@ -1280,7 +1305,7 @@ bool IQRouter::_SWAllocAddReq(int input, int vc, int output)
 	return true;
       }
       if(f->watch) {
-	*gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	*gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		   << "  Output " << output
 		   << "." << (expanded_output % _output_speedup)
 		   << " was already requested by VC " << req.label
@@ -1291,7 +1316,7 @@ bool IQRouter::_SWAllocAddReq(int input, int vc, int output)
       return false;
     }
     if(f->watch) {
-      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		 << "  Requesting output " << output
 		 << "." << (expanded_output % _output_speedup)
 		 << " (" << ((cur_buf->GetState(vc) == VC::active) ? 
@@ -1304,22 +1329,22 @@ bool IQRouter::_SWAllocAddReq(int input, int vc, int output)
     return true;
   }
   if(f->watch) {
-    *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+    *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 	       << "  Ignoring output " << output
 	       << "." << (expanded_output % _output_speedup)
 	       << " due to switch hold (";
     if(_switch_hold_in[expanded_input] >= 0) {
-      *gWatchOut << "input: " << input
+      *gContext->watch_out << "input: " << input
 		 << "." << (expanded_input % _input_speedup);
       if(_switch_hold_out[expanded_output] >= 0) {
-	*gWatchOut << ", ";
+	*gContext->watch_out << ", ";
       }
     }
     if(_switch_hold_out[expanded_output] >= 0) {
-      *gWatchOut << "output: " << output
+      *gContext->watch_out << "output: " << output
 		 << "." << (expanded_output % _output_speedup);
     }
-    *gWatchOut << ")." << endl;
+    *gContext->watch_out << ")." << endl;
   }
   return false;
 }
@@ -1328,21 +1353,21 @@ void IQRouter::_SWAllocEvaluate( )
 {
   bool watched = false;
 
-  for(deque<pair<int, pair<pair<int, int>, int> > >::iterator iter = _sw_alloc_vcs.begin();
-      iter != _sw_alloc_vcs.end();
-      ++iter) {
+  for(int i = 0; i < _sw_alloc_vcs.Size(); ++i) {
 
-    int const time = iter->first;
+    int const time = _sw_alloc_vcs.Time(i);
     if(time >= 0) {
       break;
     }
 
-    int const input = iter->second.first.first;
+    sVCEntry & entry = _sw_alloc_vcs.Entry(i);
+
+    int const input = entry.input;
     assert((input >= 0) && (input < _inputs));
-    int const vc = iter->second.first.second;
+    int const vc = entry.vc;
     assert((vc >= 0) && (vc < _vcs));
     
-    assert(iter->second.second == -1);
+    assert(entry.outcome == -1);
 
     assert(_switch_hold_vc[input * _input_speedup + vc % _input_speedup] != vc);
 
@@ -1356,7 +1381,7 @@ void IQRouter::_SWAllocEvaluate( )
     assert(f->vc == vc);
 
     if(f->watch) {
-      *gWatchOut << GetSimTime() << " | " << FullName() << " | " 
+      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | " 
 		 << "Beginning switch allocation for VC " << vc
 		 << " at input " << input
 		 << " (front: " << f->id
@@ -1374,12 +1399,12 @@ void IQRouter::_SWAllocEvaluate( )
       
       if(dest_buf->IsFullFor(dest_vc) || ( _output_buffer_size!=-1  && _output_buffer[dest_output].size()>=(size_t)(_output_buffer_size))) {
 	if(f->watch) {
-	  *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	  *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		     << "  VC " << dest_vc 
 		     << " at output " << dest_output 
 		     << " is full." << endl;
 	}
-	iter->second.second = dest_buf->IsFull() ? STALL_BUFFER_FULL : STALL_BUFFER_RESERVED;
+	entry.outcome = dest_buf->IsFull() ? STALL_BUFFER_FULL : STALL_BUFFER_RESERVED;
 	continue;
       }
       bool const requested = _SWAllocAddReq(input, vc, dest_output);
@@ -1397,11 +1422,11 @@ void IQRouter::_SWAllocEvaluate( )
     OutputSet const * const route_set = cur_buf->GetRouteSet(vc);
     assert(route_set);
     
-    set<OutputSet::sSetElement> const setlist = route_set->GetSet();
+    OutputSet::ElementSet const & setlist = route_set->GetSet();
     
     assert(!_noq || (setlist.size() == 1));
 
-    for(set<OutputSet::sSetElement>::const_iterator iset = setlist.begin();
+    for(OutputSet::ElementSet::const_iterator iset = setlist.begin();
 	iset != setlist.end();
 	++iset) {
       
@@ -1451,18 +1476,18 @@ void IQRouter::_SWAllocEvaluate( )
       
       if(_spec_check_elig && !elig) {
 	if(f->watch) {
-	  *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	  *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		     << "  Output " << dest_output 
 		     << " has no suitable VCs available." << endl;
 	}
-	iter->second.second = STALL_BUFFER_BUSY;
+	entry.outcome = STALL_BUFFER_BUSY;
       } else if(_spec_check_cred && !cred) {
 	if(f->watch) {
-	  *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	  *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		     << "  All suitable VCs at output " << dest_output 
 		     << " are full." << endl;
 	}
-	iter->second.second = dest_buf->IsFull() ? STALL_BUFFER_FULL : STALL_BUFFER_RESERVED;
+	entry.outcome = dest_buf->IsFull() ? STALL_BUFFER_FULL : STALL_BUFFER_RESERVED;
       } else {
 	bool const requested = _SWAllocAddReq(input, vc, dest_output);
 	watched |= requested && f->watch;
@@ -1471,11 +1496,11 @@ void IQRouter::_SWAllocEvaluate( )
   }
   
   if(watched) {
-    *gWatchOut << GetSimTime() << " | " << _sw_allocator->FullName() << " | ";
-    _sw_allocator->PrintRequests(gWatchOut);
+    *gContext->watch_out << GetSimTime() << " | " << _sw_allocator->FullName() << " | ";
+    _sw_allocator->PrintRequests(gContext->watch_out);
     if(_spec_sw_allocator) {
-      *gWatchOut << GetSimTime() << " | " << _spec_sw_allocator->FullName() << " | ";
-      _spec_sw_allocator->PrintRequests(gWatchOut);
+      *gContext->watch_out << GetSimTime() << " | " << _spec_sw_allocator->FullName() << " | ";
+      _spec_sw_allocator->PrintRequests(gContext->watch_out);
     }
   }
   
@@ -1484,34 +1509,34 @@ void IQRouter::_SWAllocEvaluate( )
     _spec_sw_allocator->Allocate();
   
   if(watched) {
-    *gWatchOut << GetSimTime() << " | " << _sw_allocator->FullName() << " | ";
-    _sw_allocator->PrintGrants(gWatchOut);
+    *gContext->watch_out << GetSimTime() << " | " << _sw_allocator->FullName() << " | ";
+    _sw_allocator->PrintGrants(gContext->watch_out);
     if(_spec_sw_allocator) {
-      *gWatchOut << GetSimTime() << " | " << _spec_sw_allocator->FullName() << " | ";
-      _spec_sw_allocator->PrintGrants(gWatchOut);
+      *gContext->watch_out << GetSimTime() << " | " << _spec_sw_allocator->FullName() << " | ";
+      _spec_sw_allocator->PrintGrants(gContext->watch_out);
     }
   }
   
-  for(deque<pair<int, pair<pair<int, int>, int> > >::iterator iter = _sw_alloc_vcs.begin();
-      iter != _sw_alloc_vcs.end();
-      ++iter) {
+  for(int i = 0; i < _sw_alloc_vcs.Size(); ++i) {
 
-    int const time = iter->first;
+    int const time = _sw_alloc_vcs.Time(i);
     if(time >= 0) {
       break;
     }
-    iter->first = GetSimTime() + _sw_alloc_delay - 1;
 
-    int const input = iter->second.first.first;
+    sVCEntry & entry = _sw_alloc_vcs.Entry(i);
+    _sw_alloc_vcs.Time(i) = GetSimTime() + _sw_alloc_delay - 1;
+
+    int const input = entry.input;
     assert((input >= 0) && (input < _inputs));
-    int const vc = iter->second.first.second;
+    int const vc = entry.vc;
     assert((vc >= 0) && (vc < _vcs));
 
-    if(iter->second.second < -1) {
+    if(entry.outcome < -1) {
       continue;
     }
 
-    assert(iter->second.second == -1);
+    assert(entry.outcome == -1);
 
     Buffer const * const cur_buf = _buf[input];
     assert(!cur_buf->Empty(vc));
@@ -1531,7 +1556,7 @@ void IQRouter::_SWAllocEvaluate( )
       int const granted_vc = _sw_allocator->ReadRequest(expanded_input, expanded_output);
       if(granted_vc == vc) {
 	if(f->watch) {
-	  *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	  *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		     << "Assigning output " << (expanded_output / _output_speedup)
 		     << "." << (expanded_output % _output_speedup)
 		     << " to VC " << vc
@@ -1540,15 +1565,15 @@ void IQRouter::_SWAllocEvaluate( )
 		     << "." << endl;
 	}
 	_sw_rr_offset[expanded_input] = (vc + _input_speedup) % _vcs;
-	iter->second.second = expanded_output;
+	entry.outcome = expanded_output;
       } else {
 	if(f->watch) {
-	  *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	  *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		     << "Switch allocation failed for VC " << vc
 		     << " at input " << input
 		     << ": Granted to VC " << granted_vc << "." << endl;
 	}
-	iter->second.second = STALL_CROSSBAR_CONFLICT;
+	entry.outcome = STALL_CROSSBAR_CONFLICT;
       }
     } else if(_spec_sw_allocator) {
       expanded_output = _spec_sw_allocator->OutputAssigned(expanded_input);
@@ -1557,7 +1582,7 @@ void IQRouter::_SWAllocEvaluate( )
 	if(_spec_mask_by_reqs && 
 	   _sw_allocator->OutputHasRequests(expanded_output)) {
 	  if(f->watch) {
-	    *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	    *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		       << "Discarding speculative grant for VC " << vc
 		       << " at input " << input
 		       << "." << (vc % _input_speedup)
@@ -1565,11 +1590,11 @@ void IQRouter::_SWAllocEvaluate( )
 		       << "." << (expanded_output % _output_speedup)
 		       << " has non-speculative requests." << endl;
 	  }
-	  iter->second.second = STALL_CROSSBAR_CONFLICT;
+	  entry.outcome = STALL_CROSSBAR_CONFLICT;
 	} else if(!_spec_mask_by_reqs &&
 		  (_sw_allocator->InputAssigned(expanded_output) >= 0)) {
 	  if(f->watch) {
-	    *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	    *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		       << "Discarding speculative grant for VC " << vc
 		       << " at input " << input
 		       << "." << (vc % _input_speedup)
@@ -1577,13 +1602,13 @@ void IQRouter::_SWAllocEvaluate( )
 		       << "." << (expanded_output % _output_speedup)
 		       << " has a non-speculative grant." << endl;
 	  }
-	  iter->second.second = STALL_CROSSBAR_CONFLICT;
+	  entry.outcome = STALL_CROSSBAR_CONFLICT;
 	} else {
 	  int const granted_vc = _spec_sw_allocator->ReadRequest(expanded_input, 
 								 expanded_output);
 	  if(granted_vc == vc) {
 	    if(f->watch) {
-	      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 			 << "Assigning output " << (expanded_output / _output_speedup)
 			 << "." << (expanded_output % _output_speedup)
 			 << " to VC " << vc
@@ -1592,39 +1617,39 @@ void IQRouter::_SWAllocEvaluate( )
 			 << "." << endl;
 	    }
 	    _sw_rr_offset[expanded_input] = (vc + _input_speedup) % _vcs;
-	    iter->second.second = expanded_output;
+	    entry.outcome = expanded_output;
 	  } else {
 	    if(f->watch) {
-	      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 			 << "Switch allocation failed for VC " << vc
 			 << " at input " << input
 			 << ": Granted to VC " << granted_vc << "." << endl;
 	    }
-	    iter->second.second = STALL_CROSSBAR_CONFLICT;
+	    entry.outcome = STALL_CROSSBAR_CONFLICT;
 	  }
 	}
       } else {
 
 	if(f->watch) {
-	  *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	  *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		     << "Switch allocation failed for VC " << vc
 		     << " at input " << input
 		     << ": No output granted." << endl;
 	}
 	
-	iter->second.second = STALL_CROSSBAR_CONFLICT;
+	entry.outcome = STALL_CROSSBAR_CONFLICT;
 
       }
     } else {
       
       if(f->watch) {
-	*gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	*gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		   << "Switch allocation failed for VC " << vc
 		   << " at input " << input
 		   << ": No output granted." << endl;
       }
       
-      iter->second.second = STALL_CROSSBAR_CONFLICT;
+      entry.outcome = STALL_CROSSBAR_CONFLICT;
       
     }
   }
@@ -1633,19 +1658,19 @@ void IQRouter::_SWAllocEvaluate( )
     return;
   }
 
-  for(deque<pair<int, pair<pair<int, int>, int> > >::iterator iter = _sw_alloc_vcs.begin();
-      iter != _sw_alloc_vcs.end();
-      ++iter) {
+  for(int i = 0; i < _sw_alloc_vcs.Size(); ++i) {
 
-    int const time = iter->first;
+    int const time = _sw_alloc_vcs.Time(i);
     assert(time >= 0);
     if(GetSimTime() < time) {
       break;
     }
 
-    assert(iter->second.second != -1);
+    sVCEntry & entry = _sw_alloc_vcs.Entry(i);
+
+    assert(entry.outcome != -1);
 
-    int const expanded_output = iter->second.second;
+    int const expanded_output = entry.outcome;
     
     if(expanded_output >= 0) {
       
@@ -1654,10 +1679,10 @@ void IQRouter::_SWAllocEvaluate( )
       
       BufferState const * const dest_buf = _next_buf[output];
       
-      int const input = iter->second.first.first;
+      int const input = entry.input;
       assert((input >= 0) && (input < _inputs));
       assert((input % _output_speedup) == (expanded_output % _output_speedup));
-      int const vc = iter->second.first.second;
+      int const vc = entry.vc;
       assert((vc >= 0) && (vc < _vcs));
       
       int const expanded_input = input * _input_speedup + vc % _input_speedup;
@@ -1675,25 +1700,25 @@ void IQRouter::_SWAllocEvaluate( )
       if((_switch_hold_in[expanded_input] >= 0) ||
 	 (_switch_hold_out[expanded_output] >= 0)) {
 	if(f->watch) {
-	  *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	  *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		     << "Discarding grant from input " << input
 		     << "." << (vc % _input_speedup)
 		     << " to output " << output
 		     << "." << (expanded_output % _output_speedup)
 		     << " due to conflict with held connection at ";
 	  if(_switch_hold_in[expanded_input] >= 0) {
-	    *gWatchOut << "input";
+	    *gContext->watch_out << "input";
 	  }
 	  if((_switch_hold_in[expanded_input] >= 0) && 
 	     (_switch_hold_out[expanded_output] >= 0)) {
-	    *gWatchOut << " and ";
+	    *gContext->watch_out << " and ";
 	  }
 	  if(_switch_hold_out[expanded_output] >= 0) {
-	    *gWatchOut << "output";
+	    *gContext->watch_out << "output";
 	  }
-	  *gWatchOut << "." << endl;
+	  *gContext->watch_out << "." << endl;
 	}
-	iter->second.second = STALL_CROSSBAR_CONFLICT;
+	entry.outcome = STALL_CROSSBAR_CONFLICT;
       } else if(_speculative && (cur_buf->GetState(vc) == VC::vc_alloc)) {
 
 	assert(f->head);
@@ -1706,34 +1731,34 @@ void IQRouter::_SWAllocEvaluate( )
 
 	  if(output_and_vc < 0) {
 	    if(f->watch) {
-	      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 			 << "Discarding grant from input " << input
 			 << "." << (vc % _input_speedup)
 			 << " to output " << output
 			 << "." << (expanded_output % _output_speedup)
 			 << " due to misspeculation." << endl;
 	    }
-	    iter->second.second = -1; // stall is counted in VC allocation path!
+	    entry.outcome = -1; // stall is counted in VC allocation path!
 	  } else if((output_and_vc / _vcs) != output) {
 	    if(f->watch) {
-	      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 			 << "Discarding grant from input " << input
 			 << "." << (vc % _input_speedup)
 			 << " to output " << output
 			 << "." << (expanded_output % _output_speedup)
 			 << " due to port mismatch between VC and switch allocator." << endl;
 	    }
-	    iter->second.second = STALL_BUFFER_CONFLICT; // count this case as if we had failed allocation
+	    entry.outcome = STALL_BUFFER_CONFLICT; // count this case as if we had failed allocation
 	  } else if(dest_buf->IsFullFor((output_and_vc % _vcs))) {
 	    if(f->watch) {
-	      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 			 << "Discarding grant from input " << input
 			 << "." << (vc % _input_speedup)
 			 << " to output " << output
 			 << "." << (expanded_output % _output_speedup)
 			 << " due to lack of credit." << endl;
 	    }
-	    iter->second.second = dest_buf->IsFull() ? STALL_BUFFER_FULL : STALL_BUFFER_RESERVED;
+	    entry.outcome = dest_buf->IsFull() ? STALL_BUFFER_FULL : STALL_BUFFER_RESERVED;
 	  }
 
 	} else { // VC allocation is piggybacked onto switch allocation
@@ -1741,7 +1766,7 @@ void IQRouter::_SWAllocEvaluate( )
 	  OutputSet const * const route_set = cur_buf->GetRouteSet(vc);
 	  assert(route_set);
 
-	  set<OutputSet::sSetElement> const setlist = route_set->GetSet();
+	  OutputSet::ElementSet const & setlist = route_set->GetSet();
 
 	  bool busy = true;
 	  bool full = true;
@@ -1749,7 +1774,7 @@ void IQRouter::_SWAllocEvaluate( )
 
 	  assert(!_noq || (setlist.size() == 1));
 
-	  for(set<OutputSet::sSetElement>::const_iterator iset = setlist.begin();
+	  for(OutputSet::ElementSet::const_iterator iset = setlist.begin();
 	      iset != setlist.end();
 	      ++iset) {
 	    if(iset->output_port == output) {
@@ -1789,24 +1814,24 @@ void IQRouter::_SWAllocEvaluate( )
 
 	  if(busy) {
 	    if(f->watch) {
-	      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 			 << "Discarding grant from input " << input
 			 << "." << (vc % _input_speedup)
 			 << " to output " << output
 			 << "." << (expanded_output % _output_speedup)
 			 << " because no suitable output VC for piggyback allocation is available." << endl;
 	    }
-	    iter->second.second = STALL_BUFFER_BUSY;
+	    entry.outcome = STALL_BUFFER_BUSY;
 	  } else if(full) {
 	    if(f->watch) {
-	      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 			 << "Discarding grant from input " << input
 			 << "." << (vc % _input_speedup)
 			 << " to output " << output
 			 << "." << (expanded_output % _output_speedup)
 			 << " because all suitable output VCs for piggyback allocation are full." << endl;
 	    }
-	    iter->second.second = reserved ? STALL_BUFFER_RESERVED : STALL_BUFFER_FULL;
+	    entry.outcome = reserved ? STALL_BUFFER_RESERVED : STALL_BUFFER_FULL;
 	  }
 
 	}
@@ -1819,14 +1844,14 @@ void IQRouter::_SWAllocEvaluate( )
 
 	if(dest_buf->IsFullFor(match_vc)) {
 	  if(f->watch) {
-	    *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	    *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		       << "  Discarding grant from input " << input
 		       << "." << (vc % _input_speedup)
 		       << " to output " << output
 		       << "." << (expanded_output % _output_speedup)
 		       << " due to lack of credit." << endl;
 	  }
-	  iter->second.second = dest_buf->IsFull() ? STALL_BUFFER_FULL : STALL_BUFFER_RESERVED;
+	  entry.outcome = dest_buf->IsFull() ? STALL_BUFFER_FULL : STALL_BUFFER_RESERVED;
 	}
       }
     }
@@ -1835,19 +1860,19 @@ void IQRouter::_SWAllocEvaluate( )
 
 void IQRouter::_SWAllocUpdate( )
 {
-  while(!_sw_alloc_vcs.empty()) {
+  while(!_sw_alloc_vcs.Empty()) {
 
-    pair<int, pair<pair<int, int>, int> > const & item = _sw_alloc_vcs.front();
-
-    int const time = item.first;
+    int const time = _sw_alloc_vcs.Time(0);
     if((time < 0) || (GetSimTime() < time)) {
       break;
     }
     assert(GetSimTime() == time);
 
-    int const input = item.second.first.first;
+    sVCEntry const item = _sw_alloc_vcs.Entry(0);
+
+    int const input = item.input;
     assert((input >= 0) && (input < _inputs));
-    int const vc = item.second.first.second;
+    int const vc = item.vc;
     assert((vc >= 0) && (vc < _vcs));
     
     Buffer * const cur_buf = _buf[input];
@@ -1860,14 +1885,14 @@ void IQRouter::_SWAllocUpdate( )
     assert(f->vc == vc);
 
     if(f->watch) {
-      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		 << "Completed switch allocation for VC " << vc
 		 << " at input " << input
 		 << " (front: " << f->id
 		 << ")." << endl;
     }
     
-    int const expanded_output = item.second.second;
+    int const expanded_output = item.outcome;
     
     if(expanded_output >= 0) {
       
@@ -1896,11 +1921,11 @@ void IQRouter::_SWAllocUpdate( )
 	int match_prio = numeric_limits<int>::min();
 
 	const OutputSet * route_set = cur_buf->GetRouteSet(vc);
-	set<OutputSet::sSetElement> const setlist = route_set->GetSet();
+	OutputSet::ElementSet const & setlist = route_set->GetSet();
 	
 	assert(!_noq || (setlist.size() == 1));
 	
-	for(set<OutputSet::sSetElement>::const_iterator iset = setlist.begin();
+	for(OutputSet::ElementSet::const_iterator iset = setlist.begin();
 	    iset != setlist.end();
 	    ++iset) {
 	  if(iset->output_port == output) {
@@ -1947,7 +1972,7 @@ void IQRouter::_SWAllocUpdate( )
 	assert(match_vc >= 0);
 
 	if(f->watch) {
-	  *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	  *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		     << "  Allocating VC " << match_vc
 		     << " at output " << output
 		     << " via piggyback VC allocation." << endl;
@@ -1969,7 +1994,7 @@ void IQRouter::_SWAllocUpdate( )
       assert((match_vc >= 0) && (match_vc < _vcs));
 
       if(f->watch) {
-	*gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	*gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		   << "  Scheduling switch connection from input " << input
 		   << "." << (vc % _input_speedup)
 		   << " to output " << output
@@ -1995,7 +2020,7 @@ void IQRouter::_SWAllocUpdate( )
 	if(router) {
 	  if(_noq) {
 	    if(f->watch) {
-	      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 			 << "Updating lookahead routing information for flit " << f->id
 			 << " (NOQ)." << endl;
 	    }
@@ -2008,19 +2033,19 @@ void IQRouter::_SWAllocUpdate( )
 	    int next_vc_end = _noq_next_vc_end[input][vc];
 	    assert(next_vc_end >= 0 && next_vc_end < _vcs);
 	    _noq_next_vc_end[input][vc] = -1;
-	    f->la_route_set.Clear();
-	    f->la_route_set.AddRange(next_output_port, next_vc_start, next_vc_end);
+	    f->ClearLookaheadRouteSet();
+	    f->LookaheadRouteSet()->AddRange(next_output_port, next_vc_start, next_vc_end);
 	  } else {
 	    if(f->watch) {
-	      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 			 << "Updating lookahead routing information for flit " << f->id
 			 << "." << endl;
 	    }
 	    int in_channel = channel->GetSinkPort();
-	    _rf(router, f, in_channel, &f->la_route_set, false);
+	    _rf(router, f, in_channel, f->LookaheadRouteSet(), false);
 	  }
 	} else {
-	  f->la_route_set.Clear();
+	  f->ClearLookaheadRouteSet();
 	}
       }
 
@@ -2031,12 +2056,12 @@ void IQRouter::_SWAllocUpdate( )
 
       dest_buf->SendingFlit(f);
 
-      _crossbar_flits.push_back(make_pair(-1, make_pair(f, make_pair(expanded_input, expanded_output))));
+      _crossbar_flits.PushBack(-1, sFlitEntry(f, expanded_input, expanded_output));
 
-      if(_out_queue_credits.count(input) == 0) {
-	_out_queue_credits.insert(make_pair(input, Credit::New()));
+      if(!_out_queue_credits[input]) {
+	_out_queue_credits[input] = Credit::New();
       }
-      _out_queue_credits.find(input)->second->vc.insert(vc);
+      _out_queue_credits[input]->AddVC(vc);
 
       if(cur_buf->Empty(vc)) {
 	if(f->tail) {
@@ -2050,24 +2075,22 @@ void IQRouter::_SWAllocUpdate( )
 	  assert(nf->head);
 	  if(_routing_delay) {
 	    cur_buf->SetState(vc, VC::routing);
-	    _route_vcs.push_back(make_pair(-1, item.second.first));
+	    _route_vcs.PushBack(-1, sVCEntry(item.input, item.vc));
 	  } else {
 	    if(nf->watch) {
-	      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 			 << "Using precomputed lookahead routing information for VC " << vc
 			 << " at input " << input
 			 << " (front: " << nf->id
 			 << ")." << endl;
 	    }
-	    cur_buf->SetRouteSet(vc, &nf->la_route_set);
+	    cur_buf->SetRouteSet(vc, nf->LookaheadRouteSet());
 	    cur_buf->SetState(vc, VC::vc_alloc);
 	    if(_speculative) {
-	      _sw_alloc_vcs.push_back(make_pair(-1, make_pair(item.second.first,
-							      -1)));
+	      _sw_alloc_vcs.PushBack(-1, sVCEntry(item.input, item.vc));
 	    }
 	    if(_vc_allocator) {
-	      _vc_alloc_vcs.push_back(make_pair(-1, make_pair(item.second.first,
-							      -1)));
+	      _vc_alloc_vcs.PushBack(-1, sVCEntry(item.input, item.vc));
 	    }
 	    if(_noq) {
 	      _UpdateNOQ(input, vc, nf);
@@ -2076,7 +2099,7 @@ void IQRouter::_SWAllocUpdate( )
 	} else {
 	  if(_hold_switch_for_packet) {
 	    if(f->watch) {
-	      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 			 << "Setting up switch hold for VC " << vc
 			 << " at input " << input
 			 << "." << (expanded_input % _input_speedup)
@@ -2087,17 +2110,15 @@ void IQRouter::_SWAllocUpdate( )
 	    _switch_hold_vc[expanded_input] = vc;
 	    _switch_hold_in[expanded_input] = expanded_output;
 	    _switch_hold_out[expanded_output] = expanded_input;
-	    _sw_hold_vcs.push_back(make_pair(-1, make_pair(item.second.first,
-							   -1)));
+	    _sw_hold_vcs.PushBack(-1, sVCEntry(item.input, item.vc));
 	  } else {
-	    _sw_alloc_vcs.push_back(make_pair(-1, make_pair(item.second.first,
-							    -1)));
+	    _sw_alloc_vcs.PushBack(-1, sVCEntry(item.input, item.vc));
 	  }
 	}
       }
     } else {
       if(f->watch) {
-	*gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	*gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		   << "  No output port allocated." << endl;
       }
 
@@ -2121,9 +2142,9 @@ void IQRouter::_SWAllocUpdate( )
       }
 #endif
 
-      _sw_alloc_vcs.push_back(make_pair(-1, make_pair(item.second.first, -1)));
+      _sw_alloc_vcs.PushBack(-1, sVCEntry(item.input, item.vc));
     }
-    _sw_alloc_vcs.pop_front();
+    _sw_alloc_vcs.PopFront();
   }
 }
 
@@ -2134,24 +2155,24 @@ void IQRouter::_SWAllocUpdate( )
 
 void IQRouter::_SwitchEvaluate( )
 {
-  for(deque<pair<int, pair<Flit *, pair<int, int> > > >::iterator iter = _crossbar_flits.begin();
-      iter != _crossbar_flits.end();
-      ++iter) {
-    
-    int const time = iter->first;
+  for(int i = 0; i < _crossbar_flits.Size(); ++i) {
+
+    int const time = _crossbar_flits.Time(i);
     if(time >= 0) {
       break;
     }
-    iter->first = GetSimTime() + _crossbar_delay - 1;
 
-    Flit const * const f = iter->second.first;
+    sFlitEntry & entry = _crossbar_flits.Entry(i);
+    _crossbar_flits.Time(i) = GetSimTime() + _crossbar_delay - 1;
+
+    Flit const * const f = entry.f;
     assert(f);
 
-    int const expanded_input = iter->second.second.first;
-    int const expanded_output = iter->second.second.second;
+    int const expanded_input = entry.input;
+    int const expanded_output = entry.output;
       
     if(f->watch) {
-      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		 << "Beginning crossbar traversal for flit " << f->id
 		 << " from input " << (expanded_input / _input_speedup)
 		 << "." << (expanded_input % _input_speedup)
@@ -2164,28 +2185,28 @@ void IQRouter::_SwitchEvaluate( )
 
 void IQRouter::_SwitchUpdate( )
 {
-  while(!_crossbar_flits.empty()) {
+  while(!_crossbar_flits.Empty()) {
 
-    pair<int, pair<Flit *, pair<int, int> > > const & item = _crossbar_flits.front();
-
-    int const time = item.first;
+    int const time = _crossbar_flits.Time(0);
     if((time < 0) || (GetSimTime() < time)) {
       break;
     }
     assert(GetSimTime() == time);
 
-    Flit * const f = item.second.first;
+    sFlitEntry const item = _crossbar_flits.Entry(0);
+
+    Flit * const f = item.f;
     assert(f);
 
-    int const expanded_input = item.second.second.first;
+    int const expanded_input = item.input;
     int const input = expanded_input / _input_speedup;
     assert((input >= 0) && (input < _inputs));
-    int const expanded_output = item.second.second.second;
+    int const expanded_output = item.output;
     int const output = expanded_output / _output_speedup;
     assert((output >= 0) && (output < _outputs));
 
     if(f->watch) {
-      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		 << "Completed crossbar traversal for flit " << f->id
 		 << " from input " << input
 		 << "." << (expanded_input % _input_speedup)
@@ -2196,7 +2217,7 @@ void IQRouter::_SwitchUpdate( )
     _switchMonitor->traversal(input, output, f) ;
 
     if(f->watch) {
-      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		 << "Buffering flit " << f->id
 		 << " at output " << output
 		 << "." << endl;
@@ -2205,7 +2226,7 @@ void IQRouter::_SwitchUpdate( )
     //the output buffer size isn't precise due to flits in flight
     //but there is a maximum bound based on output speed up and ST traversal
     assert(_output_buffer[output].size()<=(size_t)_output_buffer_size+ _crossbar_delay* _output_speedup+( _output_speedup-1) ||_output_buffer_size==-1);
-    _crossbar_flits.pop_front();
+    _crossbar_flits.PopFront();
   }
 }
 
@@ -2216,20 +2237,17 @@ void IQRouter::_SwitchUpdate( )
 
 void IQRouter::_OutputQueuing( )
 {
-  for(map<int, Credit *>::const_iterator iter = _out_queue_credits.begin();
-      iter != _out_queue_credits.end();
-      ++iter) {
+  for(int input = 0; input < _inputs; ++input) {
 
-    int const input = iter->first;
-    assert((input >= 0) && (input < _inputs));
-
-    Credit * const c = iter->second;
-    assert(c);
-    assert(!c->vc.empty());
+    Credit * const c = _out_queue_credits[input];
+    if(!c) {
+      continue;
+    }
+    assert(!c->NoVCs());
 
     _credit_buffer[input].push(c);
+    _out_queue_credits[input] = NULL;
   }
-  _out_queue_credits.clear();
 }
 
 //------------------------------------------------------------------------------
@@ -2249,11 +2267,11 @@ void IQRouter::_SendFlits( )
 #endif
 
       if(f->watch)
-	*gWatchOut << GetSimTime() << " | " << FullName() << " | "
+	*gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		    << "Sending flit " << f->id
 		    << " to channel at output " << output
 		    << "." << endl;
-      if(gTrace) {
+      if(gContext->trace) {
 	cout << "Outport " << output << endl << "Stop Mark" << endl;
       }
       _output_channels[output]->Send( f );
@@ -2278,6 +2296,79 @@ void IQRouter::_SendCredits( )
 // misc.
 //------------------------------------------------------------------------------
 
+void IQRouter::sVCEntry::SyncState( Checkpoint & cp )
+{
+  cp.Sync(input);
+  cp.Sync(vc);
+  cp.Sync(outcome);
+}
+
+void IQRouter::sFlitEntry::SyncState( Checkpoint & cp )
+{
+  cp.Sync(f);
+  cp.Sync(input);
+  cp.Sync(output);
+}
+
+void IQRouter::sCreditEntry::SyncState( Checkpoint & cp )
+{
+  cp.Sync(c);
+  cp.Sync(output);
+}
+
+void IQRouter::SyncState( Checkpoint & cp )
+{
+  Router::SyncState(cp);
+
+  cp.Sync(_active);
+
+  cp.Sync(_in_queue_flits);
+  cp.Sync(_proc_credits);
+  cp.Sync(_route_vcs);
+  cp.Sync(_vc_alloc_vcs);
+  cp.Sync(_sw_hold_vcs);
+  cp.Sync(_sw_alloc_vcs);
+  cp.Sync(_crossbar_flits);
+  cp.Sync(_out_queue_credits);
+
+  for(int i = 0; i < _inputs; ++i) {
+    _buf[i]->SyncState(cp);
+  }
+  for(int j = 0; j < _outputs; ++j) {
+    _next_buf[j]->SyncState(cp);
+  }
+
+  cp.Check(_vc_allocator ? 1 : 0, "VC allocator present");
+  if(_vc_allocator) {
+    _vc_allocator->SyncState(cp);
+  }
+  _sw_allocator->SyncState(cp);
+  cp.Check(_spec_sw_allocator ? 1 : 0, "speculative switch allocator present");
+  if(_spec_sw_allocator) {
+    _spec_sw_allocator->SyncState(cp);
+  }
+  cp.Sync(_vc_rr_offset);
+  cp.Sync(_sw_rr_offset);
+
+  cp.Sync(_output_buffer);
+  cp.Sync(_credit_buffer);
+
+  cp.Sync(_switch_hold_in);
+  cp.Sync(_switch_hold_out);
+  cp.Sync(_switch_hold_vc);
+
+  cp.Sync(_noq_next_output_port);
+  cp.Sync(_noq_next_vc_start);
+  cp.Sync(_noq_next_vc_end);
+
+#ifdef TRACK_FLOWS
+  cp.Sync(_outstanding_classes);
+#endif
+
+  _bufferMonitor->SyncState(cp);
+  _switchMonitor->SyncState(cp);
+}
+
 void IQRouter::Display( ostream & os ) const
 {
   for ( int input = 0; input < _inputs; ++input ) {
@@ -2350,7 +2441,7 @@ void IQRouter::_UpdateNOQ(int input, int vc, Flit const * f) {
   assert(f);
   assert(f->vc == vc);
   assert(f->head);
-  set<OutputSet::sSetElement> sl = f->la_route_set.GetSet();
+  OutputSet::ElementSet const & sl = f->LookaheadRouteSet()->GetSet();
   assert(sl.size() == 1);
   int out_port = sl.begin()->output_port;
   const FlitChannel * channel = _output_channels[out_port];
@@ -2359,9 +2450,9 @@ void IQRouter::_UpdateNOQ(int input, int vc, Flit const * f) {
     int in_channel = channel->GetSinkPort();
     OutputSet nos;
     _rf(router, f, in_channel, &nos, false);
-    sl = nos.GetSet();
-    assert(sl.size() == 1);
-    OutputSet::sSetElement const & se = *sl.begin();
+    OutputSet::ElementSet const & nsl = nos.GetSet();
+    assert(nsl.size() == 1);
+    OutputSet::sSetElement const & se = *nsl.begin();
     int next_output_port = se.output_port;
     assert(next_output_port >= 0);
     assert(_noq_next_output_port[input][vc] < 0);
@@ -2377,7 +2468,7 @@ void IQRouter::_UpdateNOQ(int input, int vc, Flit const * f) {
     _noq_next_vc_end[input][vc] = next_vc_end;
     assert(next_vc_start <= next_vc_end);
     if(f->watch) {
-      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+      *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
 		 << "Computing lookahead routing information for flit " << f->id
 		 << " (NOQ)." << endl;
     }
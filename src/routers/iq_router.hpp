@@ -29,13 +29,12 @@
 #define _IQ_ROUTER_HPP_
 
 #include <string>
-#include <deque>
 #include <queue>
 #include <set>
-#include <map>
 
 #include "router.hpp"
 #include "routefunc.hpp"
+#include "pipeline_stage.hpp"
 
 using namespace std;
 
@@ -67,18 +66,48 @@ class IQRouter : public Router {
   int _vc_alloc_delay;
   int _sw_alloc_delay;
   
-  map<int, Flit *> _in_queue_flits;
-
-  deque<pair<int, pair<Credit *, int> > > _proc_credits;
-
-  deque<pair<int, pair<int, int> > > _route_vcs;
-  deque<pair<int, pair<pair<int, int>, int> > > _vc_alloc_vcs;  
-  deque<pair<int, pair<pair<int, int>, int> > > _sw_hold_vcs;
-  deque<pair<int, pair<pair<int, int>, int> > > _sw_alloc_vcs;
-
-  deque<pair<int, pair<Flit *, pair<int, int> > > > _crossbar_flits;
-
-  map<int, Credit *> _out_queue_credits;
+  // an input VC waiting in a pipeline stage; outcome is -1 until the 
+  // stage's allocation is evaluated, then the grant or a STALL_* code
+  struct sVCEntry {
+    int input;
+    int vc;
+    int outcome;
+    sVCEntry( int i = -1, int v = -1, int o = -1 )
+      : input( i ), vc( v ), outcome( o ) {}
+    void SyncState( Checkpoint & cp );
+  };
+
+  // a flit received at an input, or crossing the (expanded) crossbar
+  struct sFlitEntry {
+    Flit * f;
+    int input;
+    int output;
+    sFlitEntry( Flit * fl = 0, int i = -1, int o = -1 )
+      : f( fl ), input( i ), output( o ) {}
+    void SyncState( Checkpoint & cp );
+  };
+
+  // a credit received at an output
+  struct sCreditEntry {
+    Credit * c;
+    int output;
+    sCreditEntry( Credit * cr = 0, int o = -1 )
+      : c( cr ), output( o ) {}
+    void SyncState( Checkpoint & cp );
+  };
+
+  PipelineStage<sFlitEntry> _in_queue_flits;
+
+  PipelineStage<sCreditEntry> _proc_credits;
+
+  PipelineStage<sVCEntry> _route_vcs;
+  PipelineStage<sVCEntry> _vc_alloc_vcs;  
+  PipelineStage<sVCEntry> _sw_hold_vcs;
+  PipelineStage<sVCEntry> _sw_alloc_vcs;
+
+  PipelineStage<sFlitEntry> _crossbar_flits;
+
+  vector<Credit *> _out_queue_credits;
 
   vector<Buffer *> _buf;
   vector<BufferState *> _next_buf;
@@ -160,6 +189,10 @@ public:
 
   virtual void ReadInputs( );
   virtual void WriteOutputs( );
+
+  virtual void SyncState( Checkpoint & cp );
+
+  virtual bool Idle( ) const;
   
   void Display( ostream & os = cout ) const;
 
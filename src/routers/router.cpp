@@ -42,6 +42,7 @@
 #include <iostream>
 #include <cassert>
 #include "router.hpp"
+#include "checkpoint.hpp"
 
 //////////////////Sub router types//////////////////////
 #include "iq_router.hpp"
@@ -92,6 +93,7 @@ void Router::AddInputChannel( FlitChannel *channel, CreditChannel *backchannel )
   _input_channels.push_back( channel );
   _input_credits.push_back( backchannel );
   channel->SetSink( this, _input_channels.size() - 1 ) ;
+  channel->SetSinkModule( this );
 }
 
 void Router::AddOutputChannel( FlitChannel *channel, CreditChannel *backchannel )
@@ -100,6 +102,7 @@ void Router::AddOutputChannel( FlitChannel *channel, CreditChannel *backchannel
   _output_credits.push_back( backchannel );
   _channel_faults.push_back( false );
   channel->SetSource( this, _output_channels.size() - 1 ) ;
+  backchannel->SetSinkModule( this );
 }
 
 void Router::Evaluate( )
@@ -125,6 +128,27 @@ bool Router::IsFaultyOutput( int c ) const
   return _channel_faults[c];
 }
 
+void Router::SyncState( Checkpoint & cp )
+{
+  cp.Check( _inputs, "number of inputs of " + FullName( ) );
+  cp.Check( _outputs, "number of outputs of " + FullName( ) );
+  cp.Sync( _partial_internal_cycles );
+#ifdef TRACK_FLOWS
+  cp.Sync( _received_flits );
+  cp.Sync( _stored_flits );
+  cp.Sync( _sent_flits );
+  cp.Sync( _outstanding_credits );
+  cp.Sync( _active_packets );
+#endif
+#ifdef TRACK_STALLS
+  cp.Sync( _buffer_busy_stalls );
+  cp.Sync( _buffer_conflict_stalls );
+  cp.Sync( _buffer_full_stalls );
+  cp.Sync( _buffer_reserved_stalls );
+  cp.Sync( _crossbar_conflict_stalls );
+#endif
+}
+
 /*Router constructor*/
 Router *Router::NewRouter( const Configuration& config,
 			   Module *parent, const string & name, int id,
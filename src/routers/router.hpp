@@ -118,6 +118,9 @@ public:
   void OutChannelFault( int c, bool fault = true );
   bool IsFaultyOutput( int c ) const;
 
+  // Save or restore the router's state for a checkpoint
+  virtual void SyncState( Checkpoint & cp );
+
   inline int GetID( ) const {return _id;}
 
 
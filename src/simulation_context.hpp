@@ -0,0 +1,122 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2015, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _SIMULATION_CONTEXT_HPP_
+#define _SIMULATION_CONTEXT_HPP_
+
+#include <map>
+#include <string>
+#include <iostream>
+
+#include "flit.hpp"
+#include "credit.hpp"
+#include "packet_reply_info.hpp"
+
+class Router;
+class OutputSet;
+class TrafficManager;
+class AnyNet;
+
+typedef void (*tRoutingFunction)( const Router *, const Flit *, int in_channel, OutputSet *, bool );
+
+// ----------------------------------------------------------------------
+//
+//  SimulationContext: state that used to be kept in process-wide globals
+//  and static members (topology parameters read by the routing functions,
+//  the routing function registry, trace and watch settings, and the flit,
+//  credit and reply pools). Each simulation owns a context and binds it
+//  to the thread that runs it, so several simulations can run side by
+//  side in one process; worker threads of the parallel cycle engine
+//  inherit the context of the thread that creates them.
+//
+// ----------------------------------------------------------------------
+
+class SimulationContext {
+
+public:
+
+  SimulationContext( );
+  ~SimulationContext( );
+
+  TrafficManager * traffic_manager;
+
+  // console output of the simulation (standard output by default)
+  ostream * out;
+
+  bool print_activity;
+  bool trace;
+  ostream * watch_out;
+
+  // radix, dimension, concentration and number of terminals of the 
+  // network under simulation
+  int k;
+  int n;
+  int c;
+  int nodes;
+
+  map<string, tRoutingFunction> routing_function_map;
+
+  int num_vcs;
+  int read_req_begin_vc, read_req_end_vc;
+  int write_req_begin_vc, write_req_end_vc;
+  int read_reply_begin_vc, read_reply_end_vc;
+  int write_reply_begin_vc, write_reply_end_vc;
+
+  // topology-specific parameters used by routing functions
+  int dragonfly_p, dragonfly_a, dragonfly_g;
+  int dragonfly_rel_p, dragonfly_rel_a, dragonfly_rel_g;
+  int flatfly_xcount, flatfly_ycount, flatfly_xrouter, flatfly_yrouter;
+  int cmesh_cx, cmesh_cy;
+  int cmesh_node_shift_x, cmesh_node_shift_y, cmesh_port_shift_y;
+  AnyNet const * anynet;
+
+  Flit::Pool flit_pool;
+  Credit::Pool credit_pool;
+  PacketReplyInfo::Pool reply_pool;
+
+private:
+  SimulationContext( SimulationContext const & );
+  SimulationContext & operator=( SimulationContext const & );
+};
+
+// context of the simulation running on the calling thread
+extern __thread SimulationContext * gContext;
+
+// Binds a context to the calling thread for the lifetime of the object.
+class SimulationContextScope {
+  SimulationContext * _prev;
+public:
+  explicit SimulationContextScope( SimulationContext * context )
+    : _prev( gContext ) {
+    gContext = context;
+  }
+  ~SimulationContextScope( ) {
+    gContext = _prev;
+  }
+};
+
+#endif
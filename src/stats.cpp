@@ -39,8 +39,36 @@
 #include <limits>
 #include <cmath>
 #include <cstdio>
+#include <cassert>
 
 #include "stats.hpp"
+#include "checkpoint.hpp"
+
+// HDR histogram: values up to 2 * HDR_SUB are counted exactly; larger 
+// values share a bucket with those that agree in their HDR_BITS bits 
+// below the most significant one, for a relative error below 1/HDR_SUB
+static int const HDR_BITS = 7;
+static int const HDR_SUB = 1 << HDR_BITS;
+
+static inline int HdrIndex( unsigned long long v )
+{
+  if ( v < (unsigned long long)( 2 * HDR_SUB ) ) {
+    return (int)v;
+  }
+  int const shift = 63 - __builtin_clzll( v ) - HDR_BITS;
+  return ( shift + 1 ) * HDR_SUB + (int)( v >> shift ) - HDR_SUB;
+}
+
+// largest value counted in a bucket
+static inline double HdrValue( int i )
+{
+  if ( i < 2 * HDR_SUB ) {
+    return (double)i;
+  }
+  int const shift = i / HDR_SUB - 1;
+  unsigned long long const sub = i % HDR_SUB + HDR_SUB;
+  return (double)( ( ( sub + 1 ) << shift ) - 1 );
+}
 
 Stats::Stats( Module *parent, const string &name,
 	      double bin_size, int num_bins ) :
@@ -56,6 +84,7 @@ void Stats::Clear( )
   _sample_squared_sum = 0.0;
 
   _hist.assign(_num_bins, 0);
+  _hdr.clear();
 
   _min = numeric_limits<double>::quiet_NaN();
   _max = -numeric_limits<double>::quiet_NaN();
@@ -63,6 +92,18 @@ void Stats::Clear( )
   //  _reset = true;
 }
 
+void Stats::SyncState( Checkpoint & cp )
+{
+  cp.Check( _num_bins, "number of histogram bins of " + FullName( ) );
+  cp.Sync( _num_samples );
+  cp.Sync( _sample_sum );
+  cp.Sync( _sample_squared_sum );
+  cp.Sync( _min );
+  cp.Sync( _max );
+  cp.Sync( _hist );
+  cp.Sync( _hdr );
+}
+
 double Stats::Average( ) const
 {
   return _sample_sum / (double)_num_samples;
@@ -112,6 +153,96 @@ void Stats::AddSample( double val )
   b = (b >= _num_bins) ? (_num_bins - 1) : b;
 
   _hist[b]++;
+
+  if ( val == val ) {
+    double const v = floor( fmax( val, 0.0 ) );
+    int const h = HdrIndex( ( v < 9.0e18 ) ? (unsigned long long)v : 9000000000000000000ULL );
+    if ( h >= (int)_hdr.size( ) ) {
+      _hdr.resize( h + 1, 0 );
+    }
+    _hdr[h]++;
+  }
+}
+
+double Stats::Percentile( double p ) const
+{
+  int total = 0;
+  for ( size_t i = 0; i < _hdr.size( ); ++i ) {
+    total += _hdr[i];
+  }
+  if ( total == 0 ) {
+    return numeric_limits<double>::quiet_NaN();
+  }
+
+  int rank = (int)ceil( p / 100.0 * (double)total );
+  rank = ( rank < 1 ) ? 1 : ( ( rank > total ) ? total : rank );
+
+  int count = 0;
+  for ( size_t i = 0; i < _hdr.size( ); ++i ) {
+    count += _hdr[i];
+    if ( count >= rank ) {
+      // the bucket bound may lie beyond the actual samples
+      return fmax( fmin( HdrValue( i ), _max ), _min );
+    }
+  }
+  return _max;
+}
+
+void Stats::Merge( Stats const & s )
+{
+  assert( _num_bins == s._num_bins );
+
+  if ( s._num_samples == 0 ) {
+    return;
+  }
+
+  _num_samples += s._num_samples;
+  _sample_sum += s._sample_sum;
+  _sample_squared_sum += s._sample_squared_sum;
+
+  _max = !( s._max <= _max ) ? s._max : _max;
+  _min = !( s._min >= _min ) ? s._min : _min;
+
+  for ( int b = 0; b < _num_bins; ++b ) {
+    _hist[b] += s._hist[b];
+  }
+  if ( s._hdr.size( ) > _hdr.size( ) ) {
+    _hdr.resize( s._hdr.size( ), 0 );
+  }
+  for ( size_t i = 0; i < s._hdr.size( ); ++i ) {
+    _hdr[i] += s._hdr[i];
+  }
+}
+
+void Stats::Pack( vector<double> & v ) const
+{
+  v.clear( );
+  v.push_back( _num_samples );
+  v.push_back( _sample_sum );
+  v.push_back( _sample_squared_sum );
+  v.push_back( _min );
+  v.push_back( _max );
+  v.insert( v.end( ), _hist.begin( ), _hist.end( ) );
+  v.insert( v.end( ), _hdr.begin( ), _hdr.end( ) );
+}
+
+void Stats::MergePacked( vector<double> const & v )
+{
+  assert( (int)v.size( ) >= 5 + _num_bins );
+
+  Stats s( NULL, "", _bin_size, _num_bins );
+  s._num_samples = (int)v[0];
+  s._sample_sum = v[1];
+  s._sample_squared_sum = v[2];
+  s._min = v[3];
+  s._max = v[4];
+  for ( int b = 0; b < _num_bins; ++b ) {
+    s._hist[b] = (int)v[5 + b];
+  }
+  for ( size_t i = 5 + _num_bins; i < v.size( ); ++i ) {
+    s._hdr.push_back( (int)v[i] );
+  }
+  Merge( s );
 }
 
 void Stats::Display( ostream & os ) const
@@ -30,6 +30,8 @@
 
 #include "module.hpp"
 
+class Checkpoint;
+
 class Stats : public Module {
   int    _num_samples;
   double _sample_sum;
@@ -44,6 +46,10 @@ class Stats : public Module {
 
   vector<int> _hist;
 
+  // log-linear (HDR) histogram: exact below 2^(HDR_BITS+1), above that 
+  // buckets are 2^-HDR_BITS wide relative to their values; grows as needed
+  vector<int> _hdr;
+
 public:
   Stats( Module *parent, const string &name,
 	 double bin_size = 1.0, int num_bins = 10 );
@@ -65,6 +71,20 @@ public:
 
   int GetBin(int b){ return _hist[b];}
 
+  // value below which the given percentage of the samples falls, to 
+  // within the resolution of the HDR histogram
+  double Percentile( double p ) const;
+
+  // add the samples of another Stats object to this one
+  void Merge( Stats const & s );
+
+  // flatten the samples into a sequence of numbers, and add samples 
+  // flattened by another Stats object (e.g. in a forked simulation)
+  void Pack( vector<double> & v ) const;
+  void MergePacked( vector<double> const & v );
+
+  void SyncState( Checkpoint & cp );
+
   void Display( ostream & os = cout ) const;
 
   friend ostream & operator<<(ostream & os, const Stats & s);
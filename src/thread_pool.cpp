@@ -0,0 +1,158 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2015, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "booksim.hpp"
+#include "thread_pool.hpp"
+#include "simulation_context.hpp"
+
+#include <iostream>
+#include <sched.h>
+
+// number of polls before a waiting thread starts yielding its core
+#define THREAD_POOL_SPIN 4096
+
+ThreadPool::ThreadPool( int threads, bool blocking )
+  : _threads(threads), _blocking(blocking), _context(gContext), _task(NULL), 
+    _arg(NULL), _generation(0), _pending(0), _shutdown(false)
+{
+  assert(threads >= 1);
+  pthread_mutex_init( &_lock, NULL );
+  pthread_cond_init( &_start, NULL );
+  pthread_cond_init( &_done, NULL );
+  _handles.resize(threads - 1);
+  _workers.resize(threads - 1);
+  for ( int t = 1; t < threads; ++t ) {
+    sWorker & w = _workers[t-1];
+    w.pool = this;
+    w.id = t;
+    if ( pthread_create( &_handles[t-1], NULL, &ThreadPool::_WorkerMain, &w ) ) {
+      cerr << "Unable to create worker thread " << t << endl;
+      exit(-1);
+    }
+  }
+}
+
+ThreadPool::~ThreadPool( )
+{
+  pthread_mutex_lock( &_lock );
+  _shutdown = true;
+  __sync_fetch_and_add( &_generation, 1 );
+  pthread_cond_broadcast( &_start );
+  pthread_mutex_unlock( &_lock );
+  for ( size_t t = 0; t < _handles.size( ); ++t ) {
+    pthread_join( _handles[t], NULL );
+  }
+  pthread_cond_destroy( &_done );
+  pthread_cond_destroy( &_start );
+  pthread_mutex_destroy( &_lock );
+}
+
+void ThreadPool::Run( tTask task, void * arg )
+{
+  if ( _blocking ) {
+    pthread_mutex_lock( &_lock );
+    _task = task;
+    _arg = arg;
+    _pending = _threads - 1;
+    ++_generation;
+    pthread_cond_broadcast( &_start );
+    pthread_mutex_unlock( &_lock );
+
+    task( arg, 0 );
+
+    pthread_mutex_lock( &_lock );
+    while ( _pending > 0 ) {
+      pthread_cond_wait( &_done, &_lock );
+    }
+    pthread_mutex_unlock( &_lock );
+    return;
+  }
+
+  _task = task;
+  _arg = arg;
+  _pending = _threads - 1;
+  // full barrier: publishes task, argument and counter before release
+  __sync_fetch_and_add( &_generation, 1 );
+
+  task( arg, 0 );
+
+  int spins = 0;
+  while ( _pending > 0 ) {
+    if ( ++spins > THREAD_POOL_SPIN ) {
+      sched_yield( );
+    }
+  }
+  __sync_synchronize( );
+}
+
+void * ThreadPool::_WorkerMain( void * worker )
+{
+  sWorker * const w = static_cast<sWorker *>( worker );
+  gContext = w->pool->_context;
+  w->pool->_Work( w->id );
+  return NULL;
+}
+
+void ThreadPool::_Work( int id )
+{
+  int seen = 0;
+  if ( _blocking ) {
+    pthread_mutex_lock( &_lock );
+    while ( true ) {
+      while ( _generation == seen ) {
+	pthread_cond_wait( &_start, &_lock );
+      }
+      seen = _generation;
+      if ( _shutdown ) {
+	break;
+      }
+      pthread_mutex_unlock( &_lock );
+      _task( _arg, id );
+      pthread_mutex_lock( &_lock );
+      if ( --_pending == 0 ) {
+	pthread_cond_signal( &_done );
+      }
+    }
+    pthread_mutex_unlock( &_lock );
+    return;
+  }
+  while ( true ) {
+    int spins = 0;
+    while ( _generation == seen ) {
+      if ( ++spins > THREAD_POOL_SPIN ) {
+	sched_yield( );
+      }
+    }
+    __sync_synchronize( );
+    seen = _generation;
+    if ( _shutdown ) {
+      return;
+    }
+    _task( _arg, id );
+    __sync_fetch_and_sub( &_pending, 1 );
+  }
+}
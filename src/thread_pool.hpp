@@ -0,0 +1,95 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2015, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _THREAD_POOL_HPP_
+#define _THREAD_POOL_HPP_
+
+#include <vector>
+#include <pthread.h>
+
+class SimulationContext;
+
+using namespace std;
+
+// ----------------------------------------------------------------------
+//
+//  ThreadPool: fixed set of worker threads that execute one task at a
+//  time in lock step with the calling thread. Run() hands the task to
+//  every worker, executes slice 0 itself and returns once all slices
+//  are done, so each call acts as a barrier. By default workers spin
+//  (and then yield) between calls, as the network issues several short
+//  phases per simulated cycle; a blocking pool, meant for long tasks,
+//  has idle workers and the caller sleep on condition variables
+//  instead. Workers run in the simulation context of the thread that
+//  created the pool.
+//
+// ----------------------------------------------------------------------
+
+class ThreadPool {
+
+public:
+  typedef void (*tTask)( void * arg, int thread );
+
+  ThreadPool( int threads, bool blocking = false );
+  ~ThreadPool( );
+
+  inline int NumThreads( ) const {
+    return _threads;
+  }
+
+  void Run( tTask task, void * arg );
+
+private:
+  struct sWorker {
+    ThreadPool * pool;
+    int id;
+  };
+
+  int _threads;
+  bool _blocking;
+  SimulationContext * _context;
+
+  vector<pthread_t> _handles;
+  vector<sWorker> _workers;
+
+  tTask _task;
+  void * _arg;
+
+  volatile int _generation;
+  volatile int _pending;
+  volatile bool _shutdown;
+
+  // blocking mode only
+  pthread_mutex_t _lock;
+  pthread_cond_t _start;
+  pthread_cond_t _done;
+
+  static void * _WorkerMain( void * worker );
+  void _Work( int id );
+};
+
+#endif
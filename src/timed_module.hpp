@@ -28,17 +28,138 @@
 #ifndef _TIMED_MODULE_HPP_
 #define _TIMED_MODULE_HPP_
 
+#include <vector>
+#include <deque>
+
 #include "module.hpp"
+#include "random_utils.hpp"
+
+class ActiveSet;
 
 class TimedModule : public Module {
 
+  ActiveSet * _active_set;
+  int _active_index;
+
+  RandomStream * _random_stream;
+
 public:
-  TimedModule(Module * parent, string const & name) : Module(parent, name) {}
+  TimedModule(Module * parent, string const & name) 
+    : Module(parent, name), _active_set(NULL), _active_index(-1), 
+      _random_stream(NULL) {}
   virtual ~TimedModule() {}
   
   virtual void ReadInputs() = 0;
   virtual void Evaluate() = 0;
   virtual void WriteOutputs() = 0;
+
+  // True if stepping the module is a no-op until new input arrives; modules
+  // that cannot tell stay scheduled every cycle.
+  virtual bool Idle() const { return false; }
+
+  // Put the module back on its network's active set (if any).
+  inline void Wake();
+
+  // Random draws made while the module is stepped come from this stream 
+  // rather than the global generator, if set.
+  inline void SetRandomStream(RandomStream * s) { _random_stream = s; }
+
+  // Run one phase of the module with its random stream selected.
+  inline void Step(void (TimedModule::*phase)()) {
+    if(_random_stream) {
+      RandomStreamScope scope(_random_stream);
+      (this->*phase)();
+    } else {
+      (this->*phase)();
+    }
+  }
+
+  friend class ActiveSet;
+};
+
+// ----------------------------------------------------------------------
+//
+//  ActiveSet: bitmap of the timed modules that need to be stepped. Modules
+//  are visited in registration order, so stepping only the active ones is
+//  indistinguishable from stepping all of them. A module woken during a
+//  cycle stays active at least through the end of the following cycle;
+//  afterwards it is dropped as soon as it reports Idle().
+//
+// ----------------------------------------------------------------------
+
+class ActiveSet {
+
+  vector<TimedModule *> _modules;
+  vector<unsigned long long> _active;
+  vector<unsigned long long> _woken;
+
+public:
+
+  void Init(deque<TimedModule *> const & modules) {
+    _modules.assign(modules.begin(), modules.end());
+    size_t const words = (_modules.size() + 63) / 64;
+    _active.assign(words, ~0ULL);
+    _woken.assign(words, 0ULL);
+    if(_modules.size() % 64) {
+      _active.back() = (1ULL << (_modules.size() % 64)) - 1;
+    }
+    for(size_t i = 0; i < _modules.size(); ++i) {
+      _modules[i]->_active_set = this;
+      _modules[i]->_active_index = i;
+    }
+  }
+
+  inline bool Empty() const {
+    return _modules.empty();
+  }
+
+  // true if no module is scheduled for the next cycle
+  inline bool NoneActive() const {
+    for(size_t w = 0; w < _active.size(); ++w) {
+      if(_active[w]) {
+	return false;
+      }
+    }
+    return true;
+  }
+
+  inline void Wake(int index) {
+    unsigned long long const mask = 1ULL << (index % 64);
+    _active[index / 64] |= mask;
+    _woken[index / 64] |= mask;
+  }
+
+  void Step(void (TimedModule::*phase)()) {
+    for(size_t w = 0; w < _active.size(); ++w) {
+      unsigned long long bits = _active[w];
+      while(bits) {
+	int const b = __builtin_ctzll(bits);
+	bits &= bits - 1;
+	_modules[w * 64 + b]->Step(phase);
+      }
+    }
+  }
+
+  // drop modules that went idle and were not woken during this cycle
+  void Retire() {
+    for(size_t w = 0; w < _active.size(); ++w) {
+      unsigned long long bits = _active[w] & ~_woken[w];
+      while(bits) {
+	int const b = __builtin_ctzll(bits);
+	bits &= bits - 1;
+	if(_modules[w * 64 + b]->Idle()) {
+	  _active[w] &= ~(1ULL << b);
+	}
+      }
+      _woken[w] = 0ULL;
+    }
+  }
 };
 
+inline void TimedModule::Wake() {
+  if(_active_set) {
+    _active_set->Wake(_active_index);
+  }
+}
+
 #endif
@@ -30,6 +30,7 @@
 #include <ctime>
 #include "random_utils.hpp"
 #include "traffic.hpp"
+#include "simulation_context.hpp"
 
 TrafficPattern::TrafficPattern(int nodes)
 : _nodes(nodes)
@@ -79,7 +80,7 @@ TrafficPattern * TrafficPattern::New(string const & pattern, int nodes,
       if(config) {
 	if(config->GetStr("perm_seed") == "time") {
 	  perm_seed = int(time(NULL));
-	  cout << "SEED: perm_seed=" << perm_seed << endl;
+	  *gContext->out << "SEED: perm_seed=" << perm_seed << endl;
 	} else {
 	  perm_seed = config->GetInt("perm_seed");
 	}
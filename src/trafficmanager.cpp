@@ -26,17 +26,23 @@
 */
 
 #include <sstream>
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <limits>
 #include <cstdlib>
 #include <ctime>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
 
 #include "booksim.hpp"
 #include "booksim_config.hpp"
 #include "trafficmanager.hpp"
 #include "batchtrafficmanager.hpp"
 #include "random_utils.hpp" 
+#include "misc_utils.hpp"
 #include "vc.hpp"
 #include "packet_reply_info.hpp"
 
@@ -64,6 +70,10 @@ TrafficManager::TrafficManager( const Configuration &config, const vector<Networ
 
     _vcs = config.GetInt("num_vcs");
     _subnets = config.GetInt("subnets");
+
+    for ( int i = 0; i < _subnets; ++i ) {
+        _net[i]->SetClock(&_time);
+    }
  
     _subnet.resize(Flit::NUM_FLIT_TYPES);
     _subnet[Flit::READ_REQUEST] = config.GetInt("read_request_subnet");
@@ -98,8 +108,8 @@ TrafficManager::TrafficManager( const Configuration &config, const vector<Networ
     // ============ Routing ============ 
 
     string rf = config.GetStr("routing_function") + "_" + config.GetStr("topology");
-    map<string, tRoutingFunction>::const_iterator rf_iter = gRoutingFunctionMap.find(rf);
-    if(rf_iter == gRoutingFunctionMap.end()) {
+    map<string, tRoutingFunction>::const_iterator rf_iter = gContext->routing_function_map.find(rf);
+    if(rf_iter == gContext->routing_function_map.end()) {
         Error("Invalid routing function: " + rf);
     }
     _rf = rf_iter->second;
@@ -281,7 +291,9 @@ TrafficManager::TrafficManager( const Configuration &config, const vector<Networ
 
     _total_in_flight_flits.resize(_classes);
     _measured_in_flight_flits.resize(_classes);
-    _retired_packets.resize(_classes);
+    _retired_packets.resize(_nodes*_subnets*_vcs, NULL);
+
+    _ejecting_flits.resize(_subnets, vector<Flit *>(_nodes, NULL));
 
     _packet_seq_no.resize(_nodes);
     _repliesPending.resize(_nodes);
@@ -289,6 +301,16 @@ TrafficManager::TrafficManager( const Configuration &config, const vector<Networ
 
     _hold_switch_for_packet = config.GetInt("hold_switch_for_packet");
 
+    _skip_idle_cycles = (config.GetInt("skip_idle_cycles") > 0);
+
+    _injection_calendar = true;
+    for(int c = 0; c < _classes; ++c) {
+        if(!_injection_process[c]->skip_ahead() || _use_read_write[c]) {
+            _injection_calendar = false;
+        }
+    }
+    _calendar_valid = false;
+
     // ============ Simulation parameters ============ 
 
     _total_sims = config.GetInt( "sim_count" );
@@ -302,11 +324,24 @@ TrafficManager::TrafficManager( const Configuration &config, const vector<Networ
     int seed;
     if(config.GetStr("seed") == "time") {
       seed = int(time(NULL));
-      cout << "SEED: seed=" << seed << endl;
+      *gContext->out << "SEED: seed=" << seed << endl;
     } else {
       seed = config.GetInt("seed");
     }
     RandomSeed(seed);
+    _seed = seed;
+
+    // Sources draw from their own streams while injecting, and routers 
+    // while being stepped; everything else uses the global generator.
+    if(config.GetInt("random_streams") > 0) {
+        _source_streams.resize(_nodes);
+        for(int n = 0; n < _nodes; ++n) {
+            _source_streams[n].Reset(seed, n, 0);
+        }
+        for(int i = 0; i < _subnets; ++i) {
+            _net[i]->SetRandomStreams(seed, i + 1);
+        }
+    }
 
     _measure_latency = (config.GetStr("sim_type") == "latency");
 
@@ -351,9 +386,36 @@ TrafficManager::TrafficManager( const Configuration &config, const vector<Networ
     }
     _acc_stopping_threshold.resize(_classes, _acc_stopping_threshold.back());
 
+    _stopping_ci = config.GetFloatArray( "stopping_ci" );
+    if(_stopping_ci.empty()) {
+        _stopping_ci.push_back(config.GetFloat("stopping_ci"));
+    }
+    _stopping_ci.resize(_classes, _stopping_ci.back());
+
+    _stopping_confidence = config.GetFloat( "stopping_confidence" );
+    if((_stopping_confidence <= 0.0) || (_stopping_confidence >= 1.0)) {
+        Error("stopping_confidence must be between 0 and 1.");
+    }
+    _stopping_min_batches = max(config.GetInt( "stopping_min_batches" ), 2);
+
     _include_queuing = config.GetInt( "include_queuing" );
 
     _print_csv_results = config.GetInt( "print_csv_results" );
+
+    _checkpoint_out = config.GetStr( "checkpoint_out" );
+    _checkpoint_in = config.GetStr( "checkpoint_in" );
+    _checkpoint_random_state = (config.GetInt( "checkpoint_random_state" ) > 0);
+    _checkpoint_restored = false;
+
+    _fork_sims = config.GetInt( "fork_sims" );
+    if((_fork_sims > 0) && (config.GetInt( "sim_threads" ) > 1)) {
+        // worker threads do not survive fork()
+        Error("fork_sims cannot be combined with sim_threads > 1.");
+    }
+    _sims_forked = false;
+    _forked_stable = false;
+    _sim_child = -1;
+    _sim_pipe = -1;
     _deadlock_warn_timeout = config.GetInt( "deadlock_warn_timeout" );
 
     string watch_file = config.GetStr( "watch_file" );
@@ -375,7 +437,7 @@ TrafficManager::TrafficManager( const Configuration &config, const vector<Networ
     if(stats_out_file == "") {
         _stats_out = NULL;
     } else if(stats_out_file == "-") {
-        _stats_out = &cout;
+        _stats_out = gContext->out;
     } else {
         _stats_out = new ofstream(stats_out_file.c_str());
         config.WriteMatlabFile(_stats_out);
@@ -477,6 +539,16 @@ TrafficManager::TrafficManager( const Configuration &config, const vector<Networ
         _pair_flat.resize(_classes);
     }
   
+    _latency_percentiles = config.GetFloatArray( "latency_percentiles" );
+    for(size_t i = 0; i < _latency_percentiles.size(); ++i) {
+        if((_latency_percentiles[i] < 0.0) || (_latency_percentiles[i] > 100.0)) {
+            Error("Latency percentiles must be between 0 and 100.");
+        }
+    }
+    _overall_plat_hist.resize(_classes);
+    _overall_nlat_hist.resize(_classes);
+    _overall_flat_hist.resize(_classes);
+
     _hop_stats.resize(_classes);
     _overall_hop_stats.resize(_classes, 0.0);
   
@@ -529,6 +601,19 @@ TrafficManager::TrafficManager( const Configuration &config, const vector<Networ
         _stats[tmp_name.str()] = _flat_stats[c];
         tmp_name.str("");
 
+        // not in _stats: these are neither cleared nor checkpointed
+        tmp_name << "overall_plat_stat_" << c;
+        _overall_plat_hist[c] = new Stats( this, tmp_name.str( ), 1.0, 1000 );
+        tmp_name.str("");
+
+        tmp_name << "overall_nlat_stat_" << c;
+        _overall_nlat_hist[c] = new Stats( this, tmp_name.str( ), 1.0, 1000 );
+        tmp_name.str("");
+
+        tmp_name << "overall_flat_stat_" << c;
+        _overall_flat_hist[c] = new Stats( this, tmp_name.str( ), 1.0, 1000 );
+        tmp_name.str("");
+
         tmp_name << "frag_stat_" << c;
         _frag_stats[c] = new Stats( this, tmp_name.str( ), 1.0, 100 );
         _stats[tmp_name.str()] = _frag_stats[c];
@@ -599,6 +684,9 @@ TrafficManager::~TrafficManager( )
         delete _plat_stats[c];
         delete _nlat_stats[c];
         delete _flat_stats[c];
+        delete _overall_plat_hist[c];
+        delete _overall_nlat_hist[c];
+        delete _overall_flat_hist[c];
         delete _frag_stats[c];
         delete _hop_stats[c];
 
@@ -615,8 +703,7 @@ TrafficManager::~TrafficManager( )
         }
     }
   
-    if(gWatchOut && (gWatchOut != &cout)) delete gWatchOut;
-    if(_stats_out && (_stats_out != &cout)) delete _stats_out;
+    if(_stats_out && (_stats_out != gContext->out)) delete _stats_out;
 
 #ifdef TRACK_FLOWS
     if(_injected_flits_out) delete _injected_flits_out;
@@ -644,16 +731,14 @@ void TrafficManager::_RetireFlit( Flit *f, int dest )
 {
     _deadlock_timer = 0;
 
-    assert(_total_in_flight_flits[f->cl].count(f->id) > 0);
-    _total_in_flight_flits[f->cl].erase(f->id);
+    _total_in_flight_flits[f->cl].Erase(f->id, f->ctime);
   
     if(f->record) {
-        assert(_measured_in_flight_flits[f->cl].count(f->id) > 0);
-        _measured_in_flight_flits[f->cl].erase(f->id);
+        _measured_in_flight_flits[f->cl].Erase(f->id, f->ctime);
     }
 
     if ( f->watch ) { 
-        *gWatchOut << GetSimTime() << " | "
+        *gContext->watch_out << GetSimTime() << " | "
                    << "node" << dest << " | "
                    << "Retiring flit " << f->id 
                    << " (packet " << f->pid
@@ -683,15 +768,15 @@ void TrafficManager::_RetireFlit( Flit *f, int dest )
         if(f->head) {
             head = f;
         } else {
-            map<int, Flit *>::iterator iter = _retired_packets[f->cl].find(f->pid);
-            assert(iter != _retired_packets[f->cl].end());
-            head = iter->second;
-            _retired_packets[f->cl].erase(iter);
+            Flit * & slot = _retired_packets[(dest*_subnets + f->subnetwork)*_vcs + f->vc];
+            head = slot;
+            assert(head);
+            slot = NULL;
             assert(head->head);
             assert(f->pid == head->pid);
         }
         if ( f->watch ) { 
-            *gWatchOut << GetSimTime() << " | "
+            *gContext->watch_out << GetSimTime() << " | "
                        << "node" << dest << " | "
                        << "Retiring packet " << f->pid 
                        << " (plat = " << f->atime - head->ctime
@@ -745,7 +830,9 @@ void TrafficManager::_RetireFlit( Flit *f, int dest )
     }
   
     if(f->head && !f->tail) {
-        _retired_packets[f->cl].insert(make_pair(f->pid, f));
+        Flit * & slot = _retired_packets[(dest*_subnets + f->subnetwork)*_vcs + f->vc];
+        assert(!slot);
+        slot = f;
     } else {
         f->Free();
     }
@@ -793,7 +880,7 @@ void TrafficManager::_GeneratePacket( int source, int stype,
     assert(_cur_pid);
     int packet_destination = _traffic_pattern[cl]->dest(source);
     bool record = false;
-    bool watch = gWatchOut && (_packets_to_watch.count(pid) > 0);
+    bool watch = gContext->watch_out && (_packets_to_watch.count(pid) > 0);
     if(_use_read_write[cl]){
         if(stype > 0) {
             if (stype == 1) {
@@ -845,83 +932,129 @@ void TrafficManager::_GeneratePacket( int source, int stype,
                       _subnet[packet_type]);
   
     if ( watch ) { 
-        *gWatchOut << GetSimTime() << " | "
+        *gContext->watch_out << GetSimTime() << " | "
                    << "node" << source << " | "
                    << "Enqueuing packet " << pid
                    << " at time " << time
                    << "." << endl;
     }
   
+    sQueuedPacket qp;
+    qp.type       = packet_type;
+    qp.pid        = pid;
+    qp.head_id    = _cur_id;
+    qp.tail_id    = _cur_id + size - 1;
+    qp.id         = qp.head_id;
+    qp.dest       = packet_destination;
+    qp.ctime      = time;
+    qp.vc         = -1;
+    qp.subnetwork = subnetwork;
+    qp.record     = record;
+    qp.watch      = watch;
+    qp.front      = NULL;
+    switch( _pri_type ) {
+    case class_based:
+        qp.pri = _class_priority[cl];
+        assert(qp.pri >= 0);
+        break;
+    case age_based:
+        qp.pri = numeric_limits<int>::max() - time;
+        assert(qp.pri >= 0);
+        break;
+    case sequence_based:
+        qp.pri = numeric_limits<int>::max() - _packet_seq_no[source];
+        assert(qp.pri >= 0);
+        break;
+    default:
+        qp.pri = 0;
+    }
+
     for ( int i = 0; i < size; ++i ) {
-        Flit * f  = Flit::New();
-        f->id     = _cur_id++;
+        int const id = _cur_id++;
         assert(_cur_id);
-        f->pid    = pid;
-        f->watch  = watch | (gWatchOut && (_flits_to_watch.count(f->id) > 0));
-        f->subnetwork = subnetwork;
-        f->src    = source;
-        f->ctime  = time;
-        f->record = record;
-        f->cl     = cl;
-
-        _total_in_flight_flits[f->cl].insert(make_pair(f->id, f));
+
+        _total_in_flight_flits[cl].Insert(id, time);
         if(record) {
-            _measured_in_flight_flits[f->cl].insert(make_pair(f->id, f));
+            _measured_in_flight_flits[cl].Insert(id, time);
         }
     
-        if(gTrace){
-            cout<<"New Flit "<<f->src<<endl;
-        }
-        f->type = packet_type;
-
-        if ( i == 0 ) { // Head flit
-            f->head = true;
-            //packets are only generated to nodes smaller or equal to limit
-            f->dest = packet_destination;
-        } else {
-            f->head = false;
-            f->dest = -1;
+        if(gContext->trace){
+            *gContext->out<<"New Flit "<<source<<endl;
         }
-        switch( _pri_type ) {
-        case class_based:
-            f->pri = _class_priority[cl];
-            assert(f->pri >= 0);
-            break;
-        case age_based:
-            f->pri = numeric_limits<int>::max() - time;
-            assert(f->pri >= 0);
-            break;
-        case sequence_based:
-            f->pri = numeric_limits<int>::max() - _packet_seq_no[source];
-            assert(f->pri >= 0);
-            break;
-        default:
-            f->pri = 0;
-        }
-        if ( i == ( size - 1 ) ) { // Tail flit
-            f->tail = true;
-        } else {
-            f->tail = false;
-        }
-    
-        f->vc  = -1;
 
-        if ( f->watch ) { 
-            *gWatchOut << GetSimTime() << " | "
+        if ( watch || (gContext->watch_out && (_flits_to_watch.count(id) > 0)) ) { 
+            *gContext->watch_out << GetSimTime() << " | "
                        << "node" << source << " | "
-                       << "Enqueuing flit " << f->id
-                       << " (packet " << f->pid
+                       << "Enqueuing flit " << id
+                       << " (packet " << pid
                        << ") at time " << time
                        << "." << endl;
         }
+    }
 
-        _partial_packets[source][cl].push_back( f );
+    _partial_packets[source][cl].push_back( qp );
+}
+
+Flit * TrafficManager::_FrontFlit( int source, int cl )
+{
+    assert(!_partial_packets[source][cl].empty());
+    sQueuedPacket & qp = _partial_packets[source][cl].front();
+    if(qp.front) {
+        return qp.front;
+    }
+
+    Flit * f  = Flit::New();
+    f->id     = qp.id;
+    f->pid    = qp.pid;
+    f->watch  = qp.watch | (gContext->watch_out && (_flits_to_watch.count(f->id) > 0));
+    f->subnetwork = qp.subnetwork;
+    f->src    = source;
+    f->ctime  = qp.ctime;
+    f->record = qp.record;
+    f->cl     = cl;
+    f->type   = qp.type;
+    f->head   = (qp.id == qp.head_id);
+    f->tail   = (qp.id == qp.tail_id);
+    //packets are only generated to nodes smaller or equal to limit
+    f->dest   = f->head ? qp.dest : -1;
+    f->pri    = qp.pri;
+    f->vc     = qp.vc;
+
+    qp.front = f;
+    return f;
+}
+
+void TrafficManager::_PopFrontFlit( int source, int cl )
+{
+    assert(!_partial_packets[source][cl].empty());
+    sQueuedPacket & qp = _partial_packets[source][cl].front();
+    Flit const * const f = qp.front;
+    assert(f);
+    qp.front = NULL;
+    if(f->tail) {
+        _partial_packets[source][cl].pop_front();
+        if(_calendar_valid && _partial_packets[source][cl].empty()) {
+            _calendar_ready.push_back(make_pair(source, cl));
+        }
+    } else {
+        // Pass VC "back"
+        qp.vc = f->vc;
+        ++qp.id;
     }
 }
 
 void TrafficManager::_Inject(){
 
+    if(_injection_calendar && (_sim_state != draining)) {
+        _InjectFromCalendar();
+        return;
+    }
+
+    // the calendar does not track queue times reached by polling
+    _calendar_valid = false;
+
     for ( int input = 0; input < _nodes; ++input ) {
+        RandomStreamScope scope(_SourceStream(input));
         for ( int c = 0; c < _classes; ++c ) {
             // Potentially generate packets for any (input,class)
             // that is currently empty
@@ -951,32 +1084,146 @@ void TrafficManager::_Inject(){
     }
 }
 
-void TrafficManager::_Step( )
+void TrafficManager::_InjectFromCalendar( )
 {
+    if(!_calendar_valid) {
+        _calendar = priority_queue<tCalendarEntry, vector<tCalendarEntry>, 
+                                   greater<tCalendarEntry> >();
+        _calendar_ready.clear();
+        for ( int input = 0; input < _nodes; ++input ) {
+            for ( int c = 0; c < _classes; ++c ) {
+                if ( _partial_packets[input][c].empty() ) {
+                    _calendar_ready.push_back(make_pair(input, c));
+                }
+            }
+        }
+        _calendar_valid = true;
+    }
+
+    while(!_calendar.empty() && (_calendar.top().first <= _time)) {
+        _calendar_ready.push_back(_calendar.top().second);
+        _calendar.pop();
+    }
+
+    if(_calendar_ready.empty()) {
+        return;
+    }
+
+    // visit sources in the same order as the polling loop, so that random 
+    // numbers are drawn in the same order
+    sort(_calendar_ready.begin(), _calendar_ready.end());
+
+    for(size_t i = 0; i < _calendar_ready.size(); ++i) {
+        int const input = _calendar_ready[i].first;
+        int const c = _calendar_ready[i].second;
+        assert(_partial_packets[input][c].empty());
+        RandomStreamScope scope(_SourceStream(input));
+        InjectionProcess * const ip = _injection_process[c];
+        int & qtime = _qtime[input][c];
+        while(true) {
+            int const idle = ip->idle(input);
+            if((long long)qtime + idle > (long long)_time) {
+                // the trials up to _time are consumed lazily once the 
+                // source is due
+                if((long long)qtime + idle <= (long long)numeric_limits<int>::max()) {
+                    _calendar.push(make_pair(qtime + idle, _calendar_ready[i]));
+                }
+                break;
+            }
+            ip->skip(input, idle);
+            _requestsOutstanding[input] += idle;
+            qtime += idle;
+            int const stype = _IssuePacket( input, c );
+            bool const generated = (stype != 0);
+            if ( generated ) {
+                _GeneratePacket( input, stype, c, 
+                                 _include_queuing==1 ? qtime : _time );
+            }
+            ++qtime;
+            if ( generated ) {
+                break;
+            }
+        }
+    }
+    _calendar_ready.clear();
+}
+
+bool TrafficManager::_Quiescent( ) const
+{
+    for(int c = 0; c < _classes; ++c) {
+        if(!_total_in_flight_flits[c].Empty()) {
+            return false;
+        }
+    }
+    if(Credit::OutStanding() != 0) {
+        return false;
+    }
+    for(int subnet = 0; subnet < _subnets; ++subnet) {
+        if(!_net[subnet]->Idle()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int TrafficManager::_Step( int max_cycles )
+{
+    if(_skip_idle_cycles && (max_cycles > 1) && _Quiescent()) {
+        // Nothing is in flight, so ejection, credit return and the network 
+        // phases are no-ops. Polled injection processes still have to be 
+        // visited every cycle so that random numbers are drawn in the same 
+        // order as in a cycle-by-cycle run. With the injection calendar, 
+        // no source is visited before the earliest entry is due, so time 
+        // jumps straight to it.
+        int cycles = 0;
+        while(cycles < max_cycles) {
+            ++cycles;
+            if ( !_empty_network ) {
+                _Inject();
+            }
+            if(!_Quiescent()) {
+                _FinishStep();
+                return cycles;
+            }
+            _AdvanceTime();
+            if(_injection_calendar && _calendar_valid && _calendar_ready.empty() &&
+               (_sim_state != draining) && !gContext->trace) {
+                long long const due = _calendar.empty() ? 
+                    numeric_limits<long long>::max() : _calendar.top().first;
+                int const skip = (int)min((long long)(max_cycles - cycles), 
+                                          due - _time);
+                if(skip > 0) {
+                    _time += skip;
+                    cycles += skip;
+                }
+            }
+        }
+        return max_cycles;
+    }
+
     bool flits_in_flight = false;
     for(int c = 0; c < _classes; ++c) {
-        flits_in_flight |= !_total_in_flight_flits[c].empty();
+        flits_in_flight |= !_total_in_flight_flits[c].Empty();
     }
     if(flits_in_flight && (_deadlock_timer++ >= _deadlock_warn_timeout)){
         _deadlock_timer = 0;
-        cout << "WARNING: Possible network deadlock.\n";
+        *gContext->out << "WARNING: Possible network deadlock.\n";
     }
 
-    vector<map<int, Flit *> > flits(_subnets);
-  
     for ( int subnet = 0; subnet < _subnets; ++subnet ) {
         for ( int n = 0; n < _nodes; ++n ) {
             Flit * const f = _net[subnet]->ReadFlit( n );
             if ( f ) {
                 if(f->watch) {
-                    *gWatchOut << GetSimTime() << " | "
+                    *gContext->watch_out << GetSimTime() << " | "
                                << "node" << n << " | "
                                << "Ejecting flit " << f->id
                                << " (packet " << f->pid << ")"
                                << " from VC " << f->vc
                                << "." << endl;
                 }
-                flits[subnet].insert(make_pair(n, f));
+                assert(!_ejecting_flits[subnet][n]);
+                _ejecting_flits[subnet][n] = f;
                 if((_sim_state == warming_up) || (_sim_state == running)) {
                     ++_accepted_flits[f->cl][n];
                     if(f->tail) {
@@ -988,8 +1235,7 @@ void TrafficManager::_Step( )
             Credit * const c = _net[subnet]->ReadCredit( n );
             if ( c ) {
 #ifdef TRACK_FLOWS
-                for(set<int>::const_iterator iter = c->vc.begin(); iter != c->vc.end(); ++iter) {
-                    int const vc = *iter;
+                for(int vc = c->FirstVC(); vc >= 0; vc = c->NextVC(vc)) {
                     assert(!_outstanding_classes[n][subnet][vc].empty());
                     int cl = _outstanding_classes[n][subnet][vc].front();
                     _outstanding_classes[n][subnet][vc].pop();
@@ -1008,6 +1254,12 @@ void TrafficManager::_Step( )
         _Inject();
     }
 
+    _FinishStep();
+    return 1;
+}
+
+void TrafficManager::_FinishStep( )
+{
     for(int subnet = 0; subnet < _subnets; ++subnet) {
 
         for(int n = 0; n < _nodes; ++n) {
@@ -1021,10 +1273,10 @@ void TrafficManager::_Step( )
             int class_limit = _classes;
 
             if(_hold_switch_for_packet) {
-                list<Flit *> const & pp = _partial_packets[n][last_class];
-                if(!pp.empty() && !pp.front()->head && 
-                   !dest_buf->IsFullFor(pp.front()->vc)) {
-                    f = pp.front();
+                Flit * const pf = _partial_packets[n][last_class].empty() ?
+                    NULL : _FrontFlit(n, last_class);
+                if(pf && !pf->head && !dest_buf->IsFullFor(pf->vc)) {
+                    f = pf;
                     assert(f->vc == _last_vc[n][subnet][last_class]);
 
                     // if we're holding the connection, we don't need to check that class 
@@ -1037,13 +1289,11 @@ void TrafficManager::_Step( )
 
                 int const c = (last_class + i) % _classes;
 
-                list<Flit *> const & pp = _partial_packets[n][c];
-
-                if(pp.empty()) {
+                if(_partial_packets[n][c].empty()) {
                     continue;
                 }
 
-                Flit * const cf = pp.front();
+                Flit * const cf = _FrontFlit(n, c);
                 assert(cf);
                 assert(cf->cl == c);
 	
@@ -1059,7 +1309,7 @@ void TrafficManager::_Step( )
 	  
                     OutputSet route_set;
                     _rf(NULL, cf, -1, &route_set, true);
-                    set<OutputSet::sSetElement> const & os = route_set.GetSet();
+                    OutputSet::ElementSet const & os = route_set.GetSet();
                     assert(os.size() == 1);
                     OutputSet::sSetElement const & se = *os.begin();
                     assert(se.output_port == -1);
@@ -1077,16 +1327,16 @@ void TrafficManager::_Step( )
                         // first hop, we have to temporarily set cf's VC to be non-negative 
                         // in order to avoid seting of an assertion in the routing function.
                         cf->vc = vc_start;
-                        _rf(router, cf, in_channel, &cf->la_route_set, false);
+                        _rf(router, cf, in_channel, cf->LookaheadRouteSet(), false);
                         cf->vc = -1;
 
                         if(cf->watch) {
-                            *gWatchOut << GetSimTime() << " | "
+                            *gContext->watch_out << GetSimTime() << " | "
                                        << "node" << n << " | "
                                        << "Generating lookahead routing info for flit " << cf->id
                                        << " (NOQ)." << endl;
                         }
-                        set<OutputSet::sSetElement> const sl = cf->la_route_set.GetSet();
+                        OutputSet::ElementSet const & sl = cf->LookaheadRouteSet()->GetSet();
                         assert(sl.size() == 1);
                         int next_output = sl.begin()->output_port;
                         vc_count /= router->NumOutputs();
@@ -1097,7 +1347,7 @@ void TrafficManager::_Step( )
                         assert(vc_start <= vc_end);
                     }
                     if(cf->watch) {
-                        *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+                        *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
                                    << "Finding output VC for flit " << cf->id
                                    << ":" << endl;
                     }
@@ -1110,18 +1360,18 @@ void TrafficManager::_Step( )
                         assert((vc >= vc_start) && (vc <= vc_end));
                         if(!dest_buf->IsAvailableFor(vc)) {
                             if(cf->watch) {
-                                *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+                                *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
                                            << "  Output VC " << vc << " is busy." << endl;
                             }
                         } else {
                             if(dest_buf->IsFullFor(vc)) {
                                 if(cf->watch) {
-                                    *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+                                    *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
                                                << "  Output VC " << vc << " is full." << endl;
                                 }
                             } else {
                                 if(cf->watch) {
-                                    *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+                                    *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
                                                << "  Selected output VC " << vc << "." << endl;
                                 }
                                 cf->vc = vc;
@@ -1133,14 +1383,14 @@ void TrafficManager::_Step( )
 	
                 if(cf->vc == -1) {
                     if(cf->watch) {
-                        *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+                        *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
                                    << "No output VC found for flit " << cf->id
                                    << "." << endl;
                     }
                 } else {
                     if(dest_buf->IsFullFor(cf->vc)) {
                         if(cf->watch) {
-                            *gWatchOut << GetSimTime() << " | " << FullName() << " | "
+                            *gContext->watch_out << GetSimTime() << " | " << FullName() << " | "
                                        << "Selected output VC " << cf->vc
                                        << " is full for flit " << cf->id
                                        << "." << endl;
@@ -1165,21 +1415,21 @@ void TrafficManager::_Step( )
                             const Router * router = inject->GetSink();
                             assert(router);
                             int in_channel = inject->GetSinkPort();
-                            _rf(router, f, in_channel, &f->la_route_set, false);
+                            _rf(router, f, in_channel, f->LookaheadRouteSet(), false);
                             if(f->watch) {
-                                *gWatchOut << GetSimTime() << " | "
+                                *gContext->watch_out << GetSimTime() << " | "
                                            << "node" << n << " | "
                                            << "Generating lookahead routing info for flit " << f->id
                                            << "." << endl;
                             }
                         } else if(f->watch) {
-                            *gWatchOut << GetSimTime() << " | "
+                            *gContext->watch_out << GetSimTime() << " | "
                                        << "node" << n << " | "
                                        << "Already generated lookahead routing info for flit " << f->id
                                        << " (NOQ)." << endl;
                         }
                     } else {
-                        f->la_route_set.Clear();
+                        f->ClearLookaheadRouteSet();
                     }
 
                     dest_buf->TakeBuffer(f->vc);
@@ -1188,7 +1438,7 @@ void TrafficManager::_Step( )
 	
                 _last_class[n][subnet] = c;
 
-                _partial_packets[n][c].pop_front();
+                _PopFrontFlit(n, c);
 
 #ifdef TRACK_FLOWS
                 ++_outstanding_credits[c][subnet][n];
@@ -1203,7 +1453,7 @@ void TrafficManager::_Step( )
                 }
 	
                 if(f->watch) {
-                    *gWatchOut << GetSimTime() << " | "
+                    *gContext->watch_out << GetSimTime() << " | "
                                << "node" << n << " | "
                                << "Injecting flit " << f->id
                                << " into subnet " << subnet
@@ -1213,12 +1463,6 @@ void TrafficManager::_Step( )
                 }
                 f->itime = _time;
 
-                // Pass VC "back"
-                if(!_partial_packets[n][c].empty() && !f->tail) {
-                    Flit * const nf = _partial_packets[n][c].front();
-                    nf->vc = f->vc;
-                }
-	
                 if((_sim_state == warming_up) || (_sim_state == running)) {
                     ++_sent_flits[c][n];
                     if(f->head) {
@@ -1238,20 +1482,20 @@ void TrafficManager::_Step( )
 
     for(int subnet = 0; subnet < _subnets; ++subnet) {
         for(int n = 0; n < _nodes; ++n) {
-            map<int, Flit *>::const_iterator iter = flits[subnet].find(n);
-            if(iter != flits[subnet].end()) {
-                Flit * const f = iter->second;
+            Flit * const f = _ejecting_flits[subnet][n];
+            if(f) {
+                _ejecting_flits[subnet][n] = NULL;
 
                 f->atime = _time;
                 if(f->watch) {
-                    *gWatchOut << GetSimTime() << " | "
+                    *gContext->watch_out << GetSimTime() << " | "
                                << "node" << n << " | "
                                << "Injecting credit for VC " << f->vc 
                                << " into subnet " << subnet 
                                << "." << endl;
                 }
                 Credit * const c = Credit::New();
-                c->vc.insert(f->vc);
+                c->AddVC(f->vc);
                 _net[subnet]->WriteCredit(c, n);
 	
 #ifdef TRACK_FLOWS
@@ -1261,37 +1505,40 @@ void TrafficManager::_Step( )
                 _RetireFlit(f, n);
             }
         }
-        flits[subnet].clear();
         _net[subnet]->Evaluate( );
         _net[subnet]->WriteOutputs( );
     }
 
+    _AdvanceTime();
+}
+
+void TrafficManager::_AdvanceTime( )
+{
     ++_time;
     assert(_time);
-    if(gTrace){
-        cout<<"TIME "<<_time<<endl;
+    if(gContext->trace){
+        *gContext->out<<"TIME "<<_time<<endl;
     }
-
 }
   
 bool TrafficManager::_PacketsOutstanding( ) const
 {
     for ( int c = 0; c < _classes; ++c ) {
         if ( _measure_stats[c] ) {
-            if ( _measured_in_flight_flits[c].empty() ) {
+            if ( _measured_in_flight_flits[c].Empty() ) {
 	
                 for ( int s = 0; s < _nodes; ++s ) {
                     if ( !_qdrained[s][c] ) {
 #ifdef DEBUG_DRAIN
-                        cout << "waiting on queue " << s << " class " << c;
-                        cout << ", time = " << _time << " qtime = " << _qtime[s][c] << endl;
+                        *gContext->out << "waiting on queue " << s << " class " << c;
+                        *gContext->out << ", time = " << _time << " qtime = " << _qtime[s][c] << endl;
 #endif
                         return true;
                     }
                 }
             } else {
 #ifdef DEBUG_DRAIN
-                cout << "in flight = " << _measured_in_flight_flits[c].size() << endl;
+                *gContext->out << "in flight = " << _measured_in_flight_flits[c].Size() << endl;
 #endif
                 return true;
             }
@@ -1338,6 +1585,13 @@ void TrafficManager::_ClearStats( )
 
     }
 
+    _plat_batches.assign(_classes, vector<double>());
+    _accepted_batches.assign(_classes, vector<double>());
+    _batch_plat_sum.assign(_classes, 0.0);
+    _batch_plat_count.assign(_classes, 0);
+    _batch_accepted_count.assign(_classes, 0);
+    _batch_start_time.assign(_classes, _time);
+
     _reset_time = _time;
 }
 
@@ -1384,36 +1638,79 @@ void TrafficManager::_DisplayRemaining( ostream & os ) const
 {
     for(int c = 0; c < _classes; ++c) {
 
-        map<int, Flit *>::const_iterator iter;
-        int i;
+        vector<int> ids;
 
         os << "Class " << c << ":" << endl;
 
         os << "Remaining flits: ";
-        for ( iter = _total_in_flight_flits[c].begin( ), i = 0;
-              ( iter != _total_in_flight_flits[c].end( ) ) && ( i < 10 );
-              iter++, i++ ) {
-            os << iter->first << " ";
+        _total_in_flight_flits[c].LowestIDs(10, ids);
+        for ( size_t i = 0; i < ids.size(); i++ ) {
+            os << ids[i] << " ";
         }
-        if(_total_in_flight_flits[c].size() > 10)
+        if(_total_in_flight_flits[c].Size() > 10)
             os << "[...] ";
     
-        os << "(" << _total_in_flight_flits[c].size() << " flits)" << endl;
+        os << "(" << _total_in_flight_flits[c].Size() << " flits)" << endl;
     
         os << "Measured flits: ";
-        for ( iter = _measured_in_flight_flits[c].begin( ), i = 0;
-              ( iter != _measured_in_flight_flits[c].end( ) ) && ( i < 10 );
-              iter++, i++ ) {
-            os << iter->first << " ";
+        ids.clear();
+        _measured_in_flight_flits[c].LowestIDs(10, ids);
+        for ( size_t i = 0; i < ids.size(); i++ ) {
+            os << ids[i] << " ";
         }
-        if(_measured_in_flight_flits[c].size() > 10)
+        if(_measured_in_flight_flits[c].Size() > 10)
             os << "[...] ";
     
-        os << "(" << _measured_in_flight_flits[c].size() << " flits)" << endl;
+        os << "(" << _measured_in_flight_flits[c].Size() << " flits)" << endl;
     
     }
 }
 
+// Ends a batch for class c: the mean latency of the packets retired and 
+// the accepted flit rate per node since the previous batch.
+void TrafficManager::_RecordBatch( int c )
+{
+    double const plat_sum = _plat_stats[c]->Sum();
+    int const plat_count = _plat_stats[c]->NumSamples();
+    if(plat_count > _batch_plat_count[c]) {
+        _plat_batches[c].push_back((plat_sum - _batch_plat_sum[c]) / 
+                                   (double)(plat_count - _batch_plat_count[c]));
+    }
+    _batch_plat_sum[c] = plat_sum;
+    _batch_plat_count[c] = plat_count;
+
+    int accepted_count;
+    _ComputeStats( _accepted_flits[c], &accepted_count );
+    _accepted_batches[c].push_back((double)(accepted_count - _batch_accepted_count[c]) / 
+                                   ((double)(_time - _batch_start_time[c]) * (double)_nodes));
+    _batch_accepted_count[c] = accepted_count;
+    _batch_start_time[c] = _time;
+}
+
+// Batch-means confidence interval at _stopping_confidence; returns false 
+// while there are too few batches.
+bool TrafficManager::_ConfidenceInterval( vector<double> const & batches, 
+                                          double & mean, double & half_width ) const
+{
+    int const n = batches.size();
+    if(n < _stopping_min_batches) {
+        return false;
+    }
+    mean = 0.0;
+    for(int i = 0; i < n; ++i) {
+        mean += batches[i];
+    }
+    mean /= (double)n;
+    double variance = 0.0;
+    for(int i = 0; i < n; ++i) {
+        variance += (batches[i] - mean) * (batches[i] - mean);
+    }
+    variance /= (double)(n - 1);
+    double const t = student_t_quantile(0.5 + 0.5 * _stopping_confidence, n - 1);
+    half_width = t * sqrt(variance / (double)n);
+    return true;
+}
+
 bool TrafficManager::_SingleSim( )
 {
     int converged = 0;
@@ -1423,9 +1720,30 @@ bool TrafficManager::_SingleSim( )
     vector<double> prev_accepted(_classes, 0.0);
     bool clear_last = false;
     int total_phases = 0;
+
+    // with confidence intervals requested, these replace the change 
+    // thresholds as the stopping criterion
+    bool stop_on_ci = false;
+    for(int c = 0; c < _classes; ++c) {
+        stop_on_ci |= ((_measure_stats[c] != 0) && (_stopping_ci[c] > 0.0));
+    }
+
+    if(!_checkpoint_in.empty()) {
+        _Checkpoint(_checkpoint_in, Checkpoint::restore, total_phases, 
+                    converged, prev_latency, prev_accepted, clear_last);
+    }
     while( ( total_phases < _max_samples ) && 
            ( ( _sim_state != running ) || 
              ( converged < 3 ) ) ) {
+
+        if ( ( _fork_sims > 0 ) && ( _total_sims > 1 ) && 
+             ( _sim_state == running ) && !_sims_forked && ( _sim_child < 0 ) ) {
+            _ForkSims( );
+            if ( _sim_child < 0 ) {
+                // the forked copies have measured all simulations
+                return _forked_stable;
+            }
+        }
     
         if ( clear_last || (( ( _sim_state == warming_up ) && ( ( total_phases % 2 ) == 0 ) )) ) {
             clear_last = false;
@@ -1433,17 +1751,18 @@ bool TrafficManager::_SingleSim( )
         }
     
     
-        for ( int iter = 0; iter < _sample_period; ++iter )
-            _Step( );
+        for ( int iter = 0; iter < _sample_period; )
+            iter += _Step( _sample_period - iter );
     
-        //cout << _sim_state << endl;
+        //*gContext->out << _sim_state << endl;
 
         UpdateStats();
-        DisplayStats();
+        DisplayStats(*gContext->out);
     
         int lat_exc_class = -1;
         int lat_chg_exc_class = -1;
         int acc_chg_exc_class = -1;
+        int ci_exc_class = -1;
     
         for(int c = 0; c < _classes; ++c) {
       
@@ -1467,13 +1786,9 @@ bool TrafficManager::_SingleSim( )
             double latency = (double)_plat_stats[c]->Sum();
             double count = (double)_plat_stats[c]->NumSamples();
       
-            map<int, Flit *>::const_iterator iter;
-            for(iter = _total_in_flight_flits[c].begin(); 
-                iter != _total_in_flight_flits[c].end(); 
-                iter++) {
-                latency += (double)(_time - iter->second->ctime);
-                count++;
-            }
+            InFlightSet const & in_flight = _total_in_flight_flits[c];
+            latency += (double)((long long)in_flight.Size() * _time - in_flight.CtimeSum());
+            count += in_flight.Size();
       
             if((lat_exc_class < 0) &&
                (_latency_thres[c] >= 0.0) &&
@@ -1481,7 +1796,7 @@ bool TrafficManager::_SingleSim( )
                 lat_exc_class = c;
             }
       
-            cout << "latency change    = " << latency_change << endl;
+            *gContext->out << "latency change    = " << latency_change << endl;
             if(lat_chg_exc_class < 0) {
                 if((_sim_state == warming_up) &&
                    (_warmup_threshold[c] >= 0.0) &&
@@ -1494,7 +1809,7 @@ bool TrafficManager::_SingleSim( )
                 }
             }
       
-            cout << "throughput change = " << accepted_change << endl;
+            *gContext->out << "throughput change = " << accepted_change << endl;
             if(acc_chg_exc_class < 0) {
                 if((_sim_state == warming_up) &&
                    (_acc_warmup_threshold[c] >= 0.0) &&
@@ -1506,13 +1821,38 @@ bool TrafficManager::_SingleSim( )
                     acc_chg_exc_class = c;
                 }
             }
+
+            if((_sim_state == running) && (_stopping_ci[c] > 0.0)) {
+                _RecordBatch(c);
+                double mean, half_width;
+                bool narrow = true;
+                if(_measure_latency) {
+                    if(_ConfidenceInterval(_plat_batches[c], mean, half_width)) {
+                        *gContext->out << "latency CI        = " << mean << " +/- " << half_width
+                                       << " (" << _plat_batches[c].size() << " batches)" << endl;
+                        narrow &= (half_width <= _stopping_ci[c] * mean);
+                    } else {
+                        narrow = false;
+                    }
+                }
+                if(_ConfidenceInterval(_accepted_batches[c], mean, half_width)) {
+                    *gContext->out << "throughput CI     = " << mean << " +/- " << half_width
+                                   << " (" << _accepted_batches[c].size() << " batches)" << endl;
+                    narrow &= (half_width <= _stopping_ci[c] * mean);
+                } else {
+                    narrow = false;
+                }
+                if(!narrow && (ci_exc_class < 0)) {
+                    ci_exc_class = c;
+                }
+            }
       
         }
     
         // Fail safe for latency mode, throughput will ust continue
         if ( _measure_latency && ( lat_exc_class >= 0 ) ) {
       
-            cout << "Average latency for class " << lat_exc_class << " exceeded " << _latency_thres[lat_exc_class] << " cycles. Aborting simulation." << endl;
+            *gContext->out << "Average latency for class " << lat_exc_class << " exceeded " << _latency_thres[lat_exc_class] << " cycles. Aborting simulation." << endl;
             converged = 0; 
             _sim_state = draining;
             _drain_time = _time;
@@ -1528,29 +1868,77 @@ bool TrafficManager::_SingleSim( )
                  ( total_phases + 1 >= _warmup_periods ) :
                  ( ( !_measure_latency || ( lat_chg_exc_class < 0 ) ) &&
                    ( acc_chg_exc_class < 0 ) ) ) {
-                cout << "Warmed up ..." <<  "Time used is " << _time << " cycles" <<endl;
+                *gContext->out << "Warmed up ..." <<  "Time used is " << _time << " cycles" <<endl;
                 clear_last = true;
                 _sim_state = running;
             }
         } else if(_sim_state == running) {
-            if ( ( !_measure_latency || ( lat_chg_exc_class < 0 ) ) &&
-                 ( acc_chg_exc_class < 0 ) ) {
+            if ( stop_on_ci ) {
+                if ( ci_exc_class < 0 ) {
+                    // every requested confidence interval is narrow enough
+                    converged = 3;
+                }
+            } else if ( ( !_measure_latency || ( lat_chg_exc_class < 0 ) ) &&
+                        ( acc_chg_exc_class < 0 ) ) {
                 ++converged;
             } else {
                 converged = 0;
             }
         }
         ++total_phases;
+
+        if(clear_last && !_checkpoint_out.empty()) {
+            // just warmed up; only the first simulation is saved
+            _Checkpoint(_checkpoint_out, Checkpoint::save, total_phases, 
+                        converged, prev_latency, prev_accepted, clear_last);
+            _checkpoint_out.clear();
+        }
     }
-  
+
+    if ( !_checkpoint_out.empty() ) {
+        *gContext->out << "Warning: Checkpoint " << _checkpoint_out
+                       << " was not saved because the simulation never warmed up." << endl;
+        _checkpoint_out.clear();
+    }
+
     if ( _sim_state == running ) {
+
+        if ( stop_on_ci ) {
+            // otherwise sampling ended because max_samples was reached
+            bool const ci_reached = ( converged >= 3 );
+            for ( int c = 0; c < _classes; ++c ) {
+                if ( ( _measure_stats[c] == 0 ) || ( _stopping_ci[c] <= 0.0 ) ) {
+                    continue;
+                }
+                double mean, half_width;
+                if ( _measure_latency && 
+                     _ConfidenceInterval( _plat_batches[c], mean, half_width ) ) {
+                    *gContext->out << "Class " << c << " packet latency = " << mean 
+                                   << " +/- " << half_width << " (" 
+                                   << 100.0 * _stopping_confidence << "% confidence, " 
+                                   << _plat_batches[c].size() << " batches)" << endl;
+                }
+                if ( _ConfidenceInterval( _accepted_batches[c], mean, half_width ) ) {
+                    *gContext->out << "Class " << c << " accepted flit rate = " << mean 
+                                   << " +/- " << half_width << " (" 
+                                   << 100.0 * _stopping_confidence << "% confidence, " 
+                                   << _accepted_batches[c].size() << " batches)" << endl;
+                }
+                if ( !ci_reached ) {
+                    *gContext->out << "Warning: Class " << c << " confidence interval target of +/- " 
+                                   << 100.0 * _stopping_ci[c] << "% not reached within max_samples = " 
+                                   << _max_samples << " sample periods." << endl;
+                }
+            }
+        }
+
         ++converged;
     
         _sim_state  = draining;
         _drain_time = _time;
 
         if ( _measure_latency ) {
-            cout << "Draining all recorded packets ..." << endl;
+            *gContext->out << "Draining all recorded packets ..." << endl;
             int empty_steps = 0;
             while( _PacketsOutstanding( ) ) { 
                 _Step( ); 
@@ -1572,13 +1960,9 @@ bool TrafficManager::_SingleSim( )
                         double acc_latency = _plat_stats[c]->Sum();
                         double acc_count = (double)_plat_stats[c]->NumSamples();
 	    
-                        map<int, Flit *>::const_iterator iter;
-                        for(iter = _total_in_flight_flits[c].begin(); 
-                            iter != _total_in_flight_flits[c].end(); 
-                            iter++) {
-                            acc_latency += (double)(_time - iter->second->ctime);
-                            acc_count++;
-                        }
+                        InFlightSet const & in_flight = _total_in_flight_flits[c];
+                        acc_latency += (double)((long long)in_flight.Size() * _time - in_flight.CtimeSum());
+                        acc_count += in_flight.Size();
 	    
                         if((acc_latency / acc_count) > threshold) {
                             lat_exc_class = c;
@@ -1587,7 +1971,7 @@ bool TrafficManager::_SingleSim( )
                     }
 	  
                     if(lat_exc_class >= 0) {
-                        cout << "Average latency for class " << lat_exc_class << " exceeded " << _latency_thres[lat_exc_class] << " cycles. Aborting simulation." << endl;
+                        *gContext->out << "Average latency for class " << lat_exc_class << " exceeded " << _latency_thres[lat_exc_class] << " cycles. Aborting simulation." << endl;
                         converged = 0; 
                         _sim_state = warming_up;
                         if(_stats_out) {
@@ -1596,18 +1980,447 @@ bool TrafficManager::_SingleSim( )
                         break;
                     }
 	  
-                    _DisplayRemaining( ); 
+                    _DisplayRemaining( *gContext->out ); 
 	  
                 }
             }
         }
     } else {
-        cout << "Too many sample periods needed to converge" << endl;
+        *gContext->out << "Too many sample periods needed to converge" << endl;
     }
   
     return ( converged > 0 );
 }
 
+void TrafficManager::sQueuedPacket::SyncState( Checkpoint & cp )
+{
+    cp.SyncEnum(type);
+    cp.Sync(pid);
+    cp.Sync(head_id);
+    cp.Sync(tail_id);
+    cp.Sync(id);
+    cp.Sync(dest);
+    cp.Sync(ctime);
+    cp.Sync(pri);
+    cp.Sync(vc);
+    cp.Sync(subnetwork);
+    cp.Sync(record);
+    cp.Sync(watch);
+    cp.Sync(front);
+}
+
+void TrafficManager::_SyncState( Checkpoint & cp )
+{
+    cp.Check(_nodes, "number of nodes");
+    cp.Check(_subnets, "number of subnetworks");
+    cp.Check(_classes, "number of traffic classes");
+
+    cp.SyncEnum(_sim_state);
+    cp.Sync(_time);
+    cp.Sync(_reset_time);
+    cp.Sync(_drain_time);
+    cp.Sync(_cur_id);
+    cp.Sync(_cur_pid);
+    cp.Sync(_deadlock_timer);
+
+    for(int i = 0; i < _subnets; ++i) {
+        _net[i]->SyncState(cp);
+    }
+
+    // sources
+    for(int n = 0; n < _nodes; ++n) {
+        for(int i = 0; i < _subnets; ++i) {
+            _buf_states[n][i]->SyncState(cp);
+        }
+    }
+    cp.Sync(_last_vc);
+    cp.Sync(_last_class);
+    cp.Sync(_qtime);
+    cp.Sync(_qdrained);
+    cp.Sync(_partial_packets);
+    cp.Sync(_calendar_valid);
+    cp.Sync(_calendar);
+    cp.Sync(_calendar_ready);
+    for(int c = 0; c < _classes; ++c) {
+        _injection_process[c]->SyncState(cp);
+    }
+    cp.Sync(_packet_seq_no);
+    cp.Sync(_repliesPending);
+    cp.Sync(_requestsOutstanding);
+#ifdef TRACK_FLOWS
+    cp.Sync(_outstanding_credits);
+    cp.Sync(_outstanding_classes);
+    cp.Sync(_injected_flits);
+    cp.Sync(_ejected_flits);
+#endif
+
+    // sinks
+    cp.Sync(_total_in_flight_flits);
+    cp.Sync(_measured_in_flight_flits);
+    cp.Sync(_retired_packets);
+    cp.Sync(_ejecting_flits);
+
+    // statistics of the current simulation; the overall accumulators 
+    // hold the results of completed simulations and are not part of it
+    cp.Check(_stats.size(), "number of statistics");
+    for(map<string, Stats *>::iterator iter = _stats.begin(); 
+        iter != _stats.end(); ++iter) {
+        iter->second->SyncState(cp);
+    }
+    cp.Sync(_sent_packets);
+    cp.Sync(_accepted_packets);
+    cp.Sync(_sent_flits);
+    cp.Sync(_accepted_flits);
+#ifdef TRACK_STALLS
+    cp.Sync(_buffer_busy_stalls);
+    cp.Sync(_buffer_conflict_stalls);
+    cp.Sync(_buffer_full_stalls);
+    cp.Sync(_buffer_reserved_stalls);
+    cp.Sync(_crossbar_conflict_stalls);
+#endif
+    cp.Sync(_slowest_packet);
+    cp.Sync(_slowest_flit);
+    cp.Sync(_plat_batches);
+    cp.Sync(_accepted_batches);
+    cp.Sync(_batch_plat_sum);
+    cp.Sync(_batch_plat_count);
+    cp.Sync(_batch_accepted_count);
+    cp.Sync(_batch_start_time);
+
+    // random number generators
+    cp.SyncRandomState();
+    cp.Check(_source_streams.size(), "number of source random streams");
+    for(size_t n = 0; n < _source_streams.size(); ++n) {
+        cp.Sync(_source_streams[n]);
+    }
+}
+
+void TrafficManager::_Checkpoint( string const & filename, 
+                                  Checkpoint::eMode mode, 
+                                  int & total_phases, int & converged, 
+                                  vector<double> & prev_latency, 
+                                  vector<double> & prev_accepted, 
+                                  bool & clear_last )
+{
+    Checkpoint cp(filename, mode);
+
+    // Only the first simulation restores the random number generators (if 
+    // requested); later ones carry on with the generators as left by the 
+    // previous simulation and thus measure independent samples.
+    cp.KeepRandomState(_checkpoint_restored || !_checkpoint_random_state);
+
+    _SyncState(cp);
+
+    // progress of the sampling loop
+    cp.Sync(total_phases);
+    cp.Sync(converged);
+    cp.Sync(prev_latency);
+    cp.Sync(prev_accepted);
+    cp.Sync(clear_last);
+
+    if(cp.Restoring()) {
+        _checkpoint_restored = true;
+        *gContext->out << "Restored checkpoint " << filename 
+                       << " at time " << _time << endl;
+    } else {
+        *gContext->out << "Saved checkpoint " << filename 
+                       << " at time " << _time << endl;
+    }
+}
+
+// Pipe helpers for forked simulations; short writes and reads are resumed.
+static void WritePipe( int fd, void const * data, size_t size )
+{
+    char const * p = (char const *)data;
+    while(size > 0) {
+        ssize_t n = write(fd, p, size);
+        if(n < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            _exit(-1);
+        }
+        p += n;
+        size -= n;
+    }
+}
+
+static bool ReadPipe( int fd, void * data, size_t size )
+{
+    char * p = (char *)data;
+    while(size > 0) {
+        ssize_t n = read(fd, p, size);
+        if(n < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        if(n == 0) {
+            return false;
+        }
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+// Reads the output and statistics of a forked simulation, adds its 
+// contribution to the overall statistics and reaps the process.
+static bool JoinForkedSim( pid_t pid, int fd, 
+                           vector<ostream *> const & streams, 
+                           vector<vector<double> > const & base, 
+                           vector<vector<double> > & sum, 
+                           vector<Stats *> const & hists, bool & stable )
+{
+    int status = 0;
+    bool ok = ReadPipe(fd, &status, sizeof(status));
+    stable = (status != 0);
+    for(size_t i = 0; ok && (i < streams.size()); ++i) {
+        int length;
+        ok = ReadPipe(fd, &length, sizeof(length));
+        if(ok && (length > 0)) {
+            string text(length, '\0');
+            ok = ReadPipe(fd, &text[0], length);
+            *streams[i] << text;
+            streams[i]->flush();
+        }
+    }
+    for(size_t i = 0; ok && (i < base.size()); ++i) {
+        vector<double> values(base[i].size());
+        ok = values.empty() || 
+            ReadPipe(fd, &values[0], values.size() * sizeof(double));
+        for(size_t c = 0; ok && (c < values.size()); ++c) {
+            sum[i][c] += values[c] - base[i][c];
+        }
+    }
+    for(size_t i = 0; ok && (i < hists.size()); ++i) {
+        int length;
+        ok = ReadPipe(fd, &length, sizeof(length));
+        if(ok && (length > 0)) {
+            vector<double> values(length);
+            ok = ReadPipe(fd, &values[0], length * sizeof(double));
+            if(ok) {
+                hists[i]->MergePacked(values);
+            }
+        }
+    }
+    close(fd);
+    waitpid(pid, NULL, 0);
+    return ok;
+}
+
+void TrafficManager::_LatencyHists( vector<Stats *> & hists, bool overall ) const
+{
+    hists.clear();
+    for(int c = 0; c < _classes; ++c) {
+        if(_measure_stats[c] == 0) {
+            continue;
+        }
+        hists.push_back(overall ? _overall_plat_hist[c] : _plat_stats[c]);
+        hists.push_back(overall ? _overall_nlat_hist[c] : _nlat_stats[c]);
+        hists.push_back(overall ? _overall_flat_hist[c] : _flat_stats[c]);
+    }
+}
+
+void TrafficManager::_OverallStats( vector<vector<double> *> & stats )
+{
+    stats.clear();
+    stats.push_back(&_overall_min_plat);
+    stats.push_back(&_overall_avg_plat);
+    stats.push_back(&_overall_max_plat);
+    stats.push_back(&_overall_min_nlat);
+    stats.push_back(&_overall_avg_nlat);
+    stats.push_back(&_overall_max_nlat);
+    stats.push_back(&_overall_min_flat);
+    stats.push_back(&_overall_avg_flat);
+    stats.push_back(&_overall_max_flat);
+    stats.push_back(&_overall_min_frag);
+    stats.push_back(&_overall_avg_frag);
+    stats.push_back(&_overall_max_frag);
+    stats.push_back(&_overall_hop_stats);
+    stats.push_back(&_overall_min_sent_packets);
+    stats.push_back(&_overall_avg_sent_packets);
+    stats.push_back(&_overall_max_sent_packets);
+    stats.push_back(&_overall_min_accepted_packets);
+    stats.push_back(&_overall_avg_accepted_packets);
+    stats.push_back(&_overall_max_accepted_packets);
+    stats.push_back(&_overall_min_sent);
+    stats.push_back(&_overall_avg_sent);
+    stats.push_back(&_overall_max_sent);
+    stats.push_back(&_overall_min_accepted);
+    stats.push_back(&_overall_avg_accepted);
+    stats.push_back(&_overall_max_accepted);
+#ifdef TRACK_STALLS
+    stats.push_back(&_overall_buffer_busy_stalls);
+    stats.push_back(&_overall_buffer_conflict_stalls);
+    stats.push_back(&_overall_buffer_full_stalls);
+    stats.push_back(&_overall_buffer_reserved_stalls);
+    stats.push_back(&_overall_crossbar_conflict_stalls);
+#endif
+}
+
+// Called in the first simulation once it has warmed up. Each simulation 
+// is then measured in its own copy of the process, which shares the warm 
+// network with the parent until it modifies it. The first copy carries 
+// on with the random number generators as they are, exactly like a 
+// single simulation; the others are reseeded so that all measure 
+// independent samples. Returns in the copies, and in the parent once all 
+// of them have reported back.
+void TrafficManager::_ForkSims( )
+{
+    _fork_streams.clear();
+    _fork_streams.push_back(gContext->out);
+    if(_stats_out && (find(_fork_streams.begin(), _fork_streams.end(), 
+                           _stats_out) == _fork_streams.end())) {
+        _fork_streams.push_back(_stats_out);
+    }
+    if(gContext->watch_out && 
+       (find(_fork_streams.begin(), _fork_streams.end(), 
+             gContext->watch_out) == _fork_streams.end())) {
+        _fork_streams.push_back(gContext->watch_out);
+    }
+
+    vector<vector<double> *> overall;
+    _OverallStats(overall);
+    vector<vector<double> > base(overall.size());
+    for(size_t i = 0; i < overall.size(); ++i) {
+        base[i] = *overall[i];
+    }
+    vector<vector<double> > sum = base;
+    vector<Stats *> hists;
+    _LatencyHists(hists, true);
+
+    *gContext->out << "Measuring " << _total_sims 
+                   << " simulations in forked processes ..." << endl;
+
+    // anything still buffered would otherwise be written by every copy
+    for(size_t i = 0; i < _fork_streams.size(); ++i) {
+        _fork_streams[i]->flush();
+    }
+    cout.flush();
+    cerr.flush();
+
+    _forked_stable = true;
+    deque<pair<pid_t, int> > running;
+
+    for(int sim = 0; sim < _total_sims; ++sim) {
+
+        if((int)running.size() >= _fork_sims) {
+            bool stable;
+            if(!JoinForkedSim(running.front().first, running.front().second, 
+                              _fork_streams, base, sum, hists, stable)) {
+                Error("Forked simulation terminated abnormally.");
+            }
+            _forked_stable &= stable;
+            running.pop_front();
+        }
+
+        int fds[2];
+        if(pipe(fds) != 0) {
+            Error("Could not create a pipe for a forked simulation.");
+        }
+        pid_t pid = fork();
+        if(pid < 0) {
+            Error("Could not fork a simulation.");
+        }
+
+        if(pid == 0) {
+            close(fds[0]);
+            for(size_t i = 0; i < running.size(); ++i) {
+                close(running[i].second);
+            }
+            _sim_child = sim;
+            _sim_pipe = fds[1];
+
+            // hold back all output for the parent
+            _fork_buffers.resize(_fork_streams.size());
+            for(size_t i = 0; i < _fork_streams.size(); ++i) {
+                _fork_buffers[i] = new ostringstream;
+                if(gContext->out == _fork_streams[i]) {
+                    gContext->out = _fork_buffers[i];
+                }
+                if(_stats_out == _fork_streams[i]) {
+                    _stats_out = _fork_buffers[i];
+                }
+                if(gContext->watch_out == _fork_streams[i]) {
+                    gContext->watch_out = _fork_buffers[i];
+                }
+            }
+
+            if(sim > 0) {
+                RandomSeed(_seed + sim);
+                if(!_source_streams.empty()) {
+                    int const stream = sim * (_subnets + 1);
+                    for(int n = 0; n < _nodes; ++n) {
+                        _source_streams[n].Reset(_seed, n, stream);
+                    }
+                    for(int i = 0; i < _subnets; ++i) {
+                        _net[i]->SetRandomStreams(_seed, stream + i + 1);
+                    }
+                }
+            }
+            return;
+        }
+
+        close(fds[1]);
+        running.push_back(make_pair(pid, fds[0]));
+    }
+
+    while(!running.empty()) {
+        bool stable;
+        if(!JoinForkedSim(running.front().first, running.front().second, 
+                          _fork_streams, base, sum, hists, stable)) {
+            Error("Forked simulation terminated abnormally.");
+        }
+        _forked_stable &= stable;
+        running.pop_front();
+    }
+
+    for(size_t i = 0; i < overall.size(); ++i) {
+        *overall[i] = sum[i];
+    }
+    _sims_forked = true;
+}
+
+// Sends the output and overall statistics of a forked simulation to the 
+// parent and ends the process.
+void TrafficManager::_ReturnSimResults( bool stable )
+{
+    int status = stable ? 1 : 0;
+    WritePipe(_sim_pipe, &status, sizeof(status));
+    for(size_t i = 0; i < _fork_buffers.size(); ++i) {
+        string const text = _fork_buffers[i]->str();
+        int length = text.size();
+        WritePipe(_sim_pipe, &length, sizeof(length));
+        WritePipe(_sim_pipe, text.data(), length);
+    }
+    vector<vector<double> *> overall;
+    _OverallStats(overall);
+    for(size_t i = 0; i < overall.size(); ++i) {
+        if(!overall[i]->empty()) {
+            WritePipe(_sim_pipe, &(*overall[i])[0], 
+                      overall[i]->size() * sizeof(double));
+        }
+    }
+    // the samples of this simulation, if it counts towards the results
+    vector<Stats *> hists;
+    _LatencyHists(hists, false);
+    for(size_t i = 0; i < hists.size(); ++i) {
+        vector<double> values;
+        if(stable) {
+            hists[i]->Pack(values);
+        }
+        int length = values.size();
+        WritePipe(_sim_pipe, &length, sizeof(length));
+        if(length > 0) {
+            WritePipe(_sim_pipe, &values[0], length * sizeof(double));
+        }
+    }
+    close(_sim_pipe);
+    _exit(0);
+}
+
 bool TrafficManager::Run( )
 {
     for ( int sim = 0; sim < _total_sims; ++sim ) {
@@ -1628,6 +2441,7 @@ bool TrafficManager::Run( )
             _qtime[s].assign(_classes, 0);
             _qdrained[s].assign(_classes, false);
         }
+        _calendar_valid = false;
 
         // warm-up ...
         // reset stats, all packets after warmup_time marked
@@ -1642,19 +2456,32 @@ bool TrafficManager::Run( )
             _injection_process[c]->reset();
         }
 
-        if ( !_SingleSim( ) ) {
-            cout << "Simulation unstable, ending ..." << endl;
+        bool const stable = _SingleSim( );
+
+        if ( _sims_forked ) {
+            // the forked copies have reported their output and statistics
+            if ( !stable ) {
+                return false;
+            }
+            break;
+        }
+
+        if ( !stable ) {
+            *gContext->out << "Simulation unstable, ending ..." << endl;
+            if ( _sim_child >= 0 ) {
+                _ReturnSimResults( false );
+            }
             return false;
         }
 
         // Empty any remaining packets
-        cout << "Draining remaining packets ..." << endl;
+        *gContext->out << "Draining remaining packets ..." << endl;
         _empty_network = true;
         int empty_steps = 0;
 
         bool packets_left = false;
         for(int c = 0; c < _classes; ++c) {
-            packets_left |= !_total_in_flight_flits[c].empty();
+            packets_left |= !_total_in_flight_flits[c].Empty();
         }
 
         while( packets_left ) { 
@@ -1663,12 +2490,12 @@ bool TrafficManager::Run( )
             ++empty_steps;
 
             if ( empty_steps % 1000 == 0 ) {
-                _DisplayRemaining( ); 
+                _DisplayRemaining( *gContext->out ); 
             }
       
             packets_left = false;
             for(int c = 0; c < _classes; ++c) {
-                packets_left |= !_total_in_flight_flits[c].empty();
+                packets_left |= !_total_in_flight_flits[c].Empty();
             }
         }
         //wait until all the credits are drained as well
@@ -1679,17 +2506,21 @@ bool TrafficManager::Run( )
 
         //for the love of god don't ever say "Time taken" anywhere else
         //the power script depend on it
-        cout << "Time taken is " << _time << " cycles" <<endl; 
+        *gContext->out << "Time taken is " << _time << " cycles" <<endl; 
 
         if(_stats_out) {
             WriteStats(*_stats_out);
         }
         _UpdateOverallStats();
+
+        if ( _sim_child >= 0 ) {
+            _ReturnSimResults( true );
+        }
     }
   
-    DisplayOverallStats();
+    DisplayOverallStats(*gContext->out);
     if(_print_csv_results) {
-        DisplayOverallStatsCSV();
+        DisplayOverallStatsCSV(*gContext->out);
     }
   
     return true;
@@ -1718,6 +2549,10 @@ void TrafficManager::_UpdateOverallStats() {
 
         _overall_hop_stats[c] += _hop_stats[c]->Average();
 
+        _overall_plat_hist[c]->Merge(*_plat_stats[c]);
+        _overall_nlat_hist[c]->Merge(*_nlat_stats[c]);
+        _overall_flat_hist[c]->Merge(*_flat_stats[c]);
+
         int count_min, count_sum, count_max;
         double rate_min, rate_sum, rate_max;
         double rate_avg;
@@ -1798,6 +2633,21 @@ void TrafficManager::WriteStats(ostream & os) const {
            << "nlat_hist(" << c+1 << ",:) = " << *_nlat_stats[c] << ";" << endl
            << "flat(" << c+1 << ") = " << _flat_stats[c]->Average() << ";" << endl
            << "flat_hist(" << c+1 << ",:) = " << *_flat_stats[c] << ";" << endl
+           << "plat_pct(" << c+1 << ",:) = [ ";
+        for(size_t i = 0; i < _latency_percentiles.size(); ++i) {
+            os << _plat_stats[c]->Percentile(_latency_percentiles[i]) << " ";
+        }
+        os << "];" << endl
+           << "nlat_pct(" << c+1 << ",:) = [ ";
+        for(size_t i = 0; i < _latency_percentiles.size(); ++i) {
+            os << _nlat_stats[c]->Percentile(_latency_percentiles[i]) << " ";
+        }
+        os << "];" << endl
+           << "flat_pct(" << c+1 << ",:) = [ ";
+        for(size_t i = 0; i < _latency_percentiles.size(); ++i) {
+            os << _flat_stats[c]->Percentile(_latency_percentiles[i]) << " ";
+        }
+        os << "];" << endl
            << "frag_hist(" << c+1 << ",:) = " << *_frag_stats[c] << ";" << endl
            << "hops(" << c+1 << ",:) = " << *_hop_stats[c] << ";" << endl;
         if(_pair_stats){
@@ -1978,19 +2828,25 @@ void TrafficManager::DisplayStats(ostream & os) const {
             continue;
         }
     
-        cout << "Class " << c << ":" << endl;
+        os << "Class " << c << ":" << endl;
     
-        cout 
+        os 
             << "Packet latency average = " << _plat_stats[c]->Average() << endl
             << "\tminimum = " << _plat_stats[c]->Min() << endl
-            << "\tmaximum = " << _plat_stats[c]->Max() << endl
+            << "\tmaximum = " << _plat_stats[c]->Max() << endl;
+        _DisplayPercentiles(os, _plat_stats[c]);
+        os 
             << "Network latency average = " << _nlat_stats[c]->Average() << endl
             << "\tminimum = " << _nlat_stats[c]->Min() << endl
-            << "\tmaximum = " << _nlat_stats[c]->Max() << endl
+            << "\tmaximum = " << _nlat_stats[c]->Max() << endl;
+        _DisplayPercentiles(os, _nlat_stats[c]);
+        os 
             << "Slowest packet = " << _slowest_packet[c] << endl
             << "Flit latency average = " << _flat_stats[c]->Average() << endl
             << "\tminimum = " << _flat_stats[c]->Min() << endl
-            << "\tmaximum = " << _flat_stats[c]->Max() << endl
+            << "\tmaximum = " << _flat_stats[c]->Max() << endl;
+        _DisplayPercentiles(os, _flat_stats[c]);
+        os 
             << "Slowest flit = " << _slowest_flit[c] << endl
             << "Fragmentation average = " << _frag_stats[c]->Average() << endl
             << "\tminimum = " << _frag_stats[c]->Min() << endl
@@ -2008,7 +2864,7 @@ void TrafficManager::DisplayStats(ostream & os) const {
         rate_max = (double)count_max / time_delta;
         rate_avg = rate_sum / (double)_nodes;
         sent_packets = count_sum;
-        cout << "Injected packet rate average = " << rate_avg << endl
+        os << "Injected packet rate average = " << rate_avg << endl
              << "\tminimum = " << rate_min 
              << " (at node " << min_pos << ")" << endl
              << "\tmaximum = " << rate_max
@@ -2019,7 +2875,7 @@ void TrafficManager::DisplayStats(ostream & os) const {
         rate_max = (double)count_max / time_delta;
         rate_avg = rate_sum / (double)_nodes;
         accepted_packets = count_sum;
-        cout << "Accepted packet rate average = " << rate_avg << endl
+        os << "Accepted packet rate average = " << rate_avg << endl
              << "\tminimum = " << rate_min 
              << " (at node " << min_pos << ")" << endl
              << "\tmaximum = " << rate_max
@@ -2030,7 +2886,7 @@ void TrafficManager::DisplayStats(ostream & os) const {
         rate_max = (double)count_max / time_delta;
         rate_avg = rate_sum / (double)_nodes;
         sent_flits = count_sum;
-        cout << "Injected flit rate average = " << rate_avg << endl
+        os << "Injected flit rate average = " << rate_avg << endl
              << "\tminimum = " << rate_min 
              << " (at node " << min_pos << ")" << endl
              << "\tmaximum = " << rate_max
@@ -2041,17 +2897,17 @@ void TrafficManager::DisplayStats(ostream & os) const {
         rate_max = (double)count_max / time_delta;
         rate_avg = rate_sum / (double)_nodes;
         accepted_flits = count_sum;
-        cout << "Accepted flit rate average= " << rate_avg << endl
+        os << "Accepted flit rate average= " << rate_avg << endl
              << "\tminimum = " << rate_min 
              << " (at node " << min_pos << ")" << endl
              << "\tmaximum = " << rate_max
              << " (at node " << max_pos << ")" << endl;
     
-        cout << "Injected packet length average = " << (double)sent_flits / (double)sent_packets << endl
+        os << "Injected packet length average = " << (double)sent_flits / (double)sent_packets << endl
              << "Accepted packet length average = " << (double)accepted_flits / (double)accepted_packets << endl;
 
-        cout << "Total in-flight flits = " << _total_in_flight_flits[c].size()
-             << " (" << _measured_in_flight_flits[c].size() << " measured)"
+        os << "Total in-flight flits = " << _total_in_flight_flits[c].Size()
+             << " (" << _measured_in_flight_flits[c].Size() << " measured)"
              << endl;
     
 #ifdef TRACK_STALLS
@@ -2080,6 +2936,23 @@ void TrafficManager::DisplayStats(ostream & os) const {
     }
 }
 
+void TrafficManager::_DisplayPercentiles( ostream & os, Stats const * s ) const
+{
+    for(size_t i = 0; i < _latency_percentiles.size(); ++i) {
+        os << "\t" << _latency_percentiles[i] << "th percentile = " 
+           << s->Percentile(_latency_percentiles[i]) << endl;
+    }
+}
+
+void TrafficManager::_DisplayOverallPercentiles( ostream & os, Stats const * s ) const
+{
+    for(size_t i = 0; i < _latency_percentiles.size(); ++i) {
+        os << "\t" << _latency_percentiles[i] << "th percentile = " 
+           << s->Percentile(_latency_percentiles[i])
+           << " (" << _total_sims << " samples)" << endl;
+    }
+}
+
 void TrafficManager::DisplayOverallStats( ostream & os ) const {
 
     os << "====== Overall Traffic Statistics ======" << endl;
@@ -2097,6 +2970,7 @@ void TrafficManager::DisplayOverallStats( ostream & os ) const {
            << " (" << _total_sims << " samples)" << endl;
         os << "\tmaximum = " << _overall_max_plat[c] / (double)_total_sims
            << " (" << _total_sims << " samples)" << endl;
+        _DisplayOverallPercentiles(os, _overall_plat_hist[c]);
 
         os << "Network latency average = " << _overall_avg_nlat[c] / (double)_total_sims
            << " (" << _total_sims << " samples)" << endl;
@@ -2104,6 +2978,7 @@ void TrafficManager::DisplayOverallStats( ostream & os ) const {
            << " (" << _total_sims << " samples)" << endl;
         os << "\tmaximum = " << _overall_max_nlat[c] / (double)_total_sims
            << " (" << _total_sims << " samples)" << endl;
+        _DisplayOverallPercentiles(os, _overall_nlat_hist[c]);
 
         os << "Flit latency average = " << _overall_avg_flat[c] / (double)_total_sims
            << " (" << _total_sims << " samples)" << endl;
@@ -2111,6 +2986,7 @@ void TrafficManager::DisplayOverallStats( ostream & os ) const {
            << " (" << _total_sims << " samples)" << endl;
         os << "\tmaximum = " << _overall_max_flat[c] / (double)_total_sims
            << " (" << _total_sims << " samples)" << endl;
+        _DisplayOverallPercentiles(os, _overall_flat_hist[c]);
 
         os << "Fragmentation average = " << _overall_avg_frag[c] / (double)_total_sims
            << " (" << _total_sims << " samples)" << endl;
@@ -2207,6 +3083,16 @@ string TrafficManager::_OverallStatsCSV(int c) const
        << ',' << _overall_avg_accepted[c] / _overall_avg_accepted_packets[c]
        << ',' << _overall_hop_stats[c] / (double)_total_sims;
 
+    for(size_t i = 0; i < _latency_percentiles.size(); ++i) {
+        os << ',' << _overall_plat_hist[c]->Percentile(_latency_percentiles[i]);
+    }
+    for(size_t i = 0; i < _latency_percentiles.size(); ++i) {
+        os << ',' << _overall_nlat_hist[c]->Percentile(_latency_percentiles[i]);
+    }
+    for(size_t i = 0; i < _latency_percentiles.size(); ++i) {
+        os << ',' << _overall_flat_hist[c]->Percentile(_latency_percentiles[i]);
+    }
+
 #ifdef TRACK_STALLS
     os << ',' << (double)_overall_buffer_busy_stalls[c] / (double)_total_sims
        << ',' << (double)_overall_buffer_conflict_stalls[c] / (double)_total_sims
@@ -31,6 +31,9 @@
 #include <list>
 #include <map>
 #include <set>
+#include <queue>
+#include <functional>
+#include <sstream>
 #include <cassert>
 
 #include "module.hpp"
@@ -43,6 +46,8 @@
 #include "routefunc.hpp"
 #include "outputset.hpp"
 #include "injection.hpp"
+#include "inflight_set.hpp"
+#include "checkpoint.hpp"
 
 //register the requests to a node
 class PacketReplyInfo;
@@ -111,15 +116,58 @@ protected:
 
   vector<vector<int> > _qtime;
   vector<vector<bool> > _qdrained;
-  vector<vector<list<Flit *> > > _partial_packets;
 
-  vector<map<int, Flit *> > _total_in_flight_flits;
-  vector<map<int, Flit *> > _measured_in_flight_flits;
-  vector<map<int, Flit *> > _retired_packets;
+  // Source queues hold packets rather than flits; only the flit at the 
+  // front of a queue is materialized, when injection first looks at it.
+  struct sQueuedPacket {
+    Flit::FlitType type;
+    int pid;
+    int head_id;
+    int tail_id;
+    int id;       // next flit to be injected
+    int dest;
+    int ctime;
+    int pri;
+    int vc;
+    int subnetwork;
+    bool record;
+    bool watch;
+    Flit * front; // materialized flit for id, if any
+    void SyncState(Checkpoint & cp);
+  };
+  vector<vector<list<sQueuedPacket> > > _partial_packets;
+
+  // With skip-ahead injection processes, sources with empty queues are 
+  // only visited in the cycle in which their next packet is due.
+  bool _injection_calendar;
+  bool _calendar_valid;
+  typedef pair<int, pair<int, int> > tCalendarEntry; // (due, (node, class))
+  priority_queue<tCalendarEntry, vector<tCalendarEntry>, 
+		 greater<tCalendarEntry> > _calendar;
+  vector<pair<int, int> > _calendar_ready;
+
+  // flits count as in flight from generation until retirement
+  vector<InFlightSet> _total_in_flight_flits;
+  vector<InFlightSet> _measured_in_flight_flits;
+
+  // head flits of packets whose tail has not yet arrived, indexed by 
+  // ejection node, subnetwork and VC
+  vector<Flit *> _retired_packets;
+
+  // flits read from the ejection channels in the current cycle
+  vector<vector<Flit *> > _ejecting_flits;
   bool _empty_network;
 
   bool _hold_switch_for_packet;
 
+  bool _skip_idle_cycles;
+
+  // per-source random streams (random_streams > 0)
+  vector<RandomStream> _source_streams;
+  inline RandomStream * _SourceStream( int source ) {
+    return _source_streams.empty() ? NULL : &_source_streams[source];
+  }
+
   // ============ physical sub-networks ==========
 
   int _subnets;
@@ -154,6 +202,13 @@ protected:
   vector<double> _overall_avg_flat;  
   vector<double> _overall_max_flat;  
 
+  // percentiles of packet, network and flit latency to report; overall 
+  // percentiles are taken from the samples of all simulations combined
+  vector<double> _latency_percentiles;
+  vector<Stats *> _overall_plat_hist;
+  vector<Stats *> _overall_nlat_hist;
+  vector<Stats *> _overall_flat_hist;
+
   vector<Stats *> _frag_stats;
   vector<double> _overall_min_frag;
   vector<double> _overall_avg_frag;
@@ -229,6 +284,19 @@ protected:
   vector<double> _warmup_threshold;
   vector<double> _acc_warmup_threshold;
 
+  // batch means of packet latency and accepted flit rate over the sample 
+  // periods since the statistics were last cleared, for stopping once 
+  // their confidence intervals are narrow enough
+  vector<double> _stopping_ci;
+  double _stopping_confidence;
+  int _stopping_min_batches;
+  vector<vector<double> > _plat_batches;
+  vector<vector<double> > _accepted_batches;
+  vector<double> _batch_plat_sum;
+  vector<int> _batch_plat_count;
+  vector<int> _batch_accepted_count;
+  vector<int> _batch_start_time;
+
   int _cur_id;
   int _cur_pid;
   int _time;
@@ -238,6 +306,27 @@ protected:
 
   bool _print_csv_results;
 
+  // checkpoint to save once the first simulation has warmed up, and 
+  // checkpoint to start each simulation from instead of warming up
+  string _checkpoint_out;
+  string _checkpoint_in;
+  bool _checkpoint_random_state;
+  bool _checkpoint_restored;
+
+  // once the first simulation has warmed up, measure all simulations in 
+  // forked copies of the process, up to _fork_sims at a time
+  int _fork_sims;
+  int _seed;
+  bool _sims_forked;
+  bool _forked_stable;
+
+  // in a forked copy: index of the simulation it measures (-1 otherwise), 
+  // pipe to the parent, and the output it holds back for the parent
+  int _sim_child;
+  int _sim_pipe;
+  vector<ostream *> _fork_streams;
+  vector<ostringstream *> _fork_buffers;
+
   //flits to watch
   ostream * _stats_out;
 
@@ -265,19 +354,48 @@ protected:
   virtual void _RetireFlit( Flit *f, int dest );
 
   void _Inject();
-  void _Step( );
+  void _InjectFromCalendar();
+  // Advance by one cycle; when nothing is in flight and skipping is 
+  // enabled, idle cycles are fast-forwarded, up to max_cycles in total, 
+  // jumping to the next calendar entry when the calendar drives injection.
+  // Returns the number of cycles advanced.
+  int _Step( int max_cycles = 1 );
+  void _FinishStep( );
+  void _AdvanceTime( );
+  bool _Quiescent( ) const;
 
   bool _PacketsOutstanding( ) const;
   
   virtual int  _IssuePacket( int source, int cl );
   void _GeneratePacket( int source, int size, int cl, int time );
+  Flit * _FrontFlit( int source, int cl );
+  void _PopFrontFlit( int source, int cl );
 
   virtual void _ClearStats( );
+  void _RecordBatch( int c );
+  bool _ConfidenceInterval( vector<double> const & batches, 
+                            double & mean, double & half_width ) const;
 
   void _ComputeStats( const vector<int> & stats, int *sum, int *min = NULL, int *max = NULL, int *min_pos = NULL, int *max_pos = NULL ) const;
 
   virtual bool _SingleSim( );
 
+  void _SyncState( Checkpoint & cp );
+  void _Checkpoint( string const & filename, Checkpoint::eMode mode, 
+                    int & total_phases, int & converged, 
+                    vector<double> & prev_latency, 
+                    vector<double> & prev_accepted, bool & clear_last );
+
+  void _OverallStats( vector<vector<double> *> & stats );
+  void _ForkSims( );
+  void _ReturnSimResults( bool stable );
+
+  void _DisplayPercentiles( ostream & os, Stats const * s ) const;
+  void _DisplayOverallPercentiles( ostream & os, Stats const * s ) const;
+  // latency histograms of the current simulation, or the overall ones, in 
+  // the order in which forked simulations report them
+  void _LatencyHists( vector<Stats *> & hists, bool overall ) const;
+
   void _DisplayRemaining( ostream & os = cout ) const;
   
   void _LoadWatchList(const string & filename);
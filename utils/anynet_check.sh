@@ -0,0 +1,98 @@
+#!/bin/sh
+
+# $Id$
+
+# Copyright (c) 2007-2015, Trustees of The Leland Stanford Junior University
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# Redistributions of source code must retain the above copyright notice, this
+# list of conditions and the following disclaimer.
+# Redistributions in binary form must reproduce the above copyright notice,
+# this list of conditions and the following disclaimer in the documentation
+# and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+
+# This is a helper script that checks the link latencies of an anynet 
+# network file.
+#
+# It takes a booksim executable as its parameter.
+#
+# Example:
+#
+#  ./anynet_check.sh ./booksim
+#
+# The simulator is run on a network file whose first line is 
+# "router 0 router 1 15 router 2". The channel from router 0 to router 1 
+# must have a latency of 15 cycles, while the channel back and both channels 
+# between routers 0 and 2 must have the default latency of one cycle. Status 
+# information is printed in lines that begin with "ANYNET: ".
+
+if [ "${1}" = "" ]
+then
+    echo "ANYNET: Please specify a simulator executable as the first parameter."
+    exit 1
+fi
+
+sim=${1}
+
+prefix=anynet.${HOSTNAME}.${$}
+
+cat > ${prefix}.net <<END
+router 0 router 1 15 router 2
+node 0 router 0
+node 1 router 1
+node 2 router 2
+END
+cat > ${prefix}.cfg <<END
+topology = anynet;
+network_file = ${prefix}.net;
+routing_function = min;
+traffic = uniform;
+injection_rate = 0.01;
+END
+
+echo "ANYNET: Running simulation..."
+${sim} ${prefix}.cfg > ${prefix}.log
+
+# latency of the channel from router ${1} to router ${2} in the router to 
+# router listing
+latency()
+{
+    awk -v src=${1} -v dest=${2} '/router to router listing/{ p = 1; next } /^=/{ p = 0 } p && $1 == "Router" && NF == 2 { r = $2 } p && $1 == "Router" && NF == 4 && r == src && $2 == dest { print $4 }' ${prefix}.log
+}
+
+failed=0
+for channel in "0 1 15" "1 0 1" "0 2 1" "2 0 1"
+do
+    set -- ${channel}
+    lat=`latency ${1} ${2}`
+    if [ "${lat}" != "${3}" ]
+    then
+	echo "ANYNET: Channel from router ${1} to router ${2} has latency '${lat}' instead of ${3}."
+	failed=1
+    fi
+done
+
+rm -f ${prefix}.net ${prefix}.cfg ${prefix}.log
+
+if [ ${failed} -ne 0 ]
+then
+    echo "ANYNET: Check failed."
+    exit 1
+fi
+echo "ANYNET: Check passed."
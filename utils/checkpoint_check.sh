@@ -0,0 +1,112 @@
+#!/bin/sh
+
+# $Id$
+
+# Copyright (c) 2007-2015, Trustees of The Leland Stanford Junior University
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# Redistributions of source code must retain the above copyright notice, this
+# list of conditions and the following disclaimer.
+# Redistributions in binary form must reproduce the above copyright notice,
+# this list of conditions and the following disclaimer in the documentation
+# and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+
+# This is a helper script that checks checkpoint save and restore across 
+# several simulations.
+#
+# It takes a complete booksim commandline as its parameter.
+#
+# Example:
+#
+#  ./checkpoint_check.sh ./booksim configfile
+#
+# The simulator is run twice with sim_count simulations (2 by default): once 
+# saving a checkpoint after the first simulation has warmed up, and once 
+# restoring every simulation from that checkpoint. The first simulation must 
+# produce the same output in both runs, the second run must restore once per 
+# simulation, and the overall average packet latency of the two runs must 
+# agree to within the relative tolerance given by 'tolerance' (0.1 by 
+# default). Status information is printed in lines that begin with 
+# "CHECKPOINT: ".
+
+if [ "${1}" = "" ]
+then
+    echo "CHECKPOINT: Please specify a simulator executable as the first parameter."
+    exit 1
+fi
+
+sim=${1}
+shift
+
+if [ "${sim_count}" = "" ]
+then
+    sim_count=2
+fi
+if [ "${tolerance}" = "" ]
+then
+    tolerance=0.1
+fi
+
+prefix=checkpoint.${HOSTNAME}.${$}
+cp_file=${prefix}.bin
+
+echo "CHECKPOINT: Saving checkpoint..."
+${sim} $* print_csv_results=1 sim_count=${sim_count} checkpoint_out=${cp_file} > ${prefix}.save.log
+echo "CHECKPOINT: Restoring checkpoint..."
+${sim} $* print_csv_results=1 sim_count=${sim_count} checkpoint_in=${cp_file} > ${prefix}.restore.log
+
+# output of the first simulation from the checkpoint on
+awk '/^Saved checkpoint /{ p = 1; next } p { print } /^Time taken /{ if ( p ) exit }' ${prefix}.save.log > ${prefix}.save.first
+awk '/^Restored checkpoint /{ p = 1; next } p { print } /^Time taken /{ if ( p ) exit }' ${prefix}.restore.log > ${prefix}.restore.first
+
+restores=`grep -c "^Restored checkpoint " ${prefix}.restore.log`
+save_lat=`grep "results:" ${prefix}.save.log | head -n 1 | cut -d , -f 6`
+restore_lat=`grep "results:" ${prefix}.restore.log | head -n 1 | cut -d , -f 6`
+
+failed=0
+if [ ! -s ${prefix}.save.first ] || ! cmp -s ${prefix}.save.first ${prefix}.restore.first
+then
+    echo "CHECKPOINT: First simulation differs after restoring."
+    failed=1
+fi
+if [ "${restores}" != "${sim_count}" ]
+then
+    echo "CHECKPOINT: Restored ${restores} time(s) for ${sim_count} simulation(s)."
+    failed=1
+fi
+if [ "${save_lat}" = "" ] || [ "${restore_lat}" = "" ]
+then
+    echo "CHECKPOINT: Simulation run failed."
+    failed=1
+elif [ "`awk "BEGIN{ d = ${save_lat} - ${restore_lat}; if ( d < 0 ) d = -d; print ( d > ${tolerance} * ${save_lat} ) }"`" = "1" ]
+then
+    echo "CHECKPOINT: Overall latency ${restore_lat} after restoring does not match ${save_lat}."
+    failed=1
+else
+    echo "CHECKPOINT: Overall latency is ${save_lat} when saving and ${restore_lat} when restoring."
+fi
+
+rm -f ${cp_file} ${prefix}.save.log ${prefix}.restore.log ${prefix}.save.first ${prefix}.restore.first
+
+if [ ${failed} -ne 0 ]
+then
+    echo "CHECKPOINT: Check failed."
+    exit 1
+fi
+echo "CHECKPOINT: Check passed."